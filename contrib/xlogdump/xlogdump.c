@@ -604,6 +604,10 @@ addTransaction(XLogRecord *record)
 	{
 		if (info == XLOG_XACT_COMMIT)
 			status = 1;
+#ifdef XLOG_XACT_ONE_PHASE_COMMIT
+		else if (info == XLOG_XACT_ONE_PHASE_COMMIT)
+			status = 1;
+#endif
 		else if (info == XLOG_XACT_ABORT)
 			status = 2;
 	}
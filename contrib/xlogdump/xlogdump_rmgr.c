@@ -305,6 +305,20 @@ print_rmgr_xact(XLogRecPtr cur, XLogRecord *record, uint8 info, bool hideTimesta
 		rmgr_stats.xact_commit++;
 		break;
 
+#ifdef XLOG_XACT_ONE_PHASE_COMMIT
+	case XLOG_XACT_ONE_PHASE_COMMIT:
+		{
+		xl_xact_commit	xlrec;
+
+		/* A commit record, followed by the distributed xid and timestamp */
+		memcpy(&xlrec, XLogRecGetData(record), sizeof(xlrec));
+		snprintf(buf, sizeof(buf), "one-phase commit at %s",
+			 str_time(_timestamptz_to_time_t(xlrec.xact_time)));
+		}
+		rmgr_stats.xact_commit++;
+		break;
+#endif
+
 	case XLOG_XACT_PREPARE:
 		snprintf(buf, sizeof(buf), "prepare");
 		break;
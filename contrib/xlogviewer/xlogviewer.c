@@ -501,6 +501,10 @@ getXactName (RmgrId rmid, uint8 info)
 			{
 				return "commit";
 			}
+			else if (info == XLOG_XACT_ONE_PHASE_COMMIT)
+			{
+				return "one-phase commit";
+			}
 			else if (info == XLOG_XACT_ABORT)
 			{
 				return "abort";
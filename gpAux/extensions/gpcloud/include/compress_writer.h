@@ -27,15 +27,37 @@ class CompressWriter : public Writer {
     void setWriter(Writer *writer);
 
    private:
+    friend void *CompressThreadFunc(void *data);
+
     void flush();
     uint64_t writeOneChunk(const char *buf, uint64_t count);
 
+    // Hand 'in' over to compressThread, wait if it is still busy with the previous one.
+    void handOver();
+    void compressLoop();
+    void stopCompressThread();
+
     Writer *writer;
 
-    // zlib related variables.
+    // zlib related variables, only touched by compressThread while it is running.
     z_stream zstream;
     char *out;  // Output buffer for compression.
 
+    // Data is compressed and written to the underlying writer by compressThread, so that
+    // write() only has to copy data into 'in' buffer.
+    char *in;       // Input buffer being filled by write().
+    uint64_t inLen;
+    char *pending;  // Input buffer being compressed by compressThread.
+    uint64_t pendingLen;
+    bool hasPending;  // protected by pendingMutex.
+    pthread_t compressThread;
+    bool isThreadStarted;
+    bool isStopping;
+    std::exception_ptr threadException;
+
+    pthread_mutex_t pendingMutex;
+    pthread_cond_t pendingCond;
+
     // add this flag to make close() reentrant
     bool isClosed;
 };
@@ -29,7 +29,14 @@ class DecompressReader : public Reader {
     void resizeDecompressReaderBuffer(uint64_t size);
 
    private:
-    void decompress();
+    friend void *DecompressThreadFunc(void *data);
+
+    // Return false once the underlying reader has no more data.
+    bool decompress();
+
+    // Run by decompressThread: keep inflating into 'out' and hand it over
+    // to read() as 'ready' in order, until EOF, error or close().
+    void decompressLoop();
 
     uint64_t getDecompressedBytesNum() {
         return S3_ZIP_DECOMPRESS_CHUNKSIZE - this->zstream.avail_out;
@@ -37,11 +44,26 @@ class DecompressReader : public Reader {
 
     Reader *reader;
 
-    // zlib related variables.
+    // zlib related variables, only touched by decompressThread after it starts.
     z_stream zstream;
-    char *in;            // Input buffer for decompression.
-    char *out;           // Output buffer for decompression.
-    uint64_t outOffset;  // Next position to read in out buffer.
+    char *in;   // Input buffer for decompression.
+    char *out;  // Output buffer for decompression.
+
+    // Decompressed data handed over to read(), protected by readyMutex.
+    char *ready;
+    uint64_t readyLen;
+    bool readyFull;      // 'ready' holds data (or EOF if readyLen is 0) not consumed yet.
+    uint64_t outOffset;  // Next position to read in ready buffer.
+
+    // Decompression runs in its own thread so that inflate() overlaps with
+    // the consumer of read(), it is started by the first read().
+    pthread_t decompressThread;
+    bool isThreadStarted;
+    bool isStopping;
+    std::exception_ptr threadException;
+
+    pthread_mutex_t readyMutex;
+    pthread_cond_t readyCond;
 
     bool isClosed;
 };
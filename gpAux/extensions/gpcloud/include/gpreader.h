@@ -37,6 +37,7 @@ class GPReader : public Reader {
     S3Params params;
     S3BucketReader bucketReader;
     S3CommonReader commonReader;
+    S3CommonReader prefetchReader;
     S3RESTfulService restfulService;
 
     S3InterfaceService s3InterfaceService;
@@ -24,6 +24,12 @@ class S3BucketReader : public Reader {
         this->upstreamReader = reader;
     }
 
+    // Optional second reader used to open the next key while the current one
+    // is still being read, so that its download starts early.
+    void setPrefetchReader(Reader *reader) {
+        this->prefetchReader = reader;
+    }
+
     void parseURL();
     void parseURL(const string &url) {
         this->params.setBaseUrl(url);
@@ -62,6 +68,10 @@ class S3BucketReader : public Reader {
     Reader *upstreamReader;
     bool needNewReader;
 
+    // prefetchReader holds the next key if hasPrefetchedKey is true.
+    Reader *prefetchReader;
+    bool hasPrefetchedKey;
+
     // when load multiple files on one segment and each of them has a header line,
     // we should read header line only for the 1st file and ignore remainings.
     bool isFirstFile;
@@ -75,6 +85,10 @@ class S3BucketReader : public Reader {
 
     BucketContent &getNextKey();
     S3Params constructReaderParams(BucketContent &key);
+
+    // Open the key after current one in prefetchReader if both fit in
+    // the preallocated chunks.
+    void prefetchNextKey(const S3Params &currentParams);
 };
 
 #endif
@@ -12,6 +12,7 @@
 #include <signal.h>
 #include <zlib.h>
 #include <algorithm>
+#include <deque>
 #include <map>
 #include <memory>
 #include <set>
@@ -10,7 +10,8 @@ class WriterBuffer : public vector<uint8_t> {};
 
 class S3KeyWriter : public Writer {
    public:
-    S3KeyWriter() : sharedError(false), s3Interface(NULL), partNumber(0), activeThreads(0) {
+    S3KeyWriter()
+        : sharedError(false), s3Interface(NULL), partNumber(0), pendingParts(0), isStopping(false) {
         pthread_mutex_init(&this->mutex, NULL);
         pthread_cond_init(&this->cv, NULL);
         pthread_mutex_init(&this->exceptionMutex, NULL);
@@ -36,8 +37,17 @@ class S3KeyWriter : public Writer {
     }
 
    protected:
+    struct UploadPart {
+        S3VectorUInt8 data;
+        uint64_t partNumber;
+    };
+
     static void* UploadThreadFunc(void* p);
 
+    void uploadLoop();
+    void uploadPart(UploadPart* part);
+    void stopUploadThreads();
+
     void flushBuffer();
     void completeKeyWriting();
     void checkQueryCancelSignal();
@@ -52,11 +62,15 @@ class S3KeyWriter : public Writer {
     string uploadId;
     map<uint64_t, string> etagList;
 
+    // At most numOfChunks upload threads are created, they take parts from
+    // uploadQueue until stopUploadThreads() is called.
     vector<pthread_t> threadList;
+    std::deque<UploadPart*> uploadQueue;
     pthread_mutex_t mutex;
     pthread_cond_t cv;
     uint64_t partNumber;
-    uint64_t activeThreads;
+    uint64_t pendingParts;  // parts queued or being uploaded, no more than numOfChunks.
+    bool isStopping;
 
     S3Params params;
 };
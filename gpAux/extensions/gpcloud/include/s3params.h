@@ -146,4 +146,16 @@ inline void PrepareS3MemContext(const S3Params& params) {
     memoryContext.prepare(params.getChunkSize(), params.getNumOfChunks() + 1);
 }
 
+// Number of chunks(threads) worth spawning for a key, a key smaller than
+// numOfChunks * chunkSize doesn't need all of them.
+inline uint64_t GetNumOfChunksForKey(const S3Params& params) {
+    uint64_t chunkSize = params.getChunkSize();
+    if (chunkSize == 0) {
+        return params.getNumOfChunks();
+    }
+
+    uint64_t chunksOfKey = (params.getKeySize() + chunkSize - 1) / chunkSize;
+    return std::max((uint64_t)1, std::min(params.getNumOfChunks(), chunksOfKey));
+}
+
 #endif
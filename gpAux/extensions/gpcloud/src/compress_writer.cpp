@@ -4,11 +4,27 @@ uint64_t S3_ZIP_COMPRESS_CHUNKSIZE = S3_ZIP_DEFAULT_CHUNKSIZE;
 
 CompressWriter::CompressWriter() : writer(NULL), isClosed(true) {
     this->out = new char[S3_ZIP_COMPRESS_CHUNKSIZE];
+    this->in = new char[S3_ZIP_COMPRESS_CHUNKSIZE];
+    this->pending = new char[S3_ZIP_COMPRESS_CHUNKSIZE];
+    this->inLen = 0;
+    this->pendingLen = 0;
+    this->hasPending = false;
+
+    this->isThreadStarted = false;
+    this->isStopping = false;
+
+    pthread_mutex_init(&this->pendingMutex, NULL);
+    pthread_cond_init(&this->pendingCond, NULL);
 }
 
 CompressWriter::~CompressWriter() {
     this->close();
-    delete this->out;
+    delete[] this->out;
+    delete[] this->in;
+    delete[] this->pending;
+
+    pthread_mutex_destroy(&this->pendingMutex);
+    pthread_cond_destroy(&this->pendingCond);
 }
 
 void CompressWriter::open(const S3Params& params) {
@@ -28,6 +44,11 @@ void CompressWriter::open(const S3Params& params) {
     this->zstream.next_out = (Byte*)this->out;
     this->zstream.avail_out = S3_ZIP_COMPRESS_CHUNKSIZE;
 
+    this->inLen = 0;
+    this->hasPending = false;
+    this->isStopping = false;
+    this->threadException = NULL;
+
     S3_CHECK_OR_DIE(ret == Z_OK, S3RuntimeError,
                     string("Failed to initialize zlib library: ") + this->zstream.msg);
 
@@ -72,22 +93,125 @@ uint64_t CompressWriter::write(const char* buf, uint64_t count) {
 
     uint64_t writtenLen = 0;
 
-    for (uint64_t i = 0; i < (count / S3_ZIP_COMPRESS_CHUNKSIZE); i++) {
-        writtenLen += this->writeOneChunk(buf + writtenLen, S3_ZIP_COMPRESS_CHUNKSIZE);
-    }
+    while (writtenLen < count) {
+        uint64_t len = std::min(S3_ZIP_COMPRESS_CHUNKSIZE - this->inLen, count - writtenLen);
+        memcpy(this->in + this->inLen, buf + writtenLen, len);
+
+        this->inLen += len;
+        writtenLen += len;
 
-    if (writtenLen < count) {
-        writtenLen += this->writeOneChunk(buf + writtenLen, count - writtenLen);
+        if (this->inLen == S3_ZIP_COMPRESS_CHUNKSIZE) {
+            this->handOver();
+        }
     }
 
     return writtenLen;
 }
 
+void* CompressThreadFunc(void* data) {
+    MaskThreadSignals();
+
+    CompressWriter* compressWriter = static_cast<CompressWriter*>(data);
+
+    S3DEBUG("Compression thread starts");
+    compressWriter->compressLoop();
+    S3DEBUG("Compression thread ended");
+
+    return NULL;
+}
+
+void CompressWriter::compressLoop() {
+    while (true) {
+        {
+            UniqueLock lock(&this->pendingMutex);
+            while (!this->hasPending && !this->isStopping) {
+                pthread_cond_wait(&this->pendingCond, &this->pendingMutex);
+            }
+
+            if (!this->hasPending) {
+                return;
+            }
+        }
+
+        try {
+            this->writeOneChunk(this->pending, this->pendingLen);
+        } catch (...) {
+            UniqueLock lock(&this->pendingMutex);
+            this->threadException = std::current_exception();
+            this->hasPending = false;
+            pthread_cond_signal(&this->pendingCond);
+            return;
+        }
+
+        UniqueLock lock(&this->pendingMutex);
+        this->hasPending = false;
+        pthread_cond_signal(&this->pendingCond);
+    }
+}
+
+void CompressWriter::handOver() {
+    if (!this->isThreadStarted) {
+        int ret = pthread_create(&this->compressThread, NULL, CompressThreadFunc, this);
+        S3_CHECK_OR_DIE(ret == 0, S3RuntimeError, "failed to create compression thread");
+        this->isThreadStarted = true;
+    }
+
+    UniqueLock lock(&this->pendingMutex);
+    while (this->hasPending && (this->threadException == NULL)) {
+        pthread_cond_wait(&this->pendingCond, &this->pendingMutex);
+    }
+
+    if (this->threadException != NULL) {
+        std::rethrow_exception(this->threadException);
+    }
+
+    std::swap(this->in, this->pending);
+    this->pendingLen = this->inLen;
+    this->hasPending = true;
+    this->inLen = 0;
+    pthread_cond_signal(&this->pendingCond);
+}
+
+// Wait for compressThread to finish the pending buffer and exit.
+void CompressWriter::stopCompressThread() {
+    if (!this->isThreadStarted) {
+        return;
+    }
+
+    {
+        UniqueLock lock(&this->pendingMutex);
+        this->isStopping = true;
+        pthread_cond_signal(&this->pendingCond);
+    }
+
+    pthread_join(this->compressThread, NULL);
+    this->isThreadStarted = false;
+}
+
 void CompressWriter::close() {
     if (this->isClosed) {
         return;
     }
 
+    try {
+        if (this->inLen > 0) {
+            this->handOver();
+        }
+
+        this->stopCompressThread();
+
+        if (this->threadException != NULL) {
+            std::rethrow_exception(this->threadException);
+        }
+    } catch (...) {
+        this->stopCompressThread();
+
+        // it's harmless if writeOneChunk() has ended it already.
+        deflateEnd(&this->zstream);
+        this->isClosed = true;
+        throw;
+    }
+
     int status;
     do {
         status = deflate(&this->zstream, Z_FINISH);
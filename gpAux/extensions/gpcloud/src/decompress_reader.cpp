@@ -6,22 +6,37 @@ DecompressReader::DecompressReader() : isClosed(true) {
     this->reader = NULL;
     this->in = new char[S3_ZIP_DECOMPRESS_CHUNKSIZE];
     this->out = new char[S3_ZIP_DECOMPRESS_CHUNKSIZE];
+    this->ready = new char[S3_ZIP_DECOMPRESS_CHUNKSIZE];
+    this->readyLen = 0;
+    this->readyFull = false;
     this->outOffset = 0;
+
+    this->isThreadStarted = false;
+    this->isStopping = false;
+
+    pthread_mutex_init(&this->readyMutex, NULL);
+    pthread_cond_init(&this->readyCond, NULL);
 }
 
 DecompressReader::~DecompressReader() {
     this->close();
 
-    delete this->in;
-    delete this->out;
+    delete[] this->in;
+    delete[] this->out;
+    delete[] this->ready;
+
+    pthread_mutex_destroy(&this->readyMutex);
+    pthread_cond_destroy(&this->readyCond);
 }
 
 // Used for unit test to adjust buffer size
 void DecompressReader::resizeDecompressReaderBuffer(uint64_t size) {
-    delete this->in;
-    delete this->out;
+    delete[] this->in;
+    delete[] this->out;
+    delete[] this->ready;
     this->in = new char[size];
     this->out = new char[size];
+    this->ready = new char[size];
     this->outOffset = 0;
     this->zstream.avail_out = size;
 }
@@ -41,8 +56,13 @@ void DecompressReader::open(const S3Params &params) {
     zstream.avail_in = 0;
     zstream.avail_out = S3_ZIP_DECOMPRESS_CHUNKSIZE;
 
+    this->readyLen = 0;
+    this->readyFull = false;
     this->outOffset = 0;
 
+    this->isStopping = false;
+    this->threadException = NULL;
+
     // with S3_INFLATE_WINDOWSBITS, it could recognize and decode both zlib and gzip stream.
     int ret = inflateInit2(&zstream, S3_INFLATE_WINDOWSBITS);
     S3_CHECK_OR_DIE(ret == Z_OK, S3RuntimeError, "failed to initialize zlib library");
@@ -52,26 +72,95 @@ void DecompressReader::open(const S3Params &params) {
     this->reader->open(params);
 }
 
+void *DecompressThreadFunc(void *data) {
+    MaskThreadSignals();
+
+    DecompressReader *decompressReader = static_cast<DecompressReader *>(data);
+
+    S3DEBUG("Decompression thread starts");
+    decompressReader->decompressLoop();
+    S3DEBUG("Decompression thread ended");
+
+    return NULL;
+}
+
+void DecompressReader::decompressLoop() {
+    while (true) {
+        bool hasMore = true;
+        uint64_t decompressedLen = 0;
+
+        try {
+            // A call might legitimately produce nothing, e.g. when it only consumed a gzip
+            // member trailer or the header of the next member. Only the end of the upstream
+            // data is EOF.
+            do {
+                hasMore = this->decompress();
+                decompressedLen = this->getDecompressedBytesNum();
+            } while (hasMore && decompressedLen == 0);
+        } catch (...) {
+            UniqueLock lock(&this->readyMutex);
+            this->threadException = std::current_exception();
+            pthread_cond_signal(&this->readyCond);
+            return;
+        }
+
+        UniqueLock lock(&this->readyMutex);
+        while (this->readyFull && !this->isStopping) {
+            pthread_cond_wait(&this->readyCond, &this->readyMutex);
+        }
+
+        if (this->isStopping) {
+            return;
+        }
+
+        std::swap(this->out, this->ready);
+        this->readyLen = decompressedLen;
+        this->readyFull = true;
+        this->outOffset = 0;  // reset cursor for ready buffer to read from beginning.
+        pthread_cond_signal(&this->readyCond);
+
+        // EOF, no more data to decompress.
+        if (decompressedLen == 0) {
+            return;
+        }
+    }
+}
+
 uint64_t DecompressReader::read(char *buf, uint64_t bufSize) {
-    uint64_t remainingOutLen = this->getDecompressedBytesNum() - this->outOffset;
+    if (!this->isThreadStarted) {
+        int ret = pthread_create(&this->decompressThread, NULL, DecompressThreadFunc, this);
+        S3_CHECK_OR_DIE(ret == 0, S3RuntimeError, "failed to create decompression thread");
+        this->isThreadStarted = true;
+    }
+
+    UniqueLock lock(&this->readyMutex);
+    while (!this->readyFull && (this->threadException == NULL)) {
+        pthread_cond_wait(&this->readyCond, &this->readyMutex);
+    }
 
-    if (remainingOutLen == 0) {
-        this->decompress();
-        this->outOffset = 0;  // reset cursor for out buffer to read from beginning.
-        remainingOutLen = this->getDecompressedBytesNum();
+    // data decompressed before the error is still returned first.
+    if (!this->readyFull) {
+        std::rethrow_exception(this->threadException);
     }
 
-    uint64_t count = std::min(remainingOutLen, bufSize);
-    memcpy(buf, this->out + outOffset, count);
+    uint64_t count = std::min(this->readyLen - this->outOffset, bufSize);
+    memcpy(buf, this->ready + this->outOffset, count);
 
     this->outOffset += count;
 
+    // keep the EOF mark (readyLen is 0) so that following read() return 0 too.
+    if ((this->outOffset == this->readyLen) && (this->readyLen != 0)) {
+        this->readyFull = false;
+        pthread_cond_signal(&this->readyCond);
+    }
+
     return count;
 }
 
 // Read compressed data from underlying reader and decompress to this->out buffer.
-// If no more data to consume, this->zstream.avail_out == S3_ZIP_DECOMPRESS_CHUNKSIZE;
-void DecompressReader::decompress() {
+// Return false if no more data to consume, this->zstream.avail_out ==
+// S3_ZIP_DECOMPRESS_CHUNKSIZE then.
+bool DecompressReader::decompress() {
     if (this->zstream.avail_in == 0) {
         this->zstream.avail_out = S3_ZIP_DECOMPRESS_CHUNKSIZE;
         this->zstream.next_out = (Byte *)this->out;
@@ -87,7 +176,7 @@ void DecompressReader::decompress() {
                 "No more data to decompress: avail_in = %u, avail_out = %u, total_in = %u, "
                 "total_out = %u",
                 zstream.avail_in, zstream.avail_out, zstream.total_in, zstream.total_out);
-            return;
+            return false;
         }
 
         // Fill this->in as possible as it could, otherwise data in this->in might not be able to be
@@ -114,14 +203,31 @@ void DecompressReader::decompress() {
     int status = inflate(&this->zstream, Z_NO_FLUSH);
     if (status == Z_STREAM_END) {
         S3DEBUG("Decompression finished: Z_STREAM_END.");
+
+        // A gzip file may consist of multiple members (e.g. concatenated or bgzf files),
+        // reset the stream to go on with the next member if there is any.
+        inflateReset(&this->zstream);
     } else if (status < 0 || status == Z_NEED_DICT) {
         inflateEnd(&this->zstream);
         S3_CHECK_OR_DIE(false, S3RuntimeError, string("Failed to decompress data: ") +
                                                    std::to_string((unsigned long long)status));
     }
+
+    return true;
 }
 
 void DecompressReader::close() {
+    if (this->isThreadStarted) {
+        {
+            UniqueLock lock(&this->readyMutex);
+            this->isStopping = true;
+            pthread_cond_signal(&this->readyCond);
+        }
+
+        pthread_join(this->decompressThread, NULL);
+        this->isThreadStarted = false;
+    }
+
     if (!this->isClosed) {
         inflateEnd(&zstream);
         this->reader->close();
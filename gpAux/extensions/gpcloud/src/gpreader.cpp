@@ -75,6 +75,8 @@ void GPReader::open(const S3Params& params) {
     this->bucketReader.setS3InterfaceService(&this->s3InterfaceService);
     this->bucketReader.setUpstreamReader(&this->commonReader);
     this->commonReader.setS3InterfaceService(&this->s3InterfaceService);
+    this->bucketReader.setPrefetchReader(&this->prefetchReader);
+    this->prefetchReader.setS3InterfaceService(&this->s3InterfaceService);
     this->bucketReader.open(this->params);
 }
 
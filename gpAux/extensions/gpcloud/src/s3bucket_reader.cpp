@@ -5,8 +5,10 @@ S3BucketReader::S3BucketReader() : Reader() {
 
     this->s3Interface = NULL;
     this->upstreamReader = NULL;
+    this->prefetchReader = NULL;
 
     this->needNewReader = true;
+    this->hasPrefetchedKey = false;
     this->isFirstFile = true;
 }
 
@@ -49,6 +51,26 @@ S3Params S3BucketReader::constructReaderParams(BucketContent& key) {
     return readerParams;
 }
 
+void S3BucketReader::prefetchNextKey(const S3Params& currentParams) {
+    if ((this->prefetchReader == NULL) || (this->keyIndex >= this->keyList.contents.size())) {
+        return;
+    }
+
+    S3Params nextParams = constructReaderParams(this->keyList.contents[this->keyIndex]);
+
+    // Chunks are preallocated (numOfChunks + 1), prefetch only if the download
+    // threads of both keys can hold a chunk at the same time.
+    if (GetNumOfChunksForKey(currentParams) + GetNumOfChunksForKey(nextParams) >
+        this->params.getNumOfChunks()) {
+        return;
+    }
+
+    S3DEBUG("Prefetch key: %s", nextParams.getKeyUrl().c_str());
+
+    this->prefetchReader->open(nextParams);
+    this->hasPrefetchedKey = true;
+}
+
 uint64_t S3BucketReader::readWithoutHeaderLine(char* buf, uint64_t count) {
     char* current = NULL;
     char* end = NULL;
@@ -101,11 +123,18 @@ uint64_t S3BucketReader::read(char* buf, uint64_t count) {
                 S3DEBUG("Read finished for segment: %d", s3ext_segid);
                 return 0;
             }
-            BucketContent& key = this->getNextKey();
+            S3Params readerParams = constructReaderParams(this->getNextKey());
 
-            this->upstreamReader->open(constructReaderParams(key));
+            if (this->hasPrefetchedKey) {
+                std::swap(this->upstreamReader, this->prefetchReader);
+                this->hasPrefetchedKey = false;
+            } else {
+                this->upstreamReader->open(readerParams);
+            }
             this->needNewReader = false;
 
+            this->prefetchNextKey(readerParams);
+
             // ignore header line if it is not the first file
             if (hasHeader && !this->isFirstFile) {
                 readCount = readWithoutHeaderLine(buf, count);
@@ -133,6 +162,12 @@ void S3BucketReader::close() {
         this->upstreamReader = NULL;
     }
 
+    if (this->prefetchReader != NULL) {
+        this->prefetchReader->close();
+        this->prefetchReader = NULL;
+    }
+    this->hasPrefetchedKey = false;
+
     if (!this->keyList.contents.empty()) {
         this->keyList.contents.clear();
     }
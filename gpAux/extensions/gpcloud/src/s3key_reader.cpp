@@ -191,8 +191,10 @@ void S3KeyReader::open(const S3Params& params) {
 
     this->sharedError = false;
 
-    this->numOfChunks = params.getNumOfChunks();
-    S3_CHECK_OR_DIE(this->numOfChunks > 0, S3RuntimeError, "numOfChunks must not be zero");
+    S3_CHECK_OR_DIE(params.getNumOfChunks() > 0, S3RuntimeError, "numOfChunks must not be zero");
+
+    // don't spawn threads that will never get a range to download.
+    this->numOfChunks = GetNumOfChunksForKey(params);
 
     this->region = params.getRegion();
 
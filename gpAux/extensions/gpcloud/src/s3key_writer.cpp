@@ -52,17 +52,8 @@ void S3KeyWriter::close() {
 
 void S3KeyWriter::checkQueryCancelSignal() {
     if (S3QueryIsAbortInProgress() && !this->uploadId.empty()) {
-        // to avoid dead-lock when other upload threads hold the lock
-        pthread_mutex_unlock(&this->mutex);
-
         // wait for all threads to complete
-        for (size_t i = 0; i < threadList.size(); i++) {
-            pthread_join(threadList[i], NULL);
-        }
-        this->threadList.clear();
-
-        // to avoid double unlock as other parts may lock it
-        pthread_mutex_lock(&this->mutex);
+        this->stopUploadThreads();
 
         S3DEBUG("Start aborting multipart uploading (uploadID: %s, %lu parts uploaded)",
                 this->uploadId.c_str(), this->etagList.size());
@@ -77,71 +68,124 @@ void S3KeyWriter::checkQueryCancelSignal() {
     }
 }
 
-struct ThreadParams {
-    S3KeyWriter* keyWriter;
-    S3VectorUInt8 data;
-    uint64_t currentNumber;
-};
-
 void* S3KeyWriter::UploadThreadFunc(void* data) {
     MaskThreadSignals();
 
-    ThreadParams* params = (ThreadParams*)data;
-    S3KeyWriter* writer = params->keyWriter;
+    S3KeyWriter* writer = (S3KeyWriter*)data;
+
+    S3DEBUG("Upload thread start: %p", pthread_self());
+    writer->uploadLoop();
+    S3DEBUG("Upload thread end: %p", pthread_self());
+
+    return NULL;
+}
+
+void S3KeyWriter::uploadLoop() {
+    while (true) {
+        UploadPart* part = NULL;
+        {
+            UniqueLock queueLock(&this->mutex);
+            while (this->uploadQueue.empty() && !this->isStopping) {
+                pthread_cond_wait(&this->cv, &this->mutex);
+            }
+
+            // queued parts are always uploaded before exiting.
+            if (this->uploadQueue.empty()) {
+                return;
+            }
+
+            part = this->uploadQueue.front();
+            this->uploadQueue.pop_front();
+        }
+
+        // no need to upload more parts once one of them failed.
+        if (!this->sharedError) {
+            this->uploadPart(part);
+        }
+
+        // release the buffer back to memory context before others could queue a new one.
+        delete part;
+
+        UniqueLock queueLock(&this->mutex);
+        this->pendingParts--;
+        pthread_cond_broadcast(&this->cv);
+    }
+}
 
+void S3KeyWriter::uploadPart(UploadPart* part) {
     try {
-        S3DEBUG("Upload thread start: %p, part number: %" PRIu64 ", data size: %" PRIu64,
-                pthread_self(), params->currentNumber, params->data.size());
-        string etag = writer->s3Interface->uploadPartOfData(
-            params->data, writer->params.getKeyUrl(), writer->params.getRegion(),
-            params->currentNumber, writer->uploadId);
+        S3DEBUG("Upload part start: %p, part number: %" PRIu64 ", data size: %" PRIu64,
+                pthread_self(), part->partNumber, part->data.size());
+        string etag =
+            this->s3Interface->uploadPartOfData(part->data, this->params.getKeyUrl(),
+                                                this->params.getRegion(), part->partNumber,
+                                                this->uploadId);
 
         // when unique_lock destructs it will automatically unlock the mutex.
-        UniqueLock threadLock(&writer->mutex);
+        UniqueLock threadLock(&this->mutex);
 
         // etag is empty if the query is cancelled by user.
         if (!etag.empty()) {
-            writer->etagList[params->currentNumber] = etag;
+            this->etagList[part->partNumber] = etag;
         }
-        writer->activeThreads--;
-        pthread_cond_broadcast(&writer->cv);
         S3DEBUG("Upload part finish: %p, eTag: %s, part number: %" PRIu64, pthread_self(),
-                etag.c_str(), params->currentNumber);
+                etag.c_str(), part->partNumber);
     } catch (S3Exception& e) {
         S3ERROR("Upload thread error: %s", e.getMessage().c_str());
-        UniqueLock exceptLock(&writer->exceptionMutex);
-        writer->sharedError = true;
-        writer->sharedException = std::current_exception();
+        UniqueLock exceptLock(&this->exceptionMutex);
+        this->sharedError = true;
+        this->sharedException = std::current_exception();
+    }
+}
 
-        // notify the flushBuffer, otherwise it will be locked when trying to create a new thread.
-        writer->activeThreads--;
-        pthread_cond_broadcast(&writer->cv);
+// Let upload threads finish queued parts and wait for them to exit.
+void S3KeyWriter::stopUploadThreads() {
+    {
+        UniqueLock queueLock(&this->mutex);
+        this->isStopping = true;
+        pthread_cond_broadcast(&this->cv);
     }
 
-    delete params;
-    return NULL;
+    for (size_t i = 0; i < threadList.size(); i++) {
+        pthread_join(threadList[i], NULL);
+    }
+    this->threadList.clear();
+
+    this->isStopping = false;
 }
 
 void S3KeyWriter::flushBuffer() {
     if (!this->buffer.empty()) {
-        UniqueLock queueLock(&this->mutex);
-        while (this->activeThreads >= this->params.getNumOfChunks()) {
-            pthread_cond_wait(&this->cv, &this->mutex);
+        {
+            UniqueLock queueLock(&this->mutex);
+            while (this->pendingParts >= this->params.getNumOfChunks()) {
+                pthread_cond_wait(&this->cv, &this->mutex);
+            }
         }
 
         // Most time query is canceled during uploadPartOfData(). This is the first chance to cancel
         // and clean up upload.
         this->checkQueryCancelSignal();
 
-        this->activeThreads++;
+        // threads are created on demand, so small keys don't pay for the whole pool. Create it
+        // before queuing the part, so that a queued part always has a thread to upload it.
+        if (this->threadList.size() < this->params.getNumOfChunks()) {
+            pthread_t writerThread;
+            int ret = pthread_create(&writerThread, NULL, UploadThreadFunc, this);
+            S3_CHECK_OR_DIE(ret == 0, S3RuntimeError, "failed to create upload thread");
+            threadList.emplace_back(writerThread);
+        }
+
+        UploadPart* part = new UploadPart();
+        part->data.swap(this->buffer);
+        part->partNumber = ++this->partNumber;
 
-        pthread_t writerThread;
-        ThreadParams* params = new ThreadParams();
-        params->keyWriter = this;
-        params->data.swap(this->buffer);
-        params->currentNumber = ++this->partNumber;
-        pthread_create(&writerThread, NULL, UploadThreadFunc, params);
-        threadList.emplace_back(writerThread);
+        {
+            UniqueLock queueLock(&this->mutex);
+            this->uploadQueue.push_back(part);
+            this->pendingParts++;
+            pthread_cond_broadcast(&this->cv);
+        }
 
         this->buffer.reserve(this->params.getChunkSize());
     }
@@ -152,10 +196,7 @@ void S3KeyWriter::completeKeyWriting() {
     this->flushBuffer();
 
     // wait for all threads to complete
-    for (size_t i = 0; i < threadList.size(); i++) {
-        pthread_join(threadList[i], NULL);
-    }
-    this->threadList.clear();
+    this->stopUploadThreads();
 
     this->checkQueryCancelSignal();
 
@@ -39,6 +39,13 @@ class MockWriter : public Writer {
     vector<char> data;
 };
 
+class FailedWriter : public MockWriter {
+   public:
+    virtual uint64_t write(const char *buf, uint64_t count) {
+        S3_DIE(S3RuntimeError, "failed to write");
+    }
+};
+
 class CompressWriterTest : public testing::Test {
    protected:
     // Remember that SetUp() is run immediately before a test starts.
@@ -211,3 +218,22 @@ TEST_F(CompressWriterTest, CompressCompressedData) {
 
     EXPECT_TRUE(memcmp(compressedData.data(), result.get(), compressedData.size()) == 0);
 }
+
+TEST_F(CompressWriterTest, ErrorOfUnderlyingWriterIsThrown) {
+    FailedWriter failedWriter;
+    CompressWriter writer;
+    writer.setWriter(&failedWriter);
+    writer.open(this->params);
+
+    // fill more than one chunk of incompressible data to have it compressed in background.
+    string input(S3_ZIP_COMPRESS_CHUNKSIZE + 1, 'a');
+    for (size_t i = 0; i < input.length(); i++) {
+        input[i] = rand() & 0xFF;
+    }
+    writer.write(input.c_str(), input.length());
+
+    EXPECT_THROW(writer.close(), S3RuntimeError);
+
+    // close() is still reentrant after error.
+    EXPECT_NO_THROW(writer.close());
+}
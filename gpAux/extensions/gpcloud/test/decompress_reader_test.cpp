@@ -314,3 +314,80 @@ TEST_F(DecompressReaderTest, AbleToDecompressWithIncorrectEncodedStream) {
 
     EXPECT_THROW(decompressReader.read(outputBuffer, sizeof(outputBuffer)), S3RuntimeError);
 }
+
+TEST_F(DecompressReaderTest, AbleToDecompressMultiMemberGzipData) {
+    const char hello[] = "The quick brown fox ";
+    const char world[] = "jumps over the lazy dog";
+
+    // compress each part as a gzip member and concatenate them, like 'cat a.gz b.gz'.
+    std::vector<uint8_t> members;
+    const char *parts[] = {hello, world};
+    for (int i = 0; i < 2; i++) {
+        z_stream zs;
+        memset(&zs, 0, sizeof(zs));
+        ASSERT_EQ(Z_OK, deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, MAX_WBITS + 16, 8,
+                                     Z_DEFAULT_STRATEGY));
+
+        zs.next_in = (Bytef *)parts[i];
+        zs.avail_in = strlen(parts[i]);
+        zs.next_out = compressionBuff;
+        zs.avail_out = sizeof(compressionBuff);
+        ASSERT_EQ(Z_STREAM_END, deflate(&zs, Z_FINISH));
+
+        members.insert(members.end(), compressionBuff, compressionBuff + zs.total_out);
+        deflateEnd(&zs);
+    }
+    bufReader.setData(members.data(), members.size());
+
+    char buf[10000];
+    uint64_t total = 0;
+    uint64_t count = 0;
+    while ((count = decompressReader.read(buf + total, sizeof(buf) - total)) != 0) {
+        total += count;
+    }
+
+    EXPECT_EQ(strlen(hello) + strlen(world), total);
+    EXPECT_EQ(0, strncmp("The quick brown fox jumps over the lazy dog", buf, total));
+}
+
+TEST_F(DecompressReaderTest, AbleToDecompressMultiMemberGzipDataWithSmallBuffer) {
+    // With a buffer smaller than a member trailer plus the next member header, some calls to
+    // inflate() consume input without producing any output, that must not be taken as EOF.
+    S3_ZIP_DECOMPRESS_CHUNKSIZE = 16;
+    decompressReader.resizeDecompressReaderBuffer(S3_ZIP_DECOMPRESS_CHUNKSIZE);
+    this->bufReader.setChunkSize(7);
+
+    const char *parts[] = {"The quick ", "brown fox ", "jumps ", "over the ", "lazy dog"};
+    const int numParts = sizeof(parts) / sizeof(parts[0]);
+    std::string expected;
+
+    std::vector<uint8_t> members;
+    for (int i = 0; i < numParts; i++) {
+        z_stream zs;
+        memset(&zs, 0, sizeof(zs));
+        ASSERT_EQ(Z_OK, deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, MAX_WBITS + 16, 8,
+                                     Z_DEFAULT_STRATEGY));
+
+        zs.next_in = (Bytef *)parts[i];
+        zs.avail_in = strlen(parts[i]);
+        zs.next_out = compressionBuff;
+        zs.avail_out = sizeof(compressionBuff);
+        ASSERT_EQ(Z_STREAM_END, deflate(&zs, Z_FINISH));
+
+        members.insert(members.end(), compressionBuff, compressionBuff + zs.total_out);
+        deflateEnd(&zs);
+
+        expected += parts[i];
+    }
+    bufReader.setData(members.data(), members.size());
+
+    char buf[10000];
+    uint64_t total = 0;
+    uint64_t count = 0;
+    while ((count = decompressReader.read(buf + total, 5)) != 0) {
+        total += count;
+    }
+
+    EXPECT_EQ(expected.size(), total);
+    EXPECT_EQ(0, strncmp(expected.c_str(), buf, total));
+}
@@ -248,6 +248,69 @@ TEST_F(S3BucketReaderTest, UpstreamReaderThrowException) {
     EXPECT_THROW(bucketReader->read(buf, sizeof(buf)), S3RuntimeError);
 }
 
+TEST_F(S3BucketReaderTest, ReadBucketWithPrefetchReader) {
+    ListBucketResult result;
+    result.contents.emplace_back("foo", 100);
+    result.contents.emplace_back("bar", 100);
+
+    EXPECT_CALL(s3Interface, listBucket(_, _, _, _)).Times(1).WillOnce(Return(result));
+
+    MockS3Reader prefetchReader;
+
+    // two chunks for each key, both fit in four chunks, so "bar" is prefetched.
+    EXPECT_CALL(s3Reader, open(_)).Times(1);
+    EXPECT_CALL(prefetchReader, open(_)).Times(1);
+
+    EXPECT_CALL(s3Reader, read(_, _)).Times(2).WillOnce(Return(100)).WillOnce(Return(0));
+    EXPECT_CALL(prefetchReader, read(_, _)).Times(2).WillOnce(Return(64)).WillOnce(Return(0));
+
+    s3ext_segid = 0;
+    s3ext_segnum = 1;
+    params.setNumOfChunks(4);
+    params.setChunkSize(64);
+    params.setBaseUrl("https://s3-us-east-2.amazonaws.com/s3test.pivotal.io/whatever");
+    bucketReader->open(params);
+    bucketReader->setUpstreamReader(&s3Reader);
+    bucketReader->setPrefetchReader(&prefetchReader);
+
+    EXPECT_EQ((uint64_t)100, bucketReader->read(buf, sizeof(buf)));
+    EXPECT_EQ((uint64_t)64, bucketReader->read(buf, sizeof(buf)));
+    EXPECT_EQ((uint64_t)0, bucketReader->read(buf, sizeof(buf)));
+}
+
+TEST_F(S3BucketReaderTest, ReadBucketWithoutPrefetchIfChunksNotEnough) {
+    ListBucketResult result;
+    result.contents.emplace_back("foo", 100);
+    result.contents.emplace_back("bar", 100);
+
+    EXPECT_CALL(s3Interface, listBucket(_, _, _, _)).Times(1).WillOnce(Return(result));
+
+    MockS3Reader prefetchReader;
+
+    EXPECT_CALL(s3Reader, open(_)).Times(2);
+    EXPECT_CALL(prefetchReader, open(_)).Times(0);
+
+    EXPECT_CALL(s3Reader, read(_, _))
+        .Times(4)
+        .WillOnce(Return(100))
+        .WillOnce(Return(0))
+        .WillOnce(Return(64))
+        .WillOnce(Return(0));
+
+    s3ext_segid = 0;
+    s3ext_segnum = 1;
+    params.setNumOfChunks(3);
+    params.setChunkSize(64);
+    params.setBaseUrl("https://s3-us-east-2.amazonaws.com/s3test.pivotal.io/whatever");
+    bucketReader->open(params);
+    bucketReader->setUpstreamReader(&s3Reader);
+    bucketReader->setPrefetchReader(&prefetchReader);
+
+    EXPECT_EQ((uint64_t)100, bucketReader->read(buf, sizeof(buf)));
+    EXPECT_EQ((uint64_t)64, bucketReader->read(buf, sizeof(buf)));
+    EXPECT_EQ((uint64_t)0, bucketReader->read(buf, sizeof(buf)));
+}
+
 class MockRead {
    public:
     MockRead(const char* ptr) : p(ptr) {
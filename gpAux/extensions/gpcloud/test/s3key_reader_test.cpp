@@ -501,6 +501,9 @@ TEST_F(S3KeyReaderTest, MTReadWithRedundantChunks) {
 
     this->open(params);
 
+    // only 4 chunks are needed for this key
+    EXPECT_EQ((uint64_t)4, this->getThreads().size());
+
     EXPECT_EQ((uint64_t)32, this->read(buffer, 32));
     EXPECT_EQ((uint64_t)32, this->read(buffer, 32));
     EXPECT_EQ((uint64_t)32, this->read(buffer, 32));
@@ -186,3 +186,24 @@ TEST_F(S3KeyWriterTest, TestWriteAbortInClosing) {
     EXPECT_THROW(this->close(), S3QueryAbort);
     QueryCancelPending = false;
 }
+
+TEST_F(S3KeyWriterTest, TestUploadThreadsBoundedByNumOfChunks) {
+    testParams.setChunkSize(0x100);
+
+    char data[0x100];
+    EXPECT_CALL(this->mockS3Interface, getUploadId(_, _)).WillOnce(Return("uploadid1"));
+    EXPECT_CALL(this->mockS3Interface, uploadPartOfData(_, _, _, _, "uploadid1"))
+        .Times(10)
+        .WillRepeatedly(Invoke(MockUploadPartOfData(0x100)));
+    EXPECT_CALL(this->mockS3Interface, completeMultiPart(_, _, _, _)).WillOnce(Return(true));
+
+    this->open(testParams);
+    for (int i = 0; i < 10; i++) {
+        ASSERT_EQ((uint64_t)0x100, this->write(data, sizeof(data)));
+        EXPECT_GE(testParams.getNumOfChunks(), this->threadList.size());
+    }
+
+    this->close();
+    EXPECT_TRUE(this->threadList.empty());
+    EXPECT_EQ((uint64_t)10, this->partNumber);
+}
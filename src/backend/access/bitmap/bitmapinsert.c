@@ -90,12 +90,13 @@ static void buf_make_space(Relation rel,
 					  BMTidBuildBuf *tidLocsBuffer, bool use_wal);
 static void verify_bitmappages(Relation rel, BMLOVItem lovitem);
 static int16 buf_add_tid_with_fill(Relation rel, BMTIDBuffer *buf,
-								   Buffer lovBuffer, OffsetNumber off,
-								   uint64 tidnum, bool use_wal);
+								   BlockNumber lov_block, Buffer lovBuffer,
+								   OffsetNumber off, uint64 tidnum,
+								   bool use_wal);
 static uint16 buf_extend(BMTIDBuffer *buf);
 static uint16 buf_ensure_head_space(Relation rel, BMTIDBuffer *buf,
-								   Buffer lovBuffer, OffsetNumber off,
-								   bool use_wal);
+								   BlockNumber lov_block, Buffer lovBuffer,
+								   OffsetNumber off, bool use_wal);
 static uint16 buf_free_mem_block(Relation rel, BMTIDBuffer *buf,
 			  			         Buffer lovBuffer, OffsetNumber off,
 						         bool use_wal);
@@ -1720,13 +1721,14 @@ buf_add_tid(Relation rel, BMTidBuildBuf *tids, uint64 tidnum,
 
 	if (lov_buf->bufs[off - 1])
 	{
-
 		buf = lov_buf->bufs[off - 1];
 
-		Buffer lovbuf = _bitmap_getbuf(rel, lov_block, BM_WRITE);
-		buf_add_tid_with_fill(rel, buf, lovbuf, off,
+		/*
+		 * Most tids only go into the in-memory buffer, so don't lock the
+		 * LOV page unless words have to be written out.
+		 */
+		buf_add_tid_with_fill(rel, buf, lov_block, InvalidBuffer, off,
 							  tidnum, state->use_wal);
-		_bitmap_relbuf(lovbuf);
 	}
 	else
 	{
@@ -1754,7 +1756,7 @@ buf_add_tid(Relation rel, BMTidBuildBuf *tids, uint64 tidnum,
 		buf->curword = 0;
 		buf->start_wordno = 0;
 
-		buf_add_tid_with_fill(rel, buf, lovbuf, off, tidnum,
+		buf_add_tid_with_fill(rel, buf, lov_block, lovbuf, off, tidnum,
 							  state->use_wal);
 
 		_bitmap_relbuf(lovbuf);
@@ -1767,14 +1769,18 @@ buf_add_tid(Relation rel, BMTidBuildBuf *tids, uint64 tidnum,
 /*
  * buf_add_tid_with_fill() -- Worker for buf_add_tid().
  *
+ * lovBuffer is the LOV page 'lov_block', locked by the caller, or
+ * InvalidBuffer if the caller doesn't hold it; in that case the page is
+ * only locked when words are moved to disk.
+ *
  * Return how many bytes are used. Since we move words to disk when
  * there is no space left for new header words, this returning number
  * can be negative.
  */
 static int16
 buf_add_tid_with_fill(Relation rel, BMTIDBuffer *buf,
-					  Buffer lovBuffer, OffsetNumber off,
-					  uint64 tidnum, bool use_wal)
+					  BlockNumber lov_block, Buffer lovBuffer,
+					  OffsetNumber off, uint64 tidnum, bool use_wal)
 {
 	int64 zeros;
 	uint16 inserting_pos;
@@ -1818,7 +1824,8 @@ buf_add_tid_with_fill(Relation rel, BMTIDBuffer *buf,
 			 * last bitmap complete word.
 			 */
 			bytes_used -=
-				buf_ensure_head_space(rel, buf, lovBuffer, off, use_wal);
+				buf_ensure_head_space(rel, buf, lov_block, lovBuffer, off,
+									  use_wal);
 
 			bytes_used += mergewords(buf, false);
 			zeros -= zerosNeeded;
@@ -1845,7 +1852,8 @@ buf_add_tid_with_fill(Relation rel, BMTIDBuffer *buf,
 			buf->last_word = BM_MAKE_FILL_WORD(0, numOfFillWords);
 
 			bytes_used -= 
-				buf_ensure_head_space(rel, buf, lovBuffer, off, use_wal);
+				buf_ensure_head_space(rel, buf, lov_block, lovBuffer, off,
+									  use_wal);
 			bytes_used += mergewords(buf, true);
 
 			numOfTotalFillWords -= numOfFillWords;
@@ -1875,7 +1883,8 @@ buf_add_tid_with_fill(Relation rel, BMTIDBuffer *buf,
 		}
 
 		bytes_used -=
-			buf_ensure_head_space(rel, buf, lovBuffer, off, use_wal);
+			buf_ensure_head_space(rel, buf, lov_block, lovBuffer, off,
+									  use_wal);
 		bytes_used += mergewords(buf, lastWordFill);
 	}
 
@@ -1892,7 +1901,7 @@ buf_add_tid_with_fill(Relation rel, BMTIDBuffer *buf,
  * The number of bytes freed are returned.
  */
 static uint16
-buf_ensure_head_space(Relation rel, BMTIDBuffer *buf, 
+buf_ensure_head_space(Relation rel, BMTIDBuffer *buf, BlockNumber lov_block,
 					  Buffer lovBuffer, OffsetNumber off, bool use_wal)
 {
 	uint16 bytes_freed = 0;
@@ -1901,7 +1910,10 @@ buf_ensure_head_space(Relation rel, BMTIDBuffer *buf,
 
 	if (buf->curword >= (BM_NUM_OF_HEADER_WORDS * BM_HRL_WORD_SIZE))
 	{
-		bytes_freed = buf_free_mem_block(rel, buf, lovBuffer, off, use_wal);
+		if (BufferIsValid(lovBuffer))
+			bytes_freed = buf_free_mem_block(rel, buf, lovBuffer, off, use_wal);
+		else
+			bytes_freed = buf_free_mem(rel, buf, lov_block, off, use_wal);
 		bytes_freed -= buf_extend(buf);
 	}
 
@@ -2120,7 +2132,8 @@ insertsetbit(Relation rel, BlockNumber lovBlock, OffsetNumber lovOffset,
 	 * To insert this new set bit, we also need to add all zeros between
 	 * this set bit and last set bit. We construct all new words here.
 	 */
-	buf_add_tid_with_fill(rel, buf, lovBuffer, lovOffset, tidnum, use_wal);
+	buf_add_tid_with_fill(rel, buf, lovBlock, lovBuffer, lovOffset, tidnum,
+						  use_wal);
 	
 	/*
 	 * If there are only updates to the last bitmap complete word and
@@ -2260,9 +2273,7 @@ build_inserttuple(Relation rel, uint64 tidnum,
 	
 	// -------- MirroredLock ----------
 	MIRROREDLOCK_BUFMGR_LOCK;
-	
-	metabuf = _bitmap_getbuf(rel, BM_METAPAGE, BM_WRITE);
-	
+
 	/*
 	 * if the inserting tuple has the value of NULL, then
 	 * the corresponding tid array is the first.
@@ -2300,11 +2311,14 @@ build_inserttuple(Relation rel, uint64 tidnum,
 
 				/*
 				 * If the inserting tuple has a new value, then we create a new
-				 * LOV item.
+				 * LOV item. Only that needs the metapage, so most tuples
+				 * don't touch it.
 				 */
+				metabuf = _bitmap_getbuf(rel, BM_METAPAGE, BM_WRITE);
 				create_lovitem(rel, metabuf, tidnum, tupDesc, attdata, 
 							   nulls, state->bm_lov_heap, state->bm_lov_index,
 							   &lovBlock, &lovOffset, state->use_wal);
+				_bitmap_wrtbuf(metabuf);
 
 				lov = (BMBuildLovData *) (((char*)entry) + state->lovitem_hashKeySize );
 				lov->lov_block = lovBlock;
@@ -2350,17 +2364,19 @@ build_inserttuple(Relation rel, uint64 tidnum,
 			{
 				/*
 				 * If the inserting tuple has a new value, then we create a new
-				 * LOV item.
+				 * LOV item. Only that needs the metapage, so most tuples
+				 * don't touch it.
 				 */
+				metabuf = _bitmap_getbuf(rel, BM_METAPAGE, BM_WRITE);
 				create_lovitem(rel, metabuf, tidnum, tupDesc, attdata, 
 							   nulls, state->bm_lov_heap, state->bm_lov_index,
 							   &lovBlock, &lovOffset, state->use_wal);
+				_bitmap_wrtbuf(metabuf);
 			}
 		}
 	}
 
 	buf_add_tid(rel, tidLocsBuffer, tidnum, state, lovBlock, lovOffset);
-	_bitmap_wrtbuf(metabuf);
 
 	CHECK_FOR_INTERRUPTS();
 	
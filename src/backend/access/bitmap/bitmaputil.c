@@ -547,6 +547,60 @@ fast_forward(uint32 nbatches, BMBatchWords **batches, BMBatchWords *result)
 	return batches[0]->nextread;
 }
 
+/*
+ * Skip a run of compressed zeros that starts at 'nextReadNo' in every batch,
+ * copying it to the result as a single fill word instead of one literal
+ * zero word per position.  Returns the number of words skipped, or 0 if some
+ * batch doesn't start with a zero fill word at that position.
+ */
+static uint64
+skip_common_zero_fills(uint32 nbatches, BMBatchWords **batches,
+					   BMBatchWords *result, uint64 nextReadNo)
+{
+	uint32		i;
+	BM_HRL_WORD	nskip = MAX_FILL_LENGTH;
+
+	for (i = 0; i < nbatches; i++)
+	{
+		BMBatchWords *bch = batches[i];
+		BM_HRL_WORD word;
+
+		_bitmap_findnextword(bch, nextReadNo);
+		if (bch->nwords == 0 || !CUR_WORD_IS_FILL(bch))
+			return 0;
+
+		word = bch->cwords[bch->startNo];
+		if (GET_FILL_BIT(word) != 0)
+			return 0;
+
+		nskip = Min(nskip, FILL_LENGTH(word));
+	}
+
+	if (nskip == 0)
+		return 0;
+
+	for (i = 0; i < nbatches; i++)
+	{
+		BMBatchWords *bch = batches[i];
+
+		if (FILL_LENGTH(bch->cwords[bch->startNo]) == nskip)
+		{
+			bch->startNo++;
+			bch->nwords--;
+		}
+		else
+			bch->cwords[bch->startNo] -= nskip;
+		bch->nwordsread += nskip;
+	}
+
+	result->hwords[result->nwords / BM_HRL_WORD_SIZE] |=
+		WORDNO_GET_HEADER_BIT(result->nwords);
+	result->cwords[result->nwords] = BM_MAKE_FILL_WORD(0, nskip);
+	result->nwords++;
+
+	return nskip;
+}
+
 /*
  * _bitmap_union() -- union 'numBatches' bitmaps
  *
@@ -580,6 +634,16 @@ _bitmap_union(BMBatchWords **batches, uint32 numBatches, BMBatchWords *result)
 		BM_HRL_WORD orWord = LITERAL_ALL_ZERO;
 		BM_HRL_WORD	word;
 		bool		orWordIsLiteral = true;
+		uint64		nskipped;
+
+		/* positions where no batch has a match are skipped in bulk */
+		nskipped = skip_common_zero_fills(numBatches, batches, result,
+										  nextReadNo);
+		if (nskipped > 0)
+		{
+			nextReadNo += nskipped;
+			continue;
+		}
 
 		for (batchNo = 0; batchNo < numBatches; batchNo++)
 		{
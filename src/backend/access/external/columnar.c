@@ -0,0 +1,751 @@
+/*-------------------------------------------------------------------------
+ *
+ * columnar.c
+ *	  Built-in binary columnar formatter for external tables
+ *
+ * columnar_out writes the rows of a writable external table, and columnar_in
+ * reads them back in a readable one:
+ *
+ *	FORMAT 'CUSTOM' (FORMATTER='columnar_out')
+ *	FORMAT 'CUSTOM' (FORMATTER='columnar_in')
+ *
+ * The data is a sequence of row groups. Each row group holds up to
+ * COLUMNAR_GROUP_ROWS rows, stored column by column:
+ *
+ *	magic				4 bytes, "GPCG"
+ *	length				int32, bytes in the rest of the row group
+ *	number of rows		int32
+ *	number of columns	int16
+ *	for each column:
+ *		type oid		int32
+ *		chunk length	int32
+ *		flags			int8, COLUMNAR_HAS_MINMAX if min and max follow
+ *		min, max		int32 length and value, each
+ *	for each column, its chunk:
+ *		for each row:	int32 length (-1 for NULL) and value
+ *
+ * All integers are in network byte order, and values are in the binary
+ * send/receive format of their type, like in COPY BINARY. So there is no
+ * text conversion on either side. Dropped columns are not stored, and the
+ * column types must match those of the reading table.
+ *
+ * The smallest and largest value of each chunk are recorded for types that
+ * have a default btree operator class. When reading, row groups whose min
+ * and max show that they can't pass the quals pushed down by the scan are
+ * skipped, and the columns that the scan doesn't use are not received.
+ *
+ * Copyright (c) 2016, Pivotal Software, Inc.
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include <arpa/inet.h>
+
+#include "access/fileam.h"
+#include "access/formatter.h"
+#include "access/heapam.h"
+#include "access/skey.h"
+#include "funcapi.h"
+#include "libpq/pqformat.h"
+#include "utils/datum.h"
+#include "utils/lsyscache.h"
+#include "utils/memutils.h"
+#include "utils/typcache.h"
+
+#define COLUMNAR_MAGIC			"GPCG"
+#define COLUMNAR_MAGIC_LEN		4
+/* magic and length, which are enough to know the size of a row group */
+#define COLUMNAR_HEADER_LEN		(COLUMNAR_MAGIC_LEN + 4)
+
+#define COLUMNAR_HAS_MINMAX		0x01
+
+/* a row group is finished at this many rows or bytes, whichever is first */
+#define COLUMNAR_GROUP_ROWS		65536
+#define COLUMNAR_GROUP_BYTES	(8 * 1024 * 1024)
+
+typedef struct ColumnarColumn
+{
+	int			attno;			/* index in the tuple descriptor */
+	Oid			typid;
+	int32		typmod;
+	int16		typlen;
+	bool		typbyval;
+	FmgrInfo	io_func;		/* send or receive function */
+	Oid			typioparam;		/* for the receive function */
+
+	/* min and max of the current row group, when writing or for quals */
+	bool		has_minmax;
+	Datum		min;
+	Datum		max;
+
+	/* writing */
+	FmgrInfo   *cmp_func;		/* btree comparison function, or NULL */
+	StringInfoData chunk;		/* values of the current row group */
+
+	/* reading */
+	bool		needed;			/* does the scan use the column? */
+	bool		has_quals;		/* are there quals on the column? */
+	int			chunk_len;
+	char	   *next;			/* next value in the chunk */
+	char	   *end;			/* end of the chunk */
+	char	   *value;			/* value of the current row */
+	int			value_len;
+} ColumnarColumn;
+
+/* a "column op constant" qual, with op a btree comparison of the column type */
+typedef struct ColumnarQual
+{
+	ColumnarColumn *col;
+	int			strategy;		/* btree strategy number of op */
+	Datum		value;
+	FmgrInfo   *cmp_func;		/* btree comparison function */
+} ColumnarQual;
+
+typedef struct ColumnarState
+{
+	int			ncolumns;		/* number of columns stored */
+	ColumnarColumn *columns;
+	Datum	   *values;
+	bool	   *nulls;
+	MemoryContext groupcxt;		/* data of the current row group */
+	int			nrows;			/* rows in the current row group */
+	int			currow;			/* reading: next row to return */
+	Size		group_bytes;	/* writing: bytes in the column chunks */
+	StringInfoData buf;			/* writing: the bytea we return */
+	List	   *quals;			/* reading: ColumnarQuals */
+} ColumnarState;
+
+static ColumnarState *columnar_init_state(FunctionCallInfo fcinfo, bool reading);
+static void columnar_update_minmax(ColumnarState *state, ColumnarColumn *col, Datum value);
+static void columnar_send_value(StringInfo buf, ColumnarColumn *col, Datum value);
+static void columnar_reset_buf(StringInfo buf);
+static bytea *columnar_finish_group(ColumnarState *state);
+static void columnar_init_quals(FunctionCallInfo fcinfo, ColumnarState *state);
+static void columnar_load_group(FunctionCallInfo fcinfo, ColumnarState *state,
+								char *data, int len);
+static bool columnar_group_may_match(ColumnarState *state);
+static Datum columnar_receive_value(ColumnarColumn *col, const char *data, int len);
+
+
+/*
+ * Set up the formatter state on the first call, in the memory context of the
+ * formatter function, which lasts as long as the scan or insert.
+ */
+static ColumnarState *
+columnar_init_state(FunctionCallInfo fcinfo, bool reading)
+{
+	TupleDesc	tupdesc = FORMATTER_GET_TUPDESC(fcinfo);
+	MemoryContext oldcxt;
+	ColumnarState *state;
+	int			i;
+
+	oldcxt = MemoryContextSwitchTo(fcinfo->flinfo->fn_mcxt);
+
+	state = (ColumnarState *) palloc0(sizeof(ColumnarState));
+	state->columns = (ColumnarColumn *) palloc0(tupdesc->natts * sizeof(ColumnarColumn));
+	state->values = (Datum *) palloc0(tupdesc->natts * sizeof(Datum));
+	state->nulls = (bool *) palloc(tupdesc->natts * sizeof(bool));
+	initStringInfo(&state->buf);
+	state->groupcxt = AllocSetContextCreate(fcinfo->flinfo->fn_mcxt,
+											"columnar row group",
+											ALLOCSET_DEFAULT_MINSIZE,
+											ALLOCSET_DEFAULT_INITSIZE,
+											ALLOCSET_DEFAULT_MAXSIZE);
+
+	for (i = 0; i < tupdesc->natts; i++)
+	{
+		Form_pg_attribute attr = tupdesc->attrs[i];
+		ColumnarColumn *col;
+		Oid			func;
+
+		/* dropped columns are NULL in every row, don't bother storing them */
+		state->nulls[i] = true;
+		if (attr->attisdropped)
+			continue;
+
+		col = &state->columns[state->ncolumns++];
+		col->attno = i;
+		col->typid = attr->atttypid;
+		col->typmod = attr->atttypmod;
+		get_typlenbyval(col->typid, &col->typlen, &col->typbyval);
+
+		if (reading)
+		{
+			bool	   *needed = FORMATTER_GET_NEEDED_COLS(fcinfo);
+
+			getTypeBinaryInputInfo(col->typid, &func, &col->typioparam);
+			col->needed = (needed == NULL || needed[i]);
+		}
+		else
+		{
+			TypeCacheEntry *typentry;
+			bool		isvarlena;
+
+			getTypeBinaryOutputInfo(col->typid, &func, &isvarlena);
+
+			typentry = lookup_type_cache(col->typid, TYPECACHE_CMP_PROC_FINFO);
+			if (OidIsValid(typentry->cmp_proc))
+				col->cmp_func = &typentry->cmp_proc_finfo;
+
+			initStringInfo(&col->chunk);
+		}
+		fmgr_info(func, &col->io_func);
+	}
+
+	if (reading)
+		columnar_init_quals(fcinfo, state);
+
+	MemoryContextSwitchTo(oldcxt);
+
+	return state;
+}
+
+/*
+ * Pick the quals that can be checked against the min and max of a column.
+ */
+static void
+columnar_init_quals(FunctionCallInfo fcinfo, ColumnarState *state)
+{
+	ListCell   *lc;
+
+	foreach(lc, FORMATTER_GET_QUALS(fcinfo))
+	{
+		OpExpr	   *op = (OpExpr *) lfirst(lc);
+		Var		   *var = (Var *) linitial(op->args);
+		Const	   *con = (Const *) lsecond(op->args);
+		ColumnarColumn *col = NULL;
+		TypeCacheEntry *typentry;
+		ColumnarQual *qual;
+		int			strategy;
+		int			i;
+
+		for (i = 0; i < state->ncolumns; i++)
+		{
+			if (state->columns[i].attno == var->varattno - 1)
+				col = &state->columns[i];
+		}
+		if (col == NULL || con->consttype != col->typid)
+			continue;
+
+		typentry = lookup_type_cache(col->typid,
+									 TYPECACHE_BTREE_OPFAMILY | TYPECACHE_CMP_PROC_FINFO);
+		if (!OidIsValid(typentry->btree_opf) || !OidIsValid(typentry->cmp_proc))
+			continue;
+		strategy = get_op_opfamily_strategy(op->opno, typentry->btree_opf);
+		if (strategy == 0)
+			continue;
+
+		qual = (ColumnarQual *) palloc(sizeof(ColumnarQual));
+		qual->col = col;
+		qual->strategy = strategy;
+		qual->value = datumCopy(con->constvalue, col->typbyval, col->typlen);
+		qual->cmp_func = &typentry->cmp_proc_finfo;
+		state->quals = lappend(state->quals, qual);
+
+		col->has_quals = true;
+	}
+}
+
+/*
+ * columnar_out -- add a row to the current row group
+ *
+ * Returns the encoded row group once it is full, and an empty bytea until
+ * then. At the end of the data, we are called once more with a NULL record,
+ * to return the last row group.
+ */
+Datum
+columnar_out(PG_FUNCTION_ARGS)
+{
+	ColumnarState *state;
+	HeapTupleHeader rec;
+	HeapTupleData tuple;
+	MemoryContext oldcxt;
+	int			i;
+
+	if (!CALLED_AS_FORMATTER(fcinfo))
+		elog(ERROR, "columnar_out: not called by format manager");
+
+	state = (ColumnarState *) FORMATTER_GET_USER_CTX(fcinfo);
+	if (state == NULL)
+	{
+		state = columnar_init_state(fcinfo, false);
+		FORMATTER_SET_USER_CTX(fcinfo, state);
+		FORMATTER_SET_NEEDS_FINAL_CALL(fcinfo);
+	}
+
+	if (PG_ARGISNULL(0))
+		PG_RETURN_BYTEA_P(columnar_finish_group(state));
+
+	rec = PG_GETARG_HEAPTUPLEHEADER(0);
+	tuple.t_len = HeapTupleHeaderGetDatumLength(rec);
+	ItemPointerSetInvalid(&(tuple.t_self));
+	tuple.t_data = rec;
+	heap_deform_tuple(&tuple, FORMATTER_GET_TUPDESC(fcinfo),
+					  state->values, state->nulls);
+
+	oldcxt = MemoryContextSwitchTo(FORMATTER_GET_PER_ROW_MEM_CTX(fcinfo));
+
+	for (i = 0; i < state->ncolumns; i++)
+	{
+		ColumnarColumn *col = &state->columns[i];
+		int			oldlen = col->chunk.len;
+
+		if (state->nulls[col->attno])
+			pq_sendint(&col->chunk, -1, 4);
+		else
+		{
+			Datum		value = state->values[col->attno];
+
+			columnar_send_value(&col->chunk, col, value);
+			if (col->cmp_func)
+				columnar_update_minmax(state, col, value);
+		}
+		state->group_bytes += col->chunk.len - oldlen;
+	}
+
+	MemoryContextSwitchTo(oldcxt);
+
+	state->nrows++;
+	if (state->nrows >= COLUMNAR_GROUP_ROWS ||
+		state->group_bytes >= COLUMNAR_GROUP_BYTES)
+		PG_RETURN_BYTEA_P(columnar_finish_group(state));
+
+	/* nothing to write yet */
+	columnar_reset_buf(&state->buf);
+	SET_VARSIZE(state->buf.data, VARHDRSZ);
+
+	PG_RETURN_BYTEA_P((bytea *) state->buf.data);
+}
+
+/*
+ * Remember a copy of the value if it is the smallest or largest of its chunk
+ * so far.
+ */
+static void
+columnar_update_minmax(ColumnarState *state, ColumnarColumn *col, Datum value)
+{
+	MemoryContext oldcxt;
+
+	if (col->has_minmax)
+	{
+		bool		is_min;
+
+		if (DatumGetInt32(FunctionCall2(col->cmp_func, value, col->min)) < 0)
+			is_min = true;
+		else if (DatumGetInt32(FunctionCall2(col->cmp_func, value, col->max)) > 0)
+			is_min = false;
+		else
+			return;
+
+		oldcxt = MemoryContextSwitchTo(state->groupcxt);
+		if (is_min)
+		{
+			if (!col->typbyval)
+				pfree(DatumGetPointer(col->min));
+			col->min = datumCopy(value, col->typbyval, col->typlen);
+		}
+		else
+		{
+			if (!col->typbyval)
+				pfree(DatumGetPointer(col->max));
+			col->max = datumCopy(value, col->typbyval, col->typlen);
+		}
+		MemoryContextSwitchTo(oldcxt);
+	}
+	else
+	{
+		oldcxt = MemoryContextSwitchTo(state->groupcxt);
+		col->min = datumCopy(value, col->typbyval, col->typlen);
+		col->max = datumCopy(value, col->typbyval, col->typlen);
+		col->has_minmax = true;
+		MemoryContextSwitchTo(oldcxt);
+	}
+}
+
+/*
+ * Append the length and binary form of a value.
+ */
+static void
+columnar_send_value(StringInfo buf, ColumnarColumn *col, Datum value)
+{
+	bytea	   *outputbytes = SendFunctionCall(&col->io_func, value);
+
+	pq_sendint(buf, VARSIZE(outputbytes) - VARHDRSZ, 4);
+	pq_sendbytes(buf, VARDATA(outputbytes), VARSIZE(outputbytes) - VARHDRSZ);
+	pfree(outputbytes);
+}
+
+/*
+ * Empty the output buffer, leaving room for the varlena header.
+ */
+static void
+columnar_reset_buf(StringInfo buf)
+{
+	resetStringInfo(buf);
+	enlargeStringInfo(buf, VARHDRSZ);
+	buf->len = VARHDRSZ;
+}
+
+/*
+ * Encode the current row group, and start a new one.
+ *
+ * The result is returned to fileam.c, which only copies it after resetting
+ * the per row memory context, so it is built in state->buf.
+ */
+static bytea *
+columnar_finish_group(ColumnarState *state)
+{
+	StringInfo	buf = &state->buf;
+	uint32		n32;
+	int			lenpos;
+	int			i;
+
+	columnar_reset_buf(buf);
+
+	if (state->nrows > 0)
+	{
+		appendBinaryStringInfo(buf, COLUMNAR_MAGIC, COLUMNAR_MAGIC_LEN);
+		lenpos = buf->len;
+		pq_sendint(buf, 0, 4);		/* filled in below */
+		pq_sendint(buf, state->nrows, 4);
+		pq_sendint(buf, state->ncolumns, 2);
+
+		for (i = 0; i < state->ncolumns; i++)
+		{
+			ColumnarColumn *col = &state->columns[i];
+
+			pq_sendint(buf, col->typid, 4);
+			pq_sendint(buf, col->chunk.len, 4);
+			pq_sendint(buf, col->has_minmax ? COLUMNAR_HAS_MINMAX : 0, 1);
+			if (col->has_minmax)
+			{
+				columnar_send_value(buf, col, col->min);
+				columnar_send_value(buf, col, col->max);
+			}
+		}
+
+		for (i = 0; i < state->ncolumns; i++)
+		{
+			ColumnarColumn *col = &state->columns[i];
+
+			appendBinaryStringInfo(buf, col->chunk.data, col->chunk.len);
+			resetStringInfo(&col->chunk);
+			col->has_minmax = false;
+		}
+
+		n32 = htonl((uint32) (buf->len - lenpos - 4));
+		memcpy(buf->data + lenpos, &n32, 4);
+	}
+
+	SET_VARSIZE(buf->data, buf->len);
+
+	MemoryContextReset(state->groupcxt);
+	state->nrows = 0;
+	state->group_bytes = 0;
+
+	return (bytea *) buf->data;
+}
+
+/*
+ * columnar_in -- return the next row
+ *
+ * The rows are decoded one at a time, from a copy of the current row group.
+ * The row group is consumed from the data buffer as a whole, so that a bad
+ * value only rejects its own row in single row error handling mode.
+ */
+Datum
+columnar_in(PG_FUNCTION_ARGS)
+{
+	ColumnarState *state;
+	HeapTuple	tuple;
+	MemoryContext oldcxt;
+	int			i;
+
+	if (!CALLED_AS_FORMATTER(fcinfo))
+		elog(ERROR, "columnar_in: not called by format manager");
+
+	state = (ColumnarState *) FORMATTER_GET_USER_CTX(fcinfo);
+	if (state == NULL)
+	{
+		state = columnar_init_state(fcinfo, true);
+		FORMATTER_SET_USER_CTX(fcinfo, state);
+	}
+
+	/* load row groups until one has rows that we can return */
+	while (state->currow >= state->nrows)
+	{
+		char	   *data = FORMATTER_GET_DATABUF(fcinfo) + FORMATTER_GET_DATACURSOR(fcinfo);
+		int			remaining = FORMATTER_GET_DATALEN(fcinfo) - FORMATTER_GET_DATACURSOR(fcinfo);
+		uint32		n32;
+		int			grouplen = 0;
+
+		if (remaining >= COLUMNAR_HEADER_LEN)
+		{
+			if (memcmp(data, COLUMNAR_MAGIC, COLUMNAR_MAGIC_LEN) != 0)
+			{
+				FORMATTER_SET_BAD_ROW_DATA(fcinfo, data, remaining);
+				ereport(ERROR,
+						(errcode(ERRCODE_BAD_COPY_FILE_FORMAT),
+						 errmsg("invalid columnar row group header")));
+			}
+			memcpy(&n32, data + COLUMNAR_MAGIC_LEN, 4);
+			n32 = ntohl(n32);
+			if (n32 >= MaxAllocSize - COLUMNAR_HEADER_LEN)
+			{
+				FORMATTER_SET_BAD_ROW_DATA(fcinfo, data, remaining);
+				ereport(ERROR,
+						(errcode(ERRCODE_BAD_COPY_FILE_FORMAT),
+						 errmsg("invalid columnar row group length %u", n32)));
+			}
+			grouplen = COLUMNAR_HEADER_LEN + (int) n32;
+		}
+
+		if (remaining < COLUMNAR_HEADER_LEN || remaining < grouplen)
+		{
+			if (FORMATTER_GET_SAW_EOF(fcinfo) && remaining > 0)
+			{
+				FORMATTER_SET_BAD_ROW_DATA(fcinfo, data, remaining);
+				ereport(ERROR,
+						(errcode(ERRCODE_BAD_COPY_FILE_FORMAT),
+						 errmsg("incomplete columnar row group at end of data")));
+			}
+			FORMATTER_RETURN_NOTIFICATION(fcinfo, FMT_NEED_MORE_DATA);
+		}
+
+		FORMATTER_SET_DATACURSOR(fcinfo, FORMATTER_GET_DATACURSOR(fcinfo) + grouplen);
+		columnar_load_group(fcinfo, state, data + COLUMNAR_HEADER_LEN,
+							grouplen - COLUMNAR_HEADER_LEN);
+	}
+
+	/*
+	 * Step over the values of the row first, so that we go on with the next
+	 * row if one of them can't be received.
+	 */
+	oldcxt = MemoryContextSwitchTo(FORMATTER_GET_PER_ROW_MEM_CTX(fcinfo));
+
+	state->currow++;
+	for (i = 0; i < state->ncolumns; i++)
+	{
+		ColumnarColumn *col = &state->columns[i];
+		uint32		n32;
+		int			len;
+
+		if (col->end - col->next < 4)
+			ereport(ERROR,
+					(errcode(ERRCODE_BAD_COPY_FILE_FORMAT),
+					 errmsg("columnar data for column %d is truncated",
+							col->attno + 1)));
+		memcpy(&n32, col->next, 4);
+		len = (int) ntohl(n32);
+		col->next += 4;
+
+		if (len == -1)
+		{
+			state->nulls[col->attno] = true;
+			continue;
+		}
+		if (len < 0 || len > col->end - col->next)
+			ereport(ERROR,
+					(errcode(ERRCODE_BAD_COPY_FILE_FORMAT),
+					 errmsg("invalid length %d in columnar data for column %d",
+							len, col->attno + 1)));
+
+		state->nulls[col->attno] = false;
+		col->value = col->next;
+		col->value_len = len;
+		col->next += len;
+	}
+
+	for (i = 0; i < state->ncolumns; i++)
+	{
+		ColumnarColumn *col = &state->columns[i];
+
+		/* the scan doesn't use this column, leave it NULL */
+		if (!col->needed)
+			state->nulls[col->attno] = true;
+
+		if (state->nulls[col->attno])
+			continue;
+
+		state->values[col->attno] = columnar_receive_value(col, col->value,
+														   col->value_len);
+	}
+
+	MemoryContextSwitchTo(oldcxt);
+
+	tuple = heap_form_tuple(FORMATTER_GET_TUPDESC(fcinfo), state->values, state->nulls);
+	FORMATTER_SET_TUPLE(fcinfo, tuple);
+
+	FORMATTER_RETURN_TUPLE(tuple);
+}
+
+/*
+ * Keep a copy of a row group, and point each column at its chunk.
+ *
+ * state->nrows stays 0 until the whole group has been checked. In single row
+ * error handling mode the scan goes on after an error here, and it must not
+ * read rows from a group that was only partly loaded.
+ */
+static void
+columnar_load_group(FunctionCallInfo fcinfo, ColumnarState *state,
+					char *data, int len)
+{
+	StringInfoData group;
+	char	   *chunk;
+	int			nrows;
+	int			ncolumns;
+	int			i;
+
+	MemoryContextReset(state->groupcxt);
+	state->nrows = 0;
+	state->currow = 0;
+
+	group.data = MemoryContextAlloc(state->groupcxt, len + 1);
+	memcpy(group.data, data, len);
+	group.data[len] = '\0';
+	group.len = len;
+	group.maxlen = len + 1;
+	group.cursor = 0;
+
+	nrows = pq_getmsgint(&group, 4);
+	ncolumns = pq_getmsgint(&group, 2);
+	if (nrows < 0)
+		ereport(ERROR,
+				(errcode(ERRCODE_BAD_COPY_FILE_FORMAT),
+				 errmsg("invalid number of rows %d in columnar data", nrows)));
+	if (ncolumns != state->ncolumns)
+		ereport(ERROR,
+				(errcode(ERRCODE_BAD_COPY_FILE_FORMAT),
+				 errmsg("columnar data has %d columns, but the table has %d",
+						ncolumns, state->ncolumns)));
+
+	/* column directory */
+	for (i = 0; i < state->ncolumns; i++)
+	{
+		ColumnarColumn *col = &state->columns[i];
+		Oid			typid = (Oid) pq_getmsgint(&group, 4);
+		int			flags;
+
+		col->chunk_len = pq_getmsgint(&group, 4);
+		flags = pq_getmsgint(&group, 1);
+
+		if (typid != col->typid)
+			ereport(ERROR,
+					(errcode(ERRCODE_DATATYPE_MISMATCH),
+					 errmsg("columnar data for column %d has type %u, but the table has type %u",
+							col->attno + 1, typid, col->typid)));
+
+		col->has_minmax = false;
+		if (flags & COLUMNAR_HAS_MINMAX)
+		{
+			int			minlen = pq_getmsgint(&group, 4);
+			const char *min = pq_getmsgbytes(&group, minlen);
+			int			maxlen = pq_getmsgint(&group, 4);
+			const char *max = pq_getmsgbytes(&group, maxlen);
+
+			/* only needed to check quals */
+			if (col->has_quals)
+			{
+				MemoryContext oldcxt = MemoryContextSwitchTo(state->groupcxt);
+
+				col->min = columnar_receive_value(col, min, minlen);
+				col->max = columnar_receive_value(col, max, maxlen);
+				col->has_minmax = true;
+				MemoryContextSwitchTo(oldcxt);
+			}
+		}
+	}
+
+	chunk = group.data + group.cursor;
+	for (i = 0; i < state->ncolumns; i++)
+	{
+		ColumnarColumn *col = &state->columns[i];
+		if (col->chunk_len < 0 || col->chunk_len > group.data + group.len - chunk)
+			ereport(ERROR,
+					(errcode(ERRCODE_BAD_COPY_FILE_FORMAT),
+					 errmsg("columnar data for column %d is truncated",
+							col->attno + 1)));
+		col->next = chunk;
+		col->end = chunk + col->chunk_len;
+		chunk += col->chunk_len;
+	}
+
+	/* if no row of the group can pass the quals, leave it empty */
+	if (columnar_group_may_match(state))
+		state->nrows = nrows;
+}
+
+/*
+ * Check the quals against the min and max of the current row group.
+ * Returns false if no row of the group can pass them.
+ */
+static bool
+columnar_group_may_match(ColumnarState *state)
+{
+	ListCell   *lc;
+
+	foreach(lc, state->quals)
+	{
+		ColumnarQual *qual = (ColumnarQual *) lfirst(lc);
+		ColumnarColumn *col = qual->col;
+		int32		cmp_min;
+		int32		cmp_max;
+
+		if (!col->has_minmax)
+			continue;
+
+		cmp_min = DatumGetInt32(FunctionCall2(qual->cmp_func, col->min, qual->value));
+		cmp_max = DatumGetInt32(FunctionCall2(qual->cmp_func, col->max, qual->value));
+
+		switch (qual->strategy)
+		{
+			case BTLessStrategyNumber:
+				if (cmp_min >= 0)
+					return false;
+				break;
+			case BTLessEqualStrategyNumber:
+				if (cmp_min > 0)
+					return false;
+				break;
+			case BTEqualStrategyNumber:
+				if (cmp_min > 0 || cmp_max < 0)
+					return false;
+				break;
+			case BTGreaterEqualStrategyNumber:
+				if (cmp_max < 0)
+					return false;
+				break;
+			case BTGreaterStrategyNumber:
+				if (cmp_max <= 0)
+					return false;
+				break;
+		}
+	}
+
+	return true;
+}
+
+/*
+ * Convert a value from its binary format, in the current memory context.
+ */
+static Datum
+columnar_receive_value(ColumnarColumn *col, const char *data, int len)
+{
+	StringInfoData buf;
+	Datum		result;
+
+	/* receive functions expect a terminated buffer */
+	initStringInfo(&buf);
+	appendBinaryStringInfo(&buf, data, len);
+
+	result = ReceiveFunctionCall(&col->io_func, &buf, col->typioparam, col->typmod);
+	if (buf.cursor != buf.len)
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_BINARY_REPRESENTATION),
+				 errmsg("incorrect binary data format in column %d",
+						col->attno + 1)));
+	pfree(buf.data);
+
+	return result;
+}
@@ -127,7 +127,8 @@ static MemoryContext g_dataSourceCtx = NULL;
 FileScanDesc
 external_beginscan(Relation relation, Index scanrelid, uint32 scancounter,
 			   List *uriList, List *fmtOpts, char fmtType, bool isMasterOnly,
-			   int rejLimit, bool rejLimitInRows, Oid fmterrtbl, int encoding)
+			   int rejLimit, bool rejLimitInRows, Oid fmterrtbl, int encoding,
+			   bool *neededCols, List *quals)
 {
 	FileScanDesc scan;
 	TupleDesc	tupDesc = NULL;
@@ -159,6 +160,20 @@ external_beginscan(Relation relation, Index scanrelid, uint32 scancounter,
 	scan->fs_noop = false;
 	scan->fs_file = NULL;
 	scan->fs_formatter = NULL;
+
+	/*
+	 * With single row error handling, every column of every row has to be
+	 * converted, so that which rows are rejected doesn't depend on the target
+	 * list and the quals of the query. Don't let the scan, the formatter or
+	 * the protocol skip anything then.
+	 */
+	if (rejLimit != -1)
+	{
+		neededCols = NULL;
+		quals = NIL;
+	}
+	scan->fs_neededCols = neededCols;
+	scan->fs_quals = quals;
 	scan->fs_constraintExprs = NULL;
 	if (relation->rd_att->constr != NULL && relation->rd_att->constr->num_check > 0)
 	{
@@ -278,6 +293,8 @@ external_beginscan(Relation relation, Index scanrelid, uint32 scancounter,
 		scan->fs_formatter = (FormatterData *) palloc0 (sizeof(FormatterData));
 		initStringInfo(&scan->fs_formatter->fmt_databuf);
 		scan->fs_formatter->fmt_perrow_ctx = scan->fs_pstate->rowcontext;
+		scan->fs_formatter->fmt_needed_cols = neededCols;
+		scan->fs_formatter->fmt_quals = quals;
 	}
 
 	/* Set up callback to identify error line number */
@@ -687,8 +704,12 @@ external_insert(ExternalInsertDesc extInsertDesc, HeapTuple instup)
 		CopyOneCustomRowTo(pstate, b);
 	}
 
-	/* Write the data into the external source */
-	external_senddata((URL_FILE*)extInsertDesc->ext_file, pstate);
+	/*
+	 * Write the data into the external source. A custom formatter may
+	 * return nothing while it accumulates rows.
+	 */
+	if (pstate->fe_msgbuf->len > 0)
+		external_senddata((URL_FILE*)extInsertDesc->ext_file, pstate);
 
 	/* Reset our buffer to start clean next round */
 	pstate->fe_msgbuf->len = 0;
@@ -707,6 +728,40 @@ external_insert(ExternalInsertDesc extInsertDesc, HeapTuple instup)
 void
 external_insert_finish(ExternalInsertDesc extInsertDesc)
 {
+	FormatterData  *formatter = extInsertDesc->ext_formatter_data;
+
+	/*
+	 * Let a custom formatter that accumulates rows write out the rest
+	 */
+	if (extInsertDesc->ext_file && formatter && formatter->fmt_needs_final_call)
+	{
+		CopyStateData  *pstate = extInsertDesc->ext_pstate;
+		FunctionCallInfoData fcinfo;
+		Datum			d;
+
+		FunctionCallPrepareFormatter(&fcinfo,
+									 1,
+									 pstate,
+									 formatter,
+									 extInsertDesc->ext_rel,
+									 extInsertDesc->ext_tupDesc,
+									 pstate->out_functions,
+									 NULL);
+		fcinfo.arg[0] = (Datum) 0;
+		fcinfo.argnull[0] = true;
+
+		d = FunctionCallInvoke(&fcinfo);
+		MemoryContextReset(formatter->fmt_perrow_ctx);
+
+		if (!fcinfo.isnull)
+		{
+			CopyOneCustomRowTo(pstate, DatumGetByteaP(d));
+			if (pstate->fe_msgbuf->len > 0)
+				external_senddata((URL_FILE*)extInsertDesc->ext_file, pstate);
+			pstate->fe_msgbuf->len = 0;
+			pstate->fe_msgbuf->data[0] = '\0';
+		}
+	}
 
 	/*
 	 * Close the external source
@@ -880,6 +935,13 @@ static DataLineStatus parse_next_line(FileScanDesc scan)
 				char   *string;
 				bool	isnull;
 
+				/* The scan doesn't use this column, don't convert it */
+				if (scan->fs_neededCols && !scan->fs_neededCols[m])
+				{
+					scan->nulls[m] = true;
+					continue;
+				}
+
 				string = pstate->attribute_buf.data + pstate->attr_offsets[m];
 
 				if(!scan->nulls[m])
@@ -1580,14 +1642,21 @@ open_external_readable_source(FileScanDesc scan)
 				 errmsg("could not open \"%s\" for reading: %d %s",
 						scan->fs_uri, response_code, response_string)));
 	}
-	else
+
+	/*
+	 * Get a global reference to the file pointer, so we can free it from
+	 * AbortTransaction in the case of an error or abort. We don't use it
+	 * for anything else.
+	 */
+	g_dataSource = scan->fs_file;
+
+	/* let a custom protocol skip data that the scan doesn't need */
+	if (((URL_FILE *) scan->fs_file)->type == CFTYPE_CUSTOM)
 	{
-		/*
-		 * Get a global reference to the file pointer, so we can free it from
-		 * AbortTransaction in the case of an error or abort. We don't use it
-		 * for anything else.
-		 */
-		g_dataSource = scan->fs_file;
+		ExtProtocol extprotocol = ((URL_FILE *) scan->fs_file)->u.custom.extprotocol;
+
+		extprotocol->prot_needed_cols = scan->fs_neededCols;
+		extprotocol->prot_quals = scan->fs_quals;
 	}
 }
 
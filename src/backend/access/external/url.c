@@ -1673,6 +1673,8 @@ url_fopen(char *url, bool forwrite, extvar_t *ev, CopyState pstate, int *respons
 		file->u.custom.extprotocol->prot_last_call = false;
 		file->u.custom.extprotocol->prot_url = NULL;
 		file->u.custom.extprotocol->prot_databuf = NULL;
+		file->u.custom.extprotocol->prot_needed_cols = NULL;
+		file->u.custom.extprotocol->prot_quals = NIL;
 
 		pfree(prot_name);
 	}
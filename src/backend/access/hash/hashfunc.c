@@ -1097,6 +1097,27 @@ hash_any(register const unsigned char *k, register int keylen)
 #endif
 }
 
+/*
+ * hash_any64() -- hash a variable-length key into a 64-bit value
+ *
+ * Same as hash_any(), but also returns the secondary hash value computed
+ * by lookup3 in the upper half, for callers that need more than 32 bits.
+ */
+uint64
+hash_any64(const unsigned char *k, int keylen)
+{
+	uint32		pc = 3923095;
+	uint32		pb = 0;
+
+#ifndef WORDS_BIGENDIAN
+	hashlittle2(k, keylen, &pc, &pb);
+#else
+	hashbig2(k, keylen, &pc, &pb);
+#endif
+
+	return (uint64) pc + (((uint64) pb) << 32);
+}
+
 /*
  * hash_uint32() -- hash a 32-bit value
  *
@@ -1043,8 +1043,10 @@ RecordTransactionCommit(void)
 	int			nchildren;
 	TransactionId *children;
 	bool		isDtxPrepared = 0;
+	bool		isQEOnePhaseCommit;
 	bool		omitCommitRecordForDirtyQEReader;
 	TMGXACT_LOG gxact_log;
+	xl_xact_one_phase_commit onephase;
 	XLogRecPtr	recptr = {0,0};
 
 	/* Like in CommitTransaction(), treat a QE reader as if there was no XID */
@@ -1072,6 +1074,16 @@ RecordTransactionCommit(void)
 	nchildren = xactGetCommittedChildren(&children);
 
 	isDtxPrepared = isPreparedDtxTransaction();
+
+	/*
+	 * A QE writer only commits without PREPARE when the QD tells it to commit
+	 * one-phase, as the only segment of the distributed transaction.
+	 */
+	isQEOnePhaseCommit =
+		((DistributedTransactionContext == DTX_CONTEXT_QE_TWO_PHASE_EXPLICIT_WRITER ||
+		  DistributedTransactionContext == DTX_CONTEXT_QE_TWO_PHASE_IMPLICIT_WRITER) &&
+		 MyProc->localDistribXactData.state != LOCALDISTRIBXACT_STATE_NONE);
+
 	omitCommitRecordForDirtyQEReader = false;
 	if (markXidCommitted)
 	{
@@ -1211,6 +1223,17 @@ RecordTransactionCommit(void)
 			rdata[3].buffer = InvalidBuffer;
 			lastrdata = 3;
 		}
+		else if (isQEOnePhaseCommit)
+		{
+			onephase.distribTimeStamp = MyProc->localDistribXactData.distribTimeStamp;
+			onephase.distribXid = MyProc->localDistribXactData.distribXid;
+
+			rdata[lastrdata].next = &(rdata[3]);
+			rdata[3].data = (char *) &onephase;
+			rdata[3].len = sizeof(onephase);
+			rdata[3].buffer = InvalidBuffer;
+			lastrdata = 3;
+		}
 		rdata[lastrdata].next = NULL;
 
 		if (isDtxPrepared)
@@ -1221,6 +1244,10 @@ RecordTransactionCommit(void)
 
 			insertedDistributedCommitted();
 		}
+		else if (isQEOnePhaseCommit)
+		{
+			recptr = XLogInsert(RM_XACT_ID, XLOG_XACT_ONE_PHASE_COMMIT, rdata);
+		}
 		else
 		{
 			recptr = XLogInsert(RM_XACT_ID, XLOG_XACT_COMMIT, rdata);
@@ -1313,6 +1340,12 @@ RecordTransactionCommit(void)
 										getDtxStartTime(),
 										getDistributedTransactionId(),
 										/* isRedo */ false);
+			else if (isQEOnePhaseCommit)
+				DistributedLog_SetCommitted(
+										xid,
+										MyProc->localDistribXactData.distribTimeStamp,
+										MyProc->localDistribXactData.distribXid,
+										/* isRedo */ false);
 
 			TransactionIdCommit(xid);
 			/* to avoid race conditions, the parent must commit first */
@@ -1336,6 +1369,13 @@ RecordTransactionCommit(void)
 		 */
 		if (markXidCommitted)
 		{
+			if (isQEOnePhaseCommit)
+				DistributedLog_SetCommitted(
+										xid,
+										MyProc->localDistribXactData.distribTimeStamp,
+										MyProc->localDistribXactData.distribXid,
+										/* isRedo */ false);
+
 			TransactionIdAsyncCommit(xid, XactLastRecEnd);
 			/* to avoid race conditions, the parent must commit first */
 			TransactionIdAsyncCommitTree(nchildren, children, XactLastRecEnd);
@@ -6785,6 +6825,49 @@ xact_redo_distributed_commit(xl_xact_commit *xlrec, TransactionId xid)
 	redoDistributedCommitRecord(gxact_log);
 }
 
+static void
+xact_redo_one_phase_commit(xl_xact_commit *xlrec, TransactionId xid)
+{
+	xl_xact_one_phase_commit onephase;
+	uint8	   *data;
+	TransactionId *sub_xids;
+	int			i;
+
+	/*
+	 * Make room in the DistributedLog, if necessary.
+	 */
+	if (TransactionIdFollowsOrEquals(xid,
+									 ShmemVariableCache->nextXid))
+	{
+		ShmemVariableCache->nextXid = xid;
+		TransactionIdAdvance(ShmemVariableCache->nextXid);
+	}
+
+	data = xlrec->data;
+	sub_xids = (TransactionId *)
+		&data[PersistentEndXactRec_DeserializeLen(data,
+												  xlrec->persistentCommitObjectCount)];
+	memcpy(&onephase, &sub_xids[xlrec->nsubxacts], sizeof(onephase));
+
+	/*
+	 * Mark the distributed transaction committed before we update the CLOG
+	 * in xact_redo_commit, as xact_redo_distributed_commit does.
+	 */
+	DistributedLog_SetCommitted(
+							xid,
+							onephase.distribTimeStamp,
+							onephase.distribXid,
+							/* isRedo */ true);
+	for (i = 0; i < xlrec->nsubxacts; i++)
+		DistributedLog_SetCommitted(
+								sub_xids[i],
+								onephase.distribTimeStamp,
+								onephase.distribXid,
+								/* isRedo */ true);
+
+	xact_redo_commit(xlrec, xid);
+}
+
 static void
 xact_redo_abort(xl_xact_abort *xlrec, TransactionId xid)
 {
@@ -6882,6 +6965,12 @@ xact_redo(XLogRecPtr beginLoc __attribute__((unused)), XLogRecPtr lsn __attribut
 
 		xact_redo_distributed_forget(xlrec, record->xl_xid);
 	}
+	else if (info == XLOG_XACT_ONE_PHASE_COMMIT)
+	{
+		xl_xact_commit *xlrec = (xl_xact_commit *) XLogRecGetData(record);
+
+		xact_redo_one_phase_commit(xlrec, record->xl_xid);
+	}
 	else
 		elog(PANIC, "xact_redo: unknown op code %u", info);
 }
@@ -7006,7 +7095,8 @@ xact_redo_get_info(
 		*infoKind = XACT_INFOKIND_ABORT;
 		*xid = xlrec->xid;
 	}
-	else if (info == XLOG_XACT_DISTRIBUTED_COMMIT)
+	else if (info == XLOG_XACT_DISTRIBUTED_COMMIT ||
+			 info == XLOG_XACT_ONE_PHASE_COMMIT)
 	{
 		xl_xact_commit *xlrec = (xl_xact_commit *) XLogRecGetData(record);
 
@@ -7105,6 +7195,18 @@ xact_desc_distributed_commit(StringInfo buf, xl_xact_commit *xlrec)
 	descDistributedCommitRecord(buf, gxact_log);
 }
 
+static void
+xact_desc_one_phase_commit(StringInfo buf, xl_xact_commit *xlrec)
+{
+	xl_xact_one_phase_commit onephase;
+
+	/* the distributed transaction follows the regular commit information */
+	memcpy(&onephase, xact_desc_commit(buf, xlrec), sizeof(onephase));
+
+	appendStringInfo(buf, "; distributed xid %u, timestamp %u",
+					 onephase.distribXid, onephase.distribTimeStamp);
+}
+
 static void
 xact_desc_distributed_forget(StringInfo buf, xl_xact_distributed_forget *xlrec)
 {
@@ -7218,6 +7320,13 @@ xact_desc(StringInfo buf, XLogRecPtr beginLoc, XLogRecord *record)
 		appendStringInfo(buf, "distributed forget ");
 		xact_desc_distributed_forget(buf, xlrec);
 	}
+	else if (info == XLOG_XACT_ONE_PHASE_COMMIT)
+	{
+		xl_xact_commit *xlrec = (xl_xact_commit *) rec;
+
+		appendStringInfo(buf, "one-phase commit: ");
+		xact_desc_one_phase_commit(buf, xlrec);
+	}
 	else
 		appendStringInfo(buf, "UNKNOWN");
 }
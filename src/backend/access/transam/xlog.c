@@ -5962,7 +5962,8 @@ recoveryStopsHere(XLogRecord *record, bool *includeThis)
 	if (record->xl_rmid != RM_XACT_ID)
 		return false;
 	record_info = record->xl_info & ~XLR_INFO_MASK;
-	if (record_info == XLOG_XACT_COMMIT)
+	if (record_info == XLOG_XACT_COMMIT ||
+		record_info == XLOG_XACT_ONE_PHASE_COMMIT)
 	{
 		xl_xact_commit *recordXactCommitData;
 
@@ -6022,7 +6023,8 @@ recoveryStopsHere(XLogRecord *record, bool *includeThis)
 		recoveryStopTime = recordXtime;
 		recoveryStopAfter = *includeThis;
 
-		if (record_info == XLOG_XACT_COMMIT)
+		if (record_info == XLOG_XACT_COMMIT ||
+			record_info == XLOG_XACT_ONE_PHASE_COMMIT)
 		{
 			if (recoveryStopAfter)
 				ereport(LOG,
@@ -28,6 +28,9 @@
 #include "utils/faultinjector.h"
 #include "utils/memutils.h"
 
+static void cdbCopyFlushSegment(CdbCopy *c, int target_seg);
+static bool cdbCopyWaitForSegment(PGconn *conn, int maxQueued);
+
 /*
  * Create a cdbCopy object that includes all the cdb
  * information and state needed by the backend COPY.
@@ -53,6 +56,7 @@ makeCdbCopy(bool is_copy_in)
 	initStringInfo(&(c->err_msg));
 	initStringInfo(&(c->err_context));
 	initStringInfo(&(c->copy_out_buf));	
+	c->copy_in_bufs = NULL;
 	
 	/* init total_segs */
 	c->total_segs = getgpsegmentCount();
@@ -72,6 +76,14 @@ makeCdbCopy(bool is_copy_in)
 	/* init gangs */
 	c->primary_writer = AllocateWriterGang();
 	
+	/* init per segment send buffers for copy in */
+	if (c->copy_in)
+	{
+		c->copy_in_bufs = (StringInfoData *) palloc(c->total_segs * sizeof(StringInfoData));
+		for (seg = 0; seg < c->total_segs; seg++)
+			initStringInfo(&c->copy_in_bufs[seg]);
+	}
+
 	/* init seg list for copy out */
 	if (!c->copy_in)
 	{
@@ -189,14 +201,17 @@ cdbCopyStart(CdbCopy *c, char *copyCmd)
 /*
  * sends data to a copy command on a specific segment (usually
  * the hash result of the data value).
+ *
+ * The data is only appended to the segment's send buffer here. It is passed
+ * on to libpq once COPYIN_CHUNK_SIZE bytes have piled up, or by cdbCopyEnd.
+ * Because of that, an I/O error may be reported by a later call than the one
+ * that sent the offending data.
  */
 void
 cdbCopySendData(CdbCopy *c, int target_seg, const char *buffer,
 				int nbytes)
 {
-	SegmentDatabaseDescriptor *q;
-	Gang	   *gp;
-	int			result;
+	StringInfo	buf;
 
 	/* clean err message */
 	c->err_msg.len = 0;
@@ -207,12 +222,52 @@ cdbCopySendData(CdbCopy *c, int target_seg, const char *buffer,
 		 * in the code above. I didn't do it because it's broken right now
 		 */
 
-	gp = c->primary_writer;
+	Assert(c->copy_in_bufs != NULL);
+	Assert(target_seg >= 0 && target_seg < c->total_segs);
 
-	q = getSegmentDescriptorFromGang(gp, target_seg);
-		
-	/* transmit the COPY data */
-	result = PQputCopyData(q->conn, buffer, nbytes);
+	buf = &c->copy_in_bufs[target_seg];
+	appendBinaryStringInfo(buf, buffer, nbytes);
+
+	if (buf->len >= COPYIN_CHUNK_SIZE)
+		cdbCopyFlushSegment(c, target_seg);
+}
+
+/*
+ * hands the buffered data of a segment over to libpq.
+ *
+ * Sending row by row on a blocking connection stalls the whole COPY as soon
+ * as the socket buffer of any one segment is full. Instead, the chunk is only
+ * queued in the connection's output buffer, and libpq sends what the socket
+ * takes right away. We wait for the segment only when it is more than
+ * COPYIN_BACKLOG_SIZE bytes behind, so that all segments keep receiving data
+ * while the QD parses the next rows.
+ */
+static void
+cdbCopyFlushSegment(CdbCopy *c, int target_seg)
+{
+	StringInfo	buf = &c->copy_in_bufs[target_seg];
+	SegmentDatabaseDescriptor *q;
+	int			result;
+
+	if (buf->len == 0)
+		return;
+
+	q = getSegmentDescriptorFromGang(c->primary_writer, target_seg);
+
+	/*
+	 * transmit the COPY data, without waiting for the socket. The connection
+	 * stays in nonblocking mode until cdbCopyEnd.
+	 */
+	if (!PQisnonblocking(q->conn) && PQsetnonblocking(q->conn, true) != 0)
+		result = -1;
+	else
+		result = PQputCopyData(q->conn, buf->data, buf->len);
+
+	/* too far behind, wait until the segment has caught up */
+	if (result == 1 && !cdbCopyWaitForSegment(q->conn, COPYIN_BACKLOG_SIZE))
+		result = -1;
+
+	resetStringInfo(buf);
 
 	if (result != 1)
 	{
@@ -230,6 +285,23 @@ cdbCopySendData(CdbCopy *c, int target_seg, const char *buffer,
 	}
 }
 
+/*
+ * waits until no more than maxQueued bytes of COPY data are left in the
+ * output buffer of a nonblocking segment connection. Returns false if the
+ * connection failed.
+ */
+static bool
+cdbCopyWaitForSegment(PGconn *conn, int maxQueued)
+{
+	while (conn->outCount > maxQueued)
+	{
+		if (pqWait(false, true, conn) != 0 || pqFlush(conn) < 0)
+			return false;
+	}
+
+	return true;
+}
+
 /*
  * gets a chunk of rows of data from a copy command.
  * returns boolean true if done. Caller should still
@@ -624,9 +696,24 @@ cdbCopyEnd(CdbCopy *c)
 	/* results from each segment */
 	results = (int *)palloc0(sizeof(int) * size);
 
+	/* send the rows still buffered, unless a segment has already failed */
+	if (c->copy_in_bufs != NULL && !c->io_errors)
+	{
+		for (seg = 0; seg < c->total_segs; seg++)
+			cdbCopyFlushSegment(c, seg);
+	}
+
 	for (seg = 0; seg < size; seg++)
 	{
 		q = &db_descriptors[seg];
+
+		/*
+		 * send what is still queued, and put the connection back into
+		 * blocking mode. If that fails, so will PQputCopyEnd.
+		 */
+		if (PQisnonblocking(q->conn) && cdbCopyWaitForSegment(q->conn, 0))
+			PQsetnonblocking(q->conn, false);
+
 		elog(DEBUG1, "PQputCopyEnd seg %d    ",q->segindex);
 		/* end this COPY command */
 		results[seg] = PQputCopyEnd(q->conn, NULL);
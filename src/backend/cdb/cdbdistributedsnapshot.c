@@ -15,6 +15,10 @@
 #include "cdb/cdbvars.h"
 #include "utils/tqual.h"
 
+static DistributedSnapshotCommitted DistributedSnapshotWithLocalMapping_CommittedTestInternal(
+	DistributedSnapshotWithLocalMapping		*dslm,
+	TransactionId 							localXid);
+
 /*
  * DistributedSnapshotWithLocalMapping_CommittedTest
  *		Is the given XID still-in-progress according to the
@@ -29,27 +33,42 @@ DistributedSnapshotWithLocalMapping_CommittedTest(
 	DistributedSnapshotWithLocalMapping		*dslm,
 	TransactionId 							localXid,
 	bool									isXmax)
+{
+	DistributedSnapshotXidCacheEntry *cacheEntry;
+	DistributedSnapshotCommitted	result;
+
+	/*
+	 * The answer for a committed xid doesn't change for the life of the
+	 * snapshot, and scans tend to see the same few xids over and over.
+	 */
+	cacheEntry = &dslm->xidCache[localXid & (DISTRIBUTEDSNAPSHOT_XID_CACHE_SIZE - 1)];
+	if (cacheEntry->localXid == localXid &&
+		TransactionIdIsNormal(localXid))
+		return cacheEntry->committed;
+
+	result = DistributedSnapshotWithLocalMapping_CommittedTestInternal(dslm, localXid);
+
+	cacheEntry->localXid = localXid;
+	cacheEntry->committed = result;
+
+	return result;
+}
+
+/*
+ * The committed test proper, when the result isn't cached.
+ */
+static DistributedSnapshotCommitted 
+DistributedSnapshotWithLocalMapping_CommittedTestInternal(
+	DistributedSnapshotWithLocalMapping		*dslm,
+	TransactionId 							localXid)
 {
 	DistributedSnapshotHeader *header = &dslm->header;
 	DistributedSnapshotMapEntry *inProgressEntryArray = dslm->inProgressEntryArray;
-	int32							count;
-	uint32							i;
+	int32							low;
+	int32							high;
 	bool							found;
 	DistributedTransactionId		distribXid = InvalidDistributedTransactionId;
 
-	count = header->count;
-
-	/*
-	 * Checking the distributed committed log can be expensive, so
-	 * make a scan through our distributed snapshot looking for a
-	 * possible corresponding local xid...
-	 */
-	for (i = 0; i < count; i++)
-	{
-		if (localXid == inProgressEntryArray[i].localXid)
-			return DISTRIBUTEDSNAPSHOT_COMMITTED_INPROGRESS;
-	}
-
 	/*
 	 * Is this local xid in a process-local cache we maintain?
 	 */
@@ -149,19 +168,28 @@ DistributedSnapshotWithLocalMapping_CommittedTest(
 		return DISTRIBUTEDSNAPSHOT_COMMITTED_INPROGRESS;
 	}
 
-	for (i = 0; i < count; i++)
+	/* The in-progress array is sorted by distributed xid */
+	low = 0;
+	high = header->count - 1;
+	while (low <= high)
 	{
-		if (distribXid == inProgressEntryArray[i].distribXid)
+		int32		mid = low + (high - low) / 2;
+
+		if (distribXid == inProgressEntryArray[mid].distribXid)
 		{
 			/*
-			 * Save the relationship to the local xid so we may avoid
-			 * checking the distributed committed log in a subsequent check.
+			 * Save the relationship to the local xid, for those looking at
+			 * the array.
 			 */
-			if (inProgressEntryArray[i].localXid == InvalidTransactionId)
-				inProgressEntryArray[i].localXid = localXid;
-			
+			if (inProgressEntryArray[mid].localXid == InvalidTransactionId)
+				inProgressEntryArray[mid].localXid = localXid;
+
 			return DISTRIBUTEDSNAPSHOT_COMMITTED_INPROGRESS;
 		}
+		else if (distribXid < inProgressEntryArray[mid].distribXid)
+			high = mid - 1;
+		else
+			low = mid + 1;
 	}
 
 	/*
@@ -170,6 +198,18 @@ DistributedSnapshotWithLocalMapping_CommittedTest(
 	return DISTRIBUTEDSNAPSHOT_COMMITTED_VISIBLE;
 }
 
+/*
+ * Forget the committed test results cached with a distributed snapshot.
+ * Call whenever the snapshot is filled in anew.
+ */
+void
+DistributedSnapshotWithLocalMapping_ResetXidCache(
+	DistributedSnapshotWithLocalMapping		*dslm)
+{
+	/* InvalidTransactionId is never looked up */
+	MemSet(dslm->xidCache, 0, sizeof(dslm->xidCache));
+}
+
 /*
  * Reset all fields except header.maxCount and the malloc'd pointer
  * for inProgressXidArray.
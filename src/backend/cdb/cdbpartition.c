@@ -47,6 +47,7 @@
 #include "utils/datum.h"
 #include "utils/elog.h"
 #include "utils/fmgroids.h"
+#include "utils/inval.h"
 #include "utils/lsyscache.h"
 #include "utils/memutils.h"
 #include "utils/syscache.h"
@@ -2277,13 +2278,161 @@ RelationBuildPartitionDesc(Relation rel, bool inctemplate)
 	return RelationBuildPartitionDescByOid(RelationGetRelid(rel), inctemplate);
 }
 
+/*
+ * Backend-local cache of whole partition descriptors, keyed by the root
+ * relation and whether template rules are included.  Building the tree for
+ * a table with thousands of parts means scanning pg_partition_rule and
+ * parsing the boundary expressions of every rule, which dominates planning
+ * time for such tables; the cached tree is copied out instead.
+ *
+ * Any change to pg_partition or pg_partition_rule flushes the whole cache,
+ * since partitioning DDL is rare.  A relcache invalidation drops the
+ * entries of that relation, so entries of dropped tables don't pile up.
+ */
+typedef struct PartitionDescCacheKey
+{
+	Oid			relid;
+	bool		inctemplate;
+} PartitionDescCacheKey;
+
+typedef struct PartitionDescCacheEntry
+{
+	PartitionDescCacheKey key;	/* hash key, must be first */
+	PartitionNode *pnode;		/* NULL if the relation isn't partitioned */
+	MemoryContext mcxt;			/* holds pnode, or NULL */
+} PartitionDescCacheEntry;
+
+static HTAB *PartitionDescCache = NULL;
+
+/* bumped by every flush, to notice invalidations during a build */
+static uint32 PartitionDescCacheFlushCount = 0;
+
+static void
+PartitionDescCacheRemoveEntry(PartitionDescCacheEntry *entry)
+{
+	if (entry->mcxt)
+		MemoryContextDelete(entry->mcxt);
+
+	hash_search(PartitionDescCache, &entry->key, HASH_REMOVE, NULL);
+}
+
+static void
+PartitionDescCacheSyscacheCallback(Datum arg, int cacheid, ItemPointer tuplePtr,
+								   uint32 hashValue)
+{
+	HASH_SEQ_STATUS status;
+	PartitionDescCacheEntry *entry;
+
+	PartitionDescCacheFlushCount++;
+
+	hash_seq_init(&status, PartitionDescCache);
+	while ((entry = (PartitionDescCacheEntry *) hash_seq_search(&status)) != NULL)
+		PartitionDescCacheRemoveEntry(entry);
+}
+
+static void
+PartitionDescCacheRelcacheCallback(Datum arg, Oid relid)
+{
+	HASH_SEQ_STATUS status;
+	PartitionDescCacheEntry *entry;
+
+	PartitionDescCacheFlushCount++;
+
+	hash_seq_init(&status, PartitionDescCache);
+	while ((entry = (PartitionDescCacheEntry *) hash_seq_search(&status)) != NULL)
+	{
+		if (relid == InvalidOid || entry->key.relid == relid)
+			PartitionDescCacheRemoveEntry(entry);
+	}
+}
+
+static void
+InitPartitionDescCache(void)
+{
+	HASHCTL		ctl;
+
+	if (!CacheMemoryContext)
+		CreateCacheMemoryContext();
+
+	MemSet(&ctl, 0, sizeof(ctl));
+	ctl.keysize = sizeof(PartitionDescCacheKey);
+	ctl.entrysize = sizeof(PartitionDescCacheEntry);
+	ctl.hash = tag_hash;
+	ctl.hcxt = CacheMemoryContext;
+	PartitionDescCache = hash_create("Partition descriptor cache", 64,
+									 &ctl, HASH_ELEM | HASH_FUNCTION | HASH_CONTEXT);
+
+	CacheRegisterSyscacheCallback(PARTOID, PartitionDescCacheSyscacheCallback,
+								  (Datum) 0);
+	CacheRegisterSyscacheCallback(PARTRULEOID, PartitionDescCacheSyscacheCallback,
+								  (Datum) 0);
+	CacheRegisterRelcacheCallback(PartitionDescCacheRelcacheCallback,
+								  (Datum) 0);
+}
+
+/*
+ * Build the whole PartitionNode tree of a partitioned table, or return NULL
+ * if it isn't one.  The result is allocated in the current memory context
+ * and belongs to the caller, who may scribble on it.
+ */
 PartitionNode *
 RelationBuildPartitionDescByOid(Oid relid, bool inctemplate)
 {
+	PartitionDescCacheKey key;
+	PartitionDescCacheEntry *entry;
 	PartitionNode *n;
+	PartitionNode *cached = NULL;
+	MemoryContext mcxt = NULL;
+	uint32		flushcount;
+	bool		found;
+
+	/* get_parts returns NULL on segments anyway */
+	if (Gp_segment != -1)
+		return NULL;
+
+	if (PartitionDescCache == NULL)
+		InitPartitionDescCache();
+
+	MemSet(&key, 0, sizeof(key));
+	key.relid = relid;
+	key.inctemplate = inctemplate;
+
+	entry = (PartitionDescCacheEntry *) hash_search(PartitionDescCache, &key,
+													HASH_FIND, NULL);
+	if (entry)
+		return entry->pnode ? (PartitionNode *) copyObject(entry->pnode) : NULL;
+
+	flushcount = PartitionDescCacheFlushCount;
 
 	n = get_parts(relid, 0, 0, inctemplate, true /*includesubparts*/);
 
+	/*
+	 * The catalog scans may have processed invalidations that the tree we
+	 * just read doesn't reflect; don't remember it in that case.
+	 */
+	if (flushcount != PartitionDescCacheFlushCount)
+		return n;
+
+	if (n)
+	{
+		MemoryContext oldcxt;
+
+		mcxt = AllocSetContextCreate(CacheMemoryContext,
+									 "Partition descriptor",
+									 ALLOCSET_SMALL_MINSIZE,
+									 ALLOCSET_SMALL_INITSIZE,
+									 ALLOCSET_DEFAULT_MAXSIZE);
+		oldcxt = MemoryContextSwitchTo(mcxt);
+		cached = (PartitionNode *) copyObject(n);
+		MemoryContextSwitchTo(oldcxt);
+	}
+
+	entry = (PartitionDescCacheEntry *) hash_search(PartitionDescCache, &key,
+													HASH_ENTER, &found);
+	Assert(!found);
+	entry->pnode = cached;
+	entry->mcxt = mcxt;
+
 	return n;
 }
 
@@ -2964,8 +3113,7 @@ rel_get_leaf_children_relids(Oid relid)
 	{
 		PartitionNode *pn;
 
-		pn = get_parts(relid, 0 /*level*/, 0 /*parent*/, false /*inctemplate*/,
-					   true /*includesubparts*/);
+		pn = RelationBuildPartitionDescByOid(relid, false /*inctemplate*/);
 		leaf_relids = all_leaf_partition_relids(pn);
 		pfree(pn);
 	}
@@ -3048,8 +3196,7 @@ countLeafPartTables(Oid rootOid)
 {
 	Assert (rel_is_partitioned(rootOid));
 
-	PartitionNode *pn = get_parts(rootOid, 0 /* level */, 0 /* parent */, false /* inctemplate */,
-								  true /* include subparts */);
+	PartitionNode *pn = RelationBuildPartitionDescByOid(rootOid, false /* inctemplate */);
 
 	List *lRelOids = all_leaf_partition_relids(pn);
 	Assert (list_length(lRelOids) > 0);
@@ -3273,8 +3420,7 @@ static List *rel_get_part_path(Oid relid)
 	if (!OidIsValid(masteroid))
 		return NIL;
 
-	/* call the guts of RelationBuildPartitionDesc */
-	pNode = get_parts(masteroid, 0, 0, false, true /*includesubparts*/);
+	pNode = RelationBuildPartitionDescByOid(masteroid, false /*inctemplate*/);
 
 	if (!pNode)
 	{
@@ -4043,6 +4189,57 @@ range_test(Datum tupval, Oid ruleTypeOid, Oid exprTypeOid, PartitionRangeState *
 	return 0;
 }
 
+/* entry of PartitionRangeState.rules_hash */
+typedef struct PartitionRangeRulesEntry
+{
+	PartitionNode *partnode;	/* hash key */
+	PartitionRule **rules;
+} PartitionRangeRulesEntry;
+
+/*
+ * Return the rules of a lower level range partition node as an array.
+ *
+ * Each parent partition has its own node at the lower levels, so unlike the
+ * top level, the array is kept in a hash table by node.  They are allocated
+ * in the current memory context, which should live as long as rs.
+ */
+static PartitionRule **
+range_state_get_rules(PartitionRangeState *rs, PartitionNode *partnode)
+{
+	PartitionRangeRulesEntry *entry;
+	bool		found;
+
+	if (rs->rules_hash == NULL)
+	{
+		HASHCTL		ctl;
+
+		MemSet(&ctl, 0, sizeof(ctl));
+		ctl.keysize = sizeof(PartitionNode *);
+		ctl.entrysize = sizeof(PartitionRangeRulesEntry);
+		ctl.hash = tag_hash;
+		ctl.hcxt = CurrentMemoryContext;
+
+		rs->rules_hash = hash_create("Partition Range Rules",
+									 16,
+									 &ctl,
+									 HASH_ELEM | HASH_FUNCTION | HASH_CONTEXT);
+	}
+
+	entry = hash_search(rs->rules_hash, &partnode, HASH_ENTER, &found);
+	if (!found)
+	{
+		ListCell   *lc;
+		int			i = 0;
+
+		entry->rules = palloc(sizeof(PartitionRule *) *
+							  list_length(partnode->rules));
+		foreach(lc, partnode->rules)
+			entry->rules[i++] = (PartitionRule *) lfirst(lc);
+	}
+
+	return entry->rules;
+}
+
 /*
  * Given a partition specific part, a tuple as represented by values and isnull and
  * a list of rules, return an Oid in *foundOid or the next set of rules.
@@ -4061,6 +4258,7 @@ selectRangePartition(PartitionNode *partnode, Datum *values, bool *isnull,
 	PartitionRule *rule = NULL;
 	PartitionNode *pNode = NULL;
 	PartitionRangeState *rs = NULL;
+	PartitionRule **rulesArray;
 	MemoryContext oldcxt = NULL;
 
 	Assert(partnode->part->parkind == 'r');
@@ -4111,13 +4309,54 @@ selectRangePartition(PartitionNode *partnode, Datum *values, bool *isnull,
 		}
 		else
 			rs->rules = NULL;
+
+		rs->rules_hash = NULL;
+		rs->last_node = NULL;
+		rs->last_rule = 0;
 	}
 
+	/*
+	 * The state is kept for the whole statement if we have accessMethods, so
+	 * it is worth unrolling the rules of the lower levels too.
+	 */
+	if (partnode->part->parlevel == 0)
+		rulesArray = rs->rules;
+	else if (accessMethods)
+		rulesArray = range_state_get_rules(rs, partnode);
+	else
+		rulesArray = NULL;
+
 	if (accessMethods && accessMethods->part_cxt)
 		oldcxt = MemoryContextSwitchTo(accessMethods->part_cxt);
 
 	*foundOid = InvalidOid;
 
+	/*
+	 * Rows tend to come in runs for the same partition, so try the rule that
+	 * matched last time before searching.  Only for single column keys, whose
+	 * ranges don't overlap.
+	 */
+	if (rs->last_node == partnode && pSearch == NULL)
+	{
+		AttrNumber attno = partnode->part->paratts[0];
+		Oid ruleTypeOid = tupdesc->attrs[attno - 1]->atttypid;
+
+		Assert(partnode->part->parnatts == 1 && rulesArray != NULL);
+
+		rule = rulesArray[rs->last_rule];
+		if (!isnull[attno - 1] &&
+			range_test(values[attno - 1], ruleTypeOid,
+					   OidIsValid(exprTypeOid) ? exprTypeOid : ruleTypeOid,
+					   rs, 0, rule) == 0)
+		{
+			*foundOid = rule->parchildrelid;
+			*prule = rule;
+
+			pNode = rule->children;
+			goto l_fin_range;
+		}
+	}
+
 	/*
 	 * Use a binary search to try and pin point the region within the set of
 	 * rules where the rule is. If the partition is across a single column,
@@ -4147,8 +4386,8 @@ selectRangePartition(PartitionNode *partnode, Datum *values, bool *isnull,
 
 		mid = low + (high - low)/2;
 
-		if (rs->rules)
-			rule = rs->rules[mid];
+		if (rulesArray)
+			rule = rulesArray[mid];
 		else
 			rule = (PartitionRule *)list_nth(rules, mid);
 
@@ -4200,6 +4439,12 @@ selectRangePartition(PartitionNode *partnode, Datum *values, bool *isnull,
 			*foundOid = rule->parchildrelid;
 			*prule = rule;
 
+			if (rulesArray)
+			{
+				rs->last_node = partnode;
+				rs->last_rule = mid;
+			}
+
 			pNode = rule->children;
 			goto l_fin_range;
 		}
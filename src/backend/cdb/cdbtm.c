@@ -146,6 +146,7 @@ static bool doDispatchDtxProtocolCommand(DtxProtocolCommand dtxProtocolCommand,
 static void doPrepareTransaction(void);
 static void doInsertForgetCommitted(void);
 static void doNotifyingCommitPrepared(void);
+static void doNotifyingOnePhaseCommit(void);
 static void doNotifyingAbort(void);
 static bool doNotifyCommittedInDoubt(char *gid);
 static void doAbortInDoubt(char *gid);
@@ -157,6 +158,7 @@ static void ReplayRedoFromUtilityMode(void);
 static void RemoveRedoUtilityModeFile(void);
 static void performDtxProtocolCommitPrepared(const char *gid, bool raiseErrorIfNotFound);
 static void performDtxProtocolAbortPrepared(const char *gid, bool raiseErrorIfNotFound);
+static void performDtxProtocolCommitOnePhase(const char *gid);
 
 extern void resetSessionForPrimaryGangLoss(bool resetSession);
 extern void CheckForResetSession(void);
@@ -582,6 +584,9 @@ doDispatchSubtransactionInternalCmd(DtxProtocolCommand cmdType)
 		{
 			setCurrentGxactState(DTX_STATE_ACTIVE_DISTRIBUTED);
 		}
+
+		/* the subtransaction is started on all segments */
+		currentGxact->directTransaction = false;
 		releaseTmLock();
 	}
 		
@@ -816,6 +821,88 @@ doNotifyingCommitPrepared(void)
 	LWLockRelease(ProcArrayLock);
 }
 
+/*
+ * Commit a transaction that only one segment took part in with a single
+ * COMMIT to that segment.  Its local commit decides the outcome, so there
+ * is nothing to prepare, and no distributed commit or FORGET COMMITTED
+ * record to write.
+ */
+static void
+doNotifyingOnePhaseCommit(void)
+{
+	bool succeeded;
+	bool badGangs;
+
+	CdbDispatchDirectDesc direct=default_dispatch_direct_desc;
+
+	elog(DTM_DEBUG5, "doNotifyingOnePhaseCommit entering in state = %s", DtxStateToString(currentGxact->state));
+
+	/* Don't allow a cancel while we're dispatching our commit. */
+	HOLD_INTERRUPTS();
+
+	copyDirectDispatchFromTransaction(&direct);
+	Assert(direct.directed_dispatch);
+
+	getTmLock();
+	Assert(currentGxact->state == DTX_STATE_ACTIVE_DISTRIBUTED);
+	setCurrentGxactState( DTX_STATE_ONE_PHASE_COMMIT );
+	releaseTmLock();
+
+	succeeded = doDispatchDtxProtocolCommand(DTX_PROTOCOL_COMMAND_COMMIT_ONEPHASE, /* flags */ 0,
+											 currentGxact->gid, currentGxact->gxid,
+											 &badGangs, /* raiseError */ false,
+											 &direct, NULL, 0);
+
+	RESUME_INTERRUPTS();
+
+	if (!succeeded && !badGangs)
+	{
+		/*
+		 * The segment answered with an ERROR, so it aborted the transaction
+		 * instead of committing it.  Report the rollback; rollbackDtxTransaction
+		 * sends the abort in case the segment still has the transaction open.
+		 */
+		ereport(ERROR,
+				(errcode(ERRCODE_TRANSACTION_ROLLBACK),
+				 errmsg("The distributed transaction 'Commit One-Phase' failed for gid = %s on segment %d.",
+						currentGxact->gid, currentGxact->directTransactionContentId)));
+	}
+	else if (!succeeded)
+	{
+		/*
+		 * We lost the connection after sending the commit.  The segment may
+		 * have committed before that, and there is no prepared transaction
+		 * left there to retry or abort, so we can't tell the outcome.  Don't
+		 * report it as rolled back: warn that it is in doubt, and drop the
+		 * gang.
+		 */
+		ereport(WARNING,
+				(errcode(ERRCODE_TRANSACTION_RESOLUTION_UNKNOWN),
+				 errmsg("The distributed transaction 'Commit One-Phase' failed, its outcome is in doubt for gid = %s on segment %d.",
+						currentGxact->gid, currentGxact->directTransactionContentId)));
+
+		elog(NOTICE, "Releasing segworker group.");
+		DisconnectAndDestroyAllGangs(true);
+
+		/*
+		 * This call will at a minimum change the session id so we will
+		 * not have SharedSnapshotAdd colissions.
+		 */
+		CheckForResetSession();
+	}
+	else
+	{
+		elog(DTM_DEBUG5, "The distributed transaction 'Commit One-Phase' succeeded to segment %d for gid = %s.",
+			 currentGxact->directTransactionContentId, currentGxact->gid);
+	}
+
+	/*
+	 * Either way, the segment's commit or abort decides the outcome, so new
+	 * distributed snapshots must not wait for the transaction any more.
+	 */
+	releaseGxact();
+}
+
 static void
 doNotifyingAbort(void)
 {
@@ -1182,6 +1269,17 @@ prepareDtxTransaction(void)
 
 	Assert(currentGxact->state == DTX_STATE_ACTIVE_DISTRIBUTED);
 
+	/*
+	 * If only one segment took part, and we have no local changes to commit
+	 * along with it, that segment can commit on its own.
+	 */
+	if (currentGxact->directTransaction &&
+		!TransactionIdIsValid(GetTopTransactionIdIfAny()))
+	{
+		doNotifyingOnePhaseCommit();
+		return;
+	}
+
 	/*
 	 * Broadcast PREPARE TRANSACTION to segments.
 	 */
@@ -1223,6 +1321,15 @@ rollbackDtxTransaction(void)
 		setCurrentGxactState( DTX_STATE_NOTIFYING_ABORT_NO_PREPARED );
 		break;
 
+	case DTX_STATE_ONE_PHASE_COMMIT:
+		/*
+		 * The segment reported an error for the commit, or an error was
+		 * raised while dispatching it.  If the segment did commit after
+		 * all, there is nothing left there for the abort to do.
+		 */
+		setCurrentGxactState( DTX_STATE_NOTIFYING_ABORT_NO_PREPARED );
+		break;
+
 	case DTX_STATE_PREPARING:
 		if (currentGxact->badPrepareGangs)
 		{
@@ -2589,6 +2696,8 @@ createDtxSnapshot(
 	distribSnapshotWithLocalMapping->header.xmax = xmax;
 	distribSnapshotWithLocalMapping->header.count = count;
 
+	DistributedSnapshotWithLocalMapping_ResetXidCache(distribSnapshotWithLocalMapping);
+
 	if (xmin < currentGxact->xminDistributedSnapshot)
 		currentGxact->xminDistributedSnapshot = xmin;
 
@@ -4032,6 +4141,32 @@ performDtxProtocolCommitPrepared(const char *gid, bool raiseErrorIfNotFound)
 	finishDistributedTransactionContext("performDtxProtocolCommitPrepared -- Commit Prepared", false);
 }
 
+/**
+ * On the QE, commit the transaction without a first phase, when it is the
+ * only one of the distributed transaction.
+ */
+static void
+performDtxProtocolCommitOnePhase(const char *gid)
+{
+	StartTransactionCommand();
+
+	elog(DTM_DEBUG5, "performDtxProtocolCommand going to call EndTransactionBlock for distributed transaction (id = '%s')", gid);
+	if (!EndTransactionBlock())
+	{
+		elog(ERROR, "One-phase commit of distributed transaction %s failed", gid);
+		return;
+	}
+
+	/*
+	 * Calling CommitTransactionCommand will cause the actual COMMIT work to
+	 * be performed.  CommitTransaction also leaves the distributed
+	 * transaction context.
+	 */
+	CommitTransactionCommand();
+
+	elog(DTM_DEBUG5, "One-phase commit of distributed transaction succeeded (id = '%s')", gid);
+}
+
 /**
  * On the QD, run the Abort Prepared operation.
  */
@@ -4148,6 +4283,38 @@ performDtxProtocolCommand(DtxProtocolCommand dtxProtocolCommand,
 			}
 			break;
 
+		case DTX_PROTOCOL_COMMAND_COMMIT_ONEPHASE:
+			switch (DistributedTransactionContext)
+			{
+				case DTX_CONTEXT_LOCAL_ONLY:
+					/*
+					 * Spontaneously aborted while we were back at the QD?
+					 */
+					elog(ERROR, "Distributed transaction %s not found", gid);
+					break;
+
+				case DTX_CONTEXT_QE_TWO_PHASE_EXPLICIT_WRITER:
+				case DTX_CONTEXT_QE_TWO_PHASE_IMPLICIT_WRITER:
+					performDtxProtocolCommitOnePhase(gid);
+					break;
+
+				case DTX_CONTEXT_QD_DISTRIBUTED_CAPABLE:
+				case DTX_CONTEXT_QD_RETRY_PHASE_2:
+				case DTX_CONTEXT_QE_PREPARED:
+				case DTX_CONTEXT_QE_FINISH_PREPARED:
+				case DTX_CONTEXT_QE_ENTRY_DB_SINGLETON:
+				case DTX_CONTEXT_QE_READER:
+				case DTX_CONTEXT_QE_AUTO_COMMIT_IMPLICIT:
+					elog(FATAL, "Unexpected segment distribute transaction context: '%s'",
+						 DtxContextToString(DistributedTransactionContext));
+
+				default:
+					elog(PANIC, "Unexpected segment distribute transaction context value: %d",
+						 (int) DistributedTransactionContext);
+					break;
+			}
+			break;
+
 		case DTX_PROTOCOL_COMMAND_ABORT_SOME_PREPARED:
 			switch (DistributedTransactionContext)
 			{
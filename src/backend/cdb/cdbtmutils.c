@@ -77,6 +77,7 @@ char* DtxStateToString(DtxState state)
 		case DTX_STATE_RETRY_COMMIT_PREPARED: return "Retry Commit Prepared";
 		case DTX_STATE_RETRY_ABORT_PREPARED: return "Retry Abort Prepared";
 		case DTX_STATE_CRASH_COMMITTED: return "Crash Committed";
+		case DTX_STATE_ONE_PHASE_COMMIT: return "One-Phase Commit";
 		default: return "Unknown";
 	}
 }
@@ -99,6 +100,7 @@ char* DtxProtocolCommandToString(DtxProtocolCommand command)
 		case DTX_PROTOCOL_COMMAND_SUBTRANSACTION_BEGIN_INTERNAL: return " Begin Internal Subtransaction";
 		case DTX_PROTOCOL_COMMAND_SUBTRANSACTION_RELEASE_INTERNAL: return "Release Current Subtransaction";
 		case DTX_PROTOCOL_COMMAND_SUBTRANSACTION_ROLLBACK_INTERNAL: return "Rollback Current Subtransaction";
+		case DTX_PROTOCOL_COMMAND_COMMIT_ONEPHASE: return "Distributed Commit (One-Phase)";
 	}
 
 	return "Unknown";
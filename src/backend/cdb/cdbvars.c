@@ -87,6 +87,12 @@ int			gp_connections_per_thread;	/* How many libpq connections are
 int			gp_cached_gang_threshold;	/* How many gangs to keep around from
 										 * stmt to stmt. */
 
+int			gp_warm_reader_gangs;		/* How many idle reader gangs to
+										 * keep ready between stmts. */
+
+int			gp_dispatch_send_threads;	/* How many threads the async
+										 * dispatcher uses to send plans */
+
 int			Gp_segment = UNDEF_SEGMENT; /* What content this QE is handling. */
 
 bool		Gp_write_shared_snapshot;	/* tell the writer QE to write the
@@ -272,6 +278,9 @@ int			gp_hashagg_spillbatch_max = 0;
 /* hash join to use bloom filter: default to 0, means not used */
 int			gp_hashjoin_bloomfilter = 0;
 
+/* per-tuple expression contexts are arenas rather than AllocSets */
+bool		gp_enable_per_tuple_arena = false;
+
 /* Analyzing aid */
 int			gp_motion_slice_noop = 0;
 #ifdef ENABLE_LTRACE
@@ -40,6 +40,12 @@
  */
 #define DISPATCH_WAIT_CANCEL_TIMEOUT_MSEC 100
 
+/*
+ * Poll timeout of the helper threads pushing staged queries, kept short so
+ * that they notice a pending interrupt promptly.
+ */
+#define DISPATCH_SEND_THREAD_POLL_TIMEOUT_MSEC 100
+
 typedef struct CdbDispatchCmdAsync
 {
 
@@ -70,8 +76,35 @@ typedef struct CdbDispatchCmdAsync
 	char *query_text;
 	int query_text_len;
 
+	/*
+	 * If true, dispatchToGang only stages the query text on each connection,
+	 * and cdbdisp_waitDispatchFinish_async pushes all of them using
+	 * gp_dispatch_send_threads helper threads.
+	 */
+	bool stageSends;
+
 }   CdbDispatchCmdAsync;
 
+/*
+ * Parameters of one helper thread pushing staged queries, see
+ * pushStagedQueries.
+ */
+typedef struct DispatchSendThreadParms
+{
+	/* the range of dispatchResultPtrArray owned by this thread */
+	struct CdbDispatchResult **dispatchResultPtrArray;
+	int count;
+
+	/* pollfd array of size count, allocated by the main thread */
+	struct pollfd *fds;
+
+	/* index into dispatchResultPtrArray of a failed connection, or -1 */
+	int failedIndex;
+
+	pthread_t thread;
+	bool thread_valid;
+} DispatchSendThreadParms;
+
 
 static void *
 cdbdisp_makeDispatchParams_async(int maxSlices, char *queryText, int len);
@@ -105,7 +138,14 @@ DispatcherInternalFuncs DispatcherAsyncFuncs =
 static void
 dispatchCommand(CdbDispatchResult * dispatchResult,
 				const char *query_text,
-				int query_text_len);
+				int query_text_len,
+				bool stageOnly);
+
+static void
+pushStagedQueries(CdbDispatchCmdAsync *pParms);
+
+static void *
+thread_PushStagedQueries(void *arg);
 
 static void
 checkDispatchResult(CdbDispatcherState *ds,
@@ -149,6 +189,13 @@ cdbdisp_waitDispatchFinish_async(struct CdbDispatcherState *ds)
 	CdbDispatchCmdAsync *pParms = (CdbDispatchCmdAsync*)ds->dispatchParams;
 	int dispatchCount = pParms->dispatchCount;
 
+	/*
+	 * Push the staged queries in parallel first; the loop below then only
+	 * has to deal with whatever the helper threads left behind.
+	 */
+	if (pParms->stageSends)
+		pushStagedQueries(pParms);
+
 	fds = (struct pollfd *) palloc(dispatchCount * sizeof(struct pollfd));
 
 	while(true)
@@ -264,7 +311,8 @@ cdbdisp_dispatchToGang_async(struct CdbDispatcherState *ds,
 		}
 		pParms->dispatchResultPtrArray[pParms->dispatchCount++] = qeResult;
 
-		dispatchCommand(qeResult, pParms->query_text, pParms->query_text_len);
+		dispatchCommand(qeResult, pParms->query_text, pParms->query_text_len,
+						pParms->stageSends);
 	}
 }
 
@@ -321,6 +369,7 @@ cdbdisp_makeDispatchParams_async(int maxSlices, char *queryText, int len)
 	pParms->waitMode = DISPATCH_WAIT_NONE;
 	pParms->query_text = queryText;
 	pParms->query_text_len = len;
+	pParms->stageSends = (gp_dispatch_send_threads > 1);
 
 	return (void*)pParms;
 }
@@ -471,15 +520,20 @@ checkDispatchResult(CdbDispatcherState *ds,
 
 /*
  * Helper function that actually kicks off the command on the libpq connection.
+ *
+ * If stageOnly is true, the command is only queued on the connection, and
+ * the caller must push it out later, see pushStagedQueries.
  */
 static void
 dispatchCommand(CdbDispatchResult * dispatchResult,
 				const char *query_text,
-				int query_text_len)
+				int query_text_len,
+				bool stageOnly)
 {
 	TimestampTz beforeSend = 0;
 	long secs;
 	int	usecs;
+	int ret;
 
 	if (DEBUG1 >= log_min_messages)
 		beforeSend = GetCurrentTimestamp();
@@ -487,7 +541,12 @@ dispatchCommand(CdbDispatchResult * dispatchResult,
 	/*
 	 * Submit the command asynchronously.
 	 */
-	if (PQsendGpQuery_shared(dispatchResult->segdbDesc->conn, (char *) query_text, query_text_len, true) == 0)
+	if (stageOnly)
+		ret = PQstageGpQuery_shared(dispatchResult->segdbDesc->conn, (char *) query_text, query_text_len);
+	else
+		ret = PQsendGpQuery_shared(dispatchResult->segdbDesc->conn, (char *) query_text, query_text_len, true);
+
+	if (ret == 0)
 	{
 		char *msg = PQerrorMessage(dispatchResult->segdbDesc->conn);
 		dispatchResult->stillRunning = false;
@@ -516,6 +575,157 @@ dispatchCommand(CdbDispatchResult * dispatchResult,
 	ELOG_DISPATCHER_DEBUG("Command dispatched to QE (%s)", dispatchResult->segdbDesc->whoami);
 }
 
+/*
+ * Push the query text staged by dispatchCommand to all dispatched QEs using
+ * up to gp_dispatch_send_threads helper threads, each of which owns a
+ * contiguous range of the connections. With hundreds of segments, copying
+ * the (potentially large) query into every socket is what dominates the
+ * dispatch time, and this spreads it over several CPUs.
+ *
+ * This is best effort: a helper thread stops at a pending interrupt, and
+ * anything left unsent is finished by the single-threaded loop in
+ * cdbdisp_waitDispatchFinish_async. Send failures are reported here, after
+ * all helper threads have been joined.
+ */
+static void
+pushStagedQueries(CdbDispatchCmdAsync *pParms)
+{
+	DispatchSendThreadParms *threadParms;
+	int dispatchCount = pParms->dispatchCount;
+	int nthreads;
+	int perThread;
+	int i;
+
+	nthreads = Min(gp_dispatch_send_threads, dispatchCount);
+	if (nthreads <= 1)
+		return;
+
+	perThread = (dispatchCount + nthreads - 1) / nthreads;
+	threadParms = (DispatchSendThreadParms *) palloc0(nthreads * sizeof(DispatchSendThreadParms));
+
+	for (i = 0; i < nthreads; i++)
+	{
+		DispatchSendThreadParms *tp = &threadParms[i];
+		int begin = i * perThread;
+
+		tp->failedIndex = -1;
+		tp->thread_valid = false;
+
+		if (begin >= dispatchCount)
+			break;
+
+		tp->dispatchResultPtrArray = pParms->dispatchResultPtrArray + begin;
+		tp->count = Min(perThread, dispatchCount - begin);
+		tp->fds = (struct pollfd *) palloc(tp->count * sizeof(struct pollfd));
+
+		/*
+		 * If we cannot get a thread, the connections of this range are
+		 * simply pushed by the caller.
+		 */
+		if (gp_pthread_create(&tp->thread, thread_PushStagedQueries, tp, "pushStagedQueries") == 0)
+			tp->thread_valid = true;
+	}
+
+	for (i = 0; i < nthreads; i++)
+	{
+		DispatchSendThreadParms *tp = &threadParms[i];
+
+		if (tp->thread_valid)
+		{
+			pthread_join(tp->thread, NULL);
+			tp->thread_valid = false;
+		}
+	}
+
+	for (i = 0; i < nthreads; i++)
+	{
+		DispatchSendThreadParms *tp = &threadParms[i];
+		CdbDispatchResult *qeResult;
+		PGconn *conn;
+		char *msg;
+
+		if (tp->failedIndex < 0)
+			continue;
+
+		qeResult = tp->dispatchResultPtrArray[tp->failedIndex];
+		conn = qeResult->segdbDesc->conn;
+
+		pqHandleSendFailure(conn);
+		msg = PQerrorMessage(conn);
+
+		qeResult->stillRunning = false;
+		ereport(ERROR,
+				(errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+				 errmsg("Command could not be dispatch to segment %s: %s", qeResult->segdbDesc->whoami, msg ? msg : "unknown error")));
+	}
+
+	for (i = 0; i < nthreads; i++)
+	{
+		if (threadParms[i].fds)
+			pfree(threadParms[i].fds);
+	}
+	pfree(threadParms);
+}
+
+/*
+ * Thread proc of pushStagedQueries.
+ *
+ * NOTE: This function MUST NOT contain elog or ereport statements, nor use
+ * palloc, they are not thread safe.
+ */
+static void *
+thread_PushStagedQueries(void *arg)
+{
+	DispatchSendThreadParms *tp = (DispatchSendThreadParms *) arg;
+
+	gp_set_thread_sigmasks();
+
+	for (;;)
+	{
+		int nfds = 0;
+		int i;
+
+		for (i = 0; i < tp->count; i++)
+		{
+			PGconn *conn = tp->dispatchResultPtrArray[i]->segdbDesc->conn;
+			int ret;
+
+			/* skip already completed connections */
+			if (conn->outCount == 0)
+				continue;
+
+			ret = pqFlushNonBlocking(conn);
+
+			if (ret == 0)
+				continue;
+			else if (ret < 0)
+			{
+				/* leave it to the main thread to report */
+				tp->failedIndex = i;
+				return NULL;
+			}
+
+			tp->fds[nfds].fd = PQsocket(conn);
+			tp->fds[nfds].events = POLLOUT;
+			tp->fds[nfds].revents = 0;
+			nfds++;
+		}
+
+		if (nfds == 0)
+			break;
+
+		/* let the main thread handle interrupts */
+		if (InterruptPending || proc_exit_inprogress)
+			break;
+
+		if (poll(tp->fds, nfds, DISPATCH_SEND_THREAD_POLL_TIMEOUT_MSEC) < 0 &&
+			SOCK_ERRNO != EINTR && SOCK_ERRNO != EAGAIN)
+			break;
+	}
+
+	return NULL;
+}
+
 /*
  * Receive and process results from QEs.
  */
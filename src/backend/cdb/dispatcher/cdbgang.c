@@ -40,7 +40,7 @@
 #include "storage/bfz.h"
 #include "gp-libpq-fe.h"
 #include "gp-libpq-int.h"
-#include "libpq/libpq-be.h"
+#include "libpq/libpq-be.h"		/* pq_input_pending() */
 #include "libpq/ip.h"
 
 #include "utils/guc_tables.h"
@@ -73,6 +73,12 @@ static List *allocatedReaderGangs1 = NIL;
 static List *availableReaderGangs1 = NIL;
 static Gang *primaryWriterGang = NULL;
 
+/*
+ * Reader N-gangs created ahead of time by replenishWarmReaderGangs() whose
+ * QEs are still connecting. They move to availableReaderGangsN once ready.
+ */
+static List *pendingReaderGangsN = NIL;
+
 /*
  * Every gang created must have a unique identifier
  */
@@ -93,6 +99,7 @@ static CdbComponentDatabaseInfo *findDatabaseInfoBySegIndex(
 		CdbComponentDatabases *cdbs, int segIndex);
 static void addGangToAllocated(Gang *gp);
 static Gang *getAvailableGang(GangType type, int size, int content);
+static void finishPendingReaderGangs(bool all);
 
 /*
  * Create a reader gang.
@@ -765,6 +772,18 @@ getAllIdleReaderGangs()
 {
 	List *res = NIL;
 	ListCell *le;
+	MemoryContext oldContext;
+
+	/*
+	 * Gangs still connecting are idle gangs too, and whatever is dispatched
+	 * to the idle gangs (e.g. SET) must reach them.
+	 */
+	if (pendingReaderGangsN != NIL)
+	{
+		oldContext = MemoryContextSwitchTo(GangContext);
+		finishPendingReaderGangs(true);
+		MemoryContextSwitchTo(oldContext);
+	}
 
 	/*
 	 * Do not use list_concat() here, it would destructively modify the lists!
@@ -832,6 +851,8 @@ static Gang *getAvailableGang(GangType type, int size, int content)
 		break;
 
 	case GANGTYPE_PRIMARY_READER:
+		finishPendingReaderGangs(false);
+
 		if (availableReaderGangsN != NULL) /* There are gangs already created */
 		{
 			ELOG_DISPATCHER_DEBUG("Reusing an available reader N-gang");
@@ -1069,6 +1090,13 @@ static void disconnectAndDestroyAllReaderGangs(bool destroyAllocated)
 	Gang *gp = NULL;
 	ListCell *lc = NULL;
 
+	foreach(lc, pendingReaderGangsN)
+	{
+		gp = (Gang*) lfirst(lc);
+		DisconnectAndDestroyGang(gp);
+	}
+	pendingReaderGangsN = NULL;
+
 	foreach(lc, availableReaderGangsN)
 	{
 		gp = (Gang*) lfirst(lc);
@@ -1533,6 +1561,127 @@ void CheckForResetSession(void)
 	}
 }
 
+/*
+ * Make sure at least gp_warm_reader_gangs idle reader N-gangs (bounded by
+ * gp_cached_segworkers_threshold) are ready to be handed out by
+ * AllocateReaderGang, creating the missing ones.
+ *
+ * This is called from the QD main loop after ReadyForQuery has been sent.
+ * The missing gangs are only started here: their connection requests are
+ * sent without waiting for the QEs, and the connections are then driven
+ * while the client has not sent anything. As soon as it does, we return to
+ * serve it, and the connections are finished by the first statement that
+ * needs a reader gang (or dispatches to the idle ones). Gangs that were
+ * destroyed because of an error, or released because they hit
+ * gp_vmem_protect_gang_cache_limit, are thus replaced in the background.
+ * Idle gangs are still released by gp_vmem_idle_resource_timeout as before.
+ *
+ * Failures are only logged: the next statement creates its gangs as usual.
+ *
+ * Call this procedure outside of a transaction.
+ */
+void replenishWarmReaderGangs(void)
+{
+	MemoryContext oldContext = CurrentMemoryContext;
+	volatile bool failed = false;
+	int target;
+
+	if (Gp_role != GP_ROLE_DISPATCH || gp_warm_reader_gangs <= 0)
+		return;
+
+	/*
+	 * Reader gangs cannot exist without the writer gang, and the session
+	 * might be about to be reset.
+	 */
+	if (primaryWriterGang == NULL || NeedResetSession)
+		return;
+
+	if (IsTransactionOrTransactionBlock())
+		return;
+
+	target = Min(gp_warm_reader_gangs, gp_cached_gang_threshold);
+
+	if (list_length(availableReaderGangsN) + list_length(pendingReaderGangsN) < target)
+	{
+		ELOG_DISPATCHER_DEBUG("replenishWarmReaderGangs: availableReaderGangsN %d, pendingReaderGangsN %d, target %d",
+				list_length(availableReaderGangsN), list_length(pendingReaderGangsN), target);
+
+		/* The gang definition is read from the catalog */
+		StartTransactionCommand();
+
+		PG_TRY();
+		{
+			Assert(GangContext != NULL);
+			MemoryContextSwitchTo(GangContext);
+
+			while (list_length(availableReaderGangsN) + list_length(pendingReaderGangsN) < target)
+			{
+				Gang *gp = startGang_async(GANGTYPE_PRIMARY_READER, gang_id_counter++,
+										   getgpsegmentCount(), 0);
+
+				pendingReaderGangsN = lappend(pendingReaderGangsN, gp);
+			}
+
+			MemoryContextSwitchTo(oldContext);
+		}
+		PG_CATCH();
+		{
+			MemoryContextSwitchTo(oldContext);
+
+			/* Nobody is waiting for this, don't bother the client with it. */
+			if (!elog_demote(LOG))
+			{
+				elog(LOG, "unable to demote error");
+				PG_RE_THROW();
+			}
+
+			EmitErrorReport();
+			FlushErrorState();
+			failed = true;
+		}
+		PG_END_TRY();
+
+		if (failed)
+			AbortCurrentTransaction();
+		else
+			CommitTransactionCommand();
+	}
+
+	/*
+	 * Drive the connections until they are all established, or the client
+	 * sends something, or we get a signal (ReadCommand handles it).
+	 */
+	MemoryContextSwitchTo(GangContext);
+
+	while (pendingReaderGangsN != NIL && !InterruptPending && !pq_input_pending())
+	{
+		if (advancePendingGangs_async(&pendingReaderGangsN, &availableReaderGangsN,
+									  true, MyProcPort->sock))
+			break;
+	}
+
+	MemoryContextSwitchTo(oldContext);
+}
+
+/*
+ * Waits for the reader N-gangs created ahead of time to finish connecting.
+ * If 'all' is false, returns as soon as one of them is available.
+ *
+ * Call this function in GangContext memory context.
+ */
+static void
+finishPendingReaderGangs(bool all)
+{
+	while (pendingReaderGangsN != NIL &&
+		   (all || availableReaderGangsN == NIL))
+	{
+		CHECK_FOR_INTERRUPTS();
+
+		advancePendingGangs_async(&pendingReaderGangsN, &availableReaderGangsN,
+								  true, -1);
+	}
+}
+
 static void resetSessionForPrimaryGangLoss(void)
 {
 	if (ProcCanSetMppSessionId())
@@ -1686,6 +1835,7 @@ bool GangsExist(void)
 	return (primaryWriterGang != NULL ||
 			allocatedReaderGangsN != NIL ||
 			availableReaderGangsN != NIL ||
+			pendingReaderGangsN != NIL ||
 			allocatedReaderGangs1 != NIL||
 			availableReaderGangs1 != NIL);
 }
@@ -23,6 +23,7 @@
 #include "tcop/tcopprot.h"
 #include "cdb/cdbfts.h"
 #include "cdb/cdbgang.h"
+#include "cdb/cdbgang_async.h"
 #include "cdb/cdbvars.h"
 #include "miscadmin.h"
 #include "utils/gp_atomic.h"
@@ -308,6 +309,301 @@ create_gang_retry:
 	return newGangDefinition;
 }
 
+/*
+ * Connection state of a gang started by startGang_async(), kept in the
+ * perGangContext of the gang until all its QEs are connected.
+ */
+typedef struct PendingGangConnect
+{
+	PostgresPollingStatusType *pollingStatus;
+	/* true means the connection is established */
+	bool	   *connStatusDone;
+	struct timeval startTS;
+} PendingGangConnect;
+
+/*
+ * Starts creating a gang, but returns as soon as the connection requests
+ * have been sent, instead of waiting for the QEs to start up. The gang is not
+ * usable until advancePendingGangs_async() has moved it to its ready list.
+ *
+ * Call this function in GangContext memory context, in a transaction.
+ * elog ERROR or return a non-NULL gang.
+ */
+Gang *
+startGang_async(GangType type, int gang_id, int size, int content)
+{
+	Gang *newGangDefinition;
+	PendingGangConnect *pending;
+	int i;
+
+	ELOG_DISPATCHER_DEBUG("startGang type = %d, gang_id = %d, size = %d, content = %d",
+			type, gang_id, size, content);
+
+	/* Only reader gangs are created ahead of time. */
+	Assert(type != GANGTYPE_PRIMARY_WRITER);
+	Assert(size == 1 || size == getgpsegmentCount());
+	Assert(CurrentMemoryContext == GangContext);
+
+	if (!isPrimaryWriterGangAlive())
+		ereport(ERROR, (errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+						errmsg("failed to acquire resources on one or more segments"),
+						errdetail("writer gang got broken before creating reader gangs")));
+
+	newGangDefinition = buildGangDefinition(type, gang_id, size, content);
+
+	MemoryContextSwitchTo(newGangDefinition->perGangContext);
+
+	pending = palloc(sizeof(PendingGangConnect));
+	pending->pollingStatus = palloc(sizeof(PostgresPollingStatusType) * size);
+	pending->connStatusDone = palloc0(sizeof(bool) * size);
+	newGangDefinition->pendingConnect = pending;
+
+	PG_TRY();
+	{
+		for (i = 0; i < size; i++)
+		{
+			SegmentDatabaseDescriptor *segdbDesc = &newGangDefinition->db_descriptors[i];
+			char gpqeid[100];
+			char *options;
+
+			build_gpqeid_param(gpqeid, sizeof(gpqeid),
+							   segdbDesc->segindex, false, gang_id);
+
+			options = makeOptions();
+
+			cdbconn_doConnectStart(segdbDesc, gpqeid, options);
+
+			if (cdbconn_isBadConnection(segdbDesc))
+				ereport(ERROR, (errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+								errmsg("failed to acquire resources on one or more segments"),
+								errdetail("%s (%s)", PQerrorMessage(segdbDesc->conn), segdbDesc->whoami)));
+
+			/* As in createGang_async, act as if PQconnectPoll() asked to write */
+			pending->pollingStatus[i] = PGRES_POLLING_WRITING;
+		}
+	}
+	PG_CATCH();
+	{
+		MemoryContextSwitchTo(GangContext);
+		DisconnectAndDestroyGang(newGangDefinition);
+		PG_RE_THROW();
+	}
+	PG_END_TRY();
+
+	gettimeofday(&pending->startTS, NULL);
+
+	MemoryContextSwitchTo(GangContext);
+	return newGangDefinition;
+}
+
+/*
+ * Checks the connections of a pending gang. Completes the connections that
+ * PQconnectPoll() reported as established, and adds the sockets of the others
+ * to 'fds'. Returns false if a connection failed or timed out, after logging
+ * why; *poll_timeout is lowered to the time left before the gang times out.
+ */
+static bool
+checkPendingGang(Gang *gp, struct pollfd *fds, int *nfds, int *poll_timeout)
+{
+	PendingGangConnect *pending = gp->pendingConnect;
+	int timeout = getPollTimeout(&pending->startTS);
+	int i;
+
+	for (i = 0; i < gp->size; i++)
+	{
+		SegmentDatabaseDescriptor *segdbDesc = &gp->db_descriptors[i];
+
+		if (pending->connStatusDone[i])
+			continue;
+
+		switch (pending->pollingStatus[i])
+		{
+			case PGRES_POLLING_OK:
+				cdbconn_doConnectComplete(segdbDesc);
+				if (segdbDesc->motionListener == -1 || segdbDesc->motionListener == 0)
+				{
+					elog(LOG, "could not create reader gang ahead of time: no motion listener port (%s)",
+						 segdbDesc->whoami);
+					return false;
+				}
+				pending->connStatusDone[i] = true;
+				continue;
+
+			case PGRES_POLLING_READING:
+				fds[*nfds].fd = PQsocket(segdbDesc->conn);
+				fds[*nfds].events = POLLIN;
+				fds[*nfds].revents = 0;
+				(*nfds)++;
+				break;
+
+			case PGRES_POLLING_WRITING:
+				fds[*nfds].fd = PQsocket(segdbDesc->conn);
+				fds[*nfds].events = POLLOUT;
+				fds[*nfds].revents = 0;
+				(*nfds)++;
+				break;
+
+			default:
+				elog(LOG, "could not create reader gang ahead of time: %s (%s)",
+					 PQerrorMessage(segdbDesc->conn), segdbDesc->whoami);
+				return false;
+		}
+
+		if (timeout == 0)
+		{
+			elog(LOG, "could not create reader gang ahead of time: timeout expired (%s)",
+				 segdbDesc->whoami);
+			return false;
+		}
+	}
+
+	if (timeout >= 0 && (*poll_timeout < 0 || timeout < *poll_timeout))
+		*poll_timeout = timeout;
+
+	return true;
+}
+
+/*
+ * Advances the connections of the gangs in *pending, which were started by
+ * startGang_async(). This never blocks on one QE: all the connections are
+ * driven by PQconnectPoll() as their sockets become ready.
+ *
+ * If 'wait' is true, waits until one of the sockets is ready, or 'wakeFd'
+ * (if not -1) becomes readable, or a gang times out; otherwise only does the
+ * work that is possible without waiting.
+ *
+ * Gangs whose QEs are all connected are moved to *ready. Gangs that failed
+ * are logged and destroyed; it's up to the caller to create gangs as usual
+ * when it needs them. Returns true if 'wakeFd' became readable.
+ *
+ * Call this function in GangContext memory context.
+ */
+bool
+advancePendingGangs_async(List **pending, List **ready, bool wait, int wakeFd)
+{
+	struct pollfd *fds;
+	int nfds = 0;
+	int poll_timeout = -1;
+	int maxfds = 1;
+	int nready;
+	ListCell *lc;
+	ListCell *prev = NULL;
+	ListCell *next;
+	bool woken = false;
+
+	Assert(CurrentMemoryContext == GangContext);
+
+	foreach(lc, *pending)
+		maxfds += ((Gang *) lfirst(lc))->size;
+
+	fds = (struct pollfd *) palloc(sizeof(struct pollfd) * maxfds);
+
+	/* Complete what we can, and collect the sockets to wait for */
+	for (lc = list_head(*pending); lc != NULL; lc = next)
+	{
+		Gang *gp = (Gang *) lfirst(lc);
+		int firstfd = nfds;
+
+		next = lnext(lc);
+
+		if (!checkPendingGang(gp, fds, &nfds, &poll_timeout))
+		{
+			nfds = firstfd;
+			*pending = list_delete_cell(*pending, lc, prev);
+			DisconnectAndDestroyGang(gp);
+			continue;
+		}
+
+		if (nfds == firstfd)
+		{
+			ELOG_DISPATCHER_DEBUG("reader gang %d created ahead of time is ready", gp->gang_id);
+
+			pfree(gp->pendingConnect->pollingStatus);
+			pfree(gp->pendingConnect->connStatusDone);
+			pfree(gp->pendingConnect);
+			gp->pendingConnect = NULL;
+
+			*pending = list_delete_cell(*pending, lc, prev);
+			*ready = lappend(*ready, gp);
+			setLargestGangsize(gp->size);
+			continue;
+		}
+
+		prev = lc;
+	}
+
+	if (nfds == 0)
+	{
+		pfree(fds);
+		return false;
+	}
+
+	if (wakeFd >= 0)
+	{
+		fds[nfds].fd = wakeFd;
+		fds[nfds].events = POLLIN;
+		fds[nfds].revents = 0;
+	}
+
+	nready = poll(fds, nfds + (wakeFd >= 0 ? 1 : 0), wait ? poll_timeout : 0);
+
+	if (nready < 0)
+	{
+		int sock_errno = SOCK_ERRNO;
+
+		/*
+		 * Interrupted; the caller checks for interrupts and calls us again.
+		 * Otherwise, we can't wait for the pending gangs, so give up on them
+		 * like on gangs that failed, rather than have the caller poll again.
+		 */
+		if (sock_errno != EINTR)
+		{
+			elog(LOG, "poll() failed while creating reader gangs ahead of time: errno = %d",
+				 sock_errno);
+
+			foreach(lc, *pending)
+				DisconnectAndDestroyGang((Gang *) lfirst(lc));
+			list_free(*pending);
+			*pending = NIL;
+		}
+	}
+	else if (nready > 0)
+	{
+		int currentFdNumber = 0;
+
+		/* The pending gangs and their connections are in the same order as fds */
+		foreach(lc, *pending)
+		{
+			Gang *gp = (Gang *) lfirst(lc);
+			int i;
+
+			for (i = 0; i < gp->size; i++)
+			{
+				SegmentDatabaseDescriptor *segdbDesc = &gp->db_descriptors[i];
+
+				if (gp->pendingConnect->connStatusDone[i])
+					continue;
+
+				Assert(PQsocket(segdbDesc->conn) == fds[currentFdNumber].fd);
+
+				/* Let PQconnectPoll() find out about errors and hangups, too */
+				if (fds[currentFdNumber].revents != 0)
+					gp->pendingConnect->pollingStatus[i] = PQconnectPoll(segdbDesc->conn);
+
+				currentFdNumber++;
+			}
+		}
+
+		Assert(currentFdNumber == nfds);
+
+		if (wakeFd >= 0 && fds[nfds].revents != 0)
+			woken = true;
+	}
+
+	pfree(fds);
+	return woken;
+}
+
 static int getPollTimeout(const struct timeval* startTS)
 {
 	struct timeval now;
@@ -32,6 +32,7 @@
 #include "commands/vacuum.h"
 #include "executor/executor.h"
 #include "executor/spi.h"
+#include "lib/hyperloglog.h"
 #include "miscadmin.h"
 #include "parser/parse_expr.h"
 #include "parser/parse_oper.h"
@@ -106,9 +107,15 @@ static Datum ind_fetch_func(VacAttrStatsP stats, int rownum, bool *isNull);
 
 static bool std_typanalyze(VacAttrStats *stats);
 
+static int	analyzeExecuteQuery(const char *query);
 static void analyzeEstimateReltuplesRelpages(Oid relationOid, float4 *relTuples, float4 *relPages, bool rootonly);
 static void analyzeEstimateIndexpages(Relation onerel, Relation indrel, BlockNumber *indexPages);
 
+static void compute_hll_stats(Relation onerel, int attr_cnt, VacAttrStats **vacattrstats,
+				  double totalrows);
+static bool merge_leaf_stats(Relation onerel, int attr_cnt, VacAttrStats **vacattrstats,
+				 double *totalrows, BlockNumber *totalpages);
+
 /*
  *	analyze_rel() -- analyze one relation
  */
@@ -133,6 +140,7 @@ analyze_rel(Oid relid, VacuumStmt *vacstmt,
 				totaldeadrows;
 	BlockNumber	totalpages;
 	HeapTuple  *rows;
+	bool		merged;
 	PGRUsage	ru0;
 	TimestampTz starttime = 0;
 	Oid			save_userid;
@@ -387,10 +395,22 @@ analyze_rel(Oid relid, VacuumStmt *vacstmt,
 	}
 
 	/*
-	 * Acquire the sample rows
+	 * Acquire the sample rows. With gp_statistics_use_hll, the statistics of
+	 * a partitioned table are merged from those of its leaf partitions
+	 * instead, if they are all available.
 	 */
-	numrows = acquire_sample_rows_by_query(onerel, attr_cnt, vacattrstats, &rows, targrows,
-										   &totalrows, &totaldeadrows, &totalpages);
+	merged = false;
+	if (gp_statistics_use_hll && !analyzableindex)
+		merged = merge_leaf_stats(onerel, attr_cnt, vacattrstats,
+								  &totalrows, &totalpages);
+	if (merged)
+	{
+		numrows = 0;
+		totaldeadrows = 0;
+	}
+	else
+		numrows = acquire_sample_rows_by_query(onerel, attr_cnt, vacattrstats, &rows, targrows,
+											   &totalrows, &totaldeadrows, &totalpages);
 
 	/*
 	 * Compute the statistics.	Temporary results during the calculations for
@@ -432,6 +452,10 @@ analyze_rel(Oid relid, VacuumStmt *vacstmt,
 		MemoryContextSwitchTo(old_context);
 		MemoryContextDelete(col_context);
 
+		/* Replace the estimated number of distinct values, if asked to */
+		if (gp_statistics_use_hll)
+			compute_hll_stats(onerel, attr_cnt, vacattrstats, totalrows);
+
 		/*
 		 * Emit the completed stats rows into pg_statistic, replacing any
 		 * previous statistics for the target columns.	(If there are stats in
@@ -447,6 +471,8 @@ analyze_rel(Oid relid, VacuumStmt *vacstmt,
 							thisdata->attr_cnt, thisdata->vacattrstats);
 		}
 	}
+	else if (merged)
+		update_attstats(relid, attr_cnt, vacattrstats);
 
 	/*
 	 * If we are running a standalone ANALYZE, update pages/tuples stats in
@@ -738,6 +764,7 @@ examine_attribute(Relation onerel, int attnum)
 	Form_pg_attribute attr = onerel->rd_att->attrs[attnum - 1];
 	HeapTuple	typtuple;
 	VacAttrStats *stats;
+	int			i;
 	bool		ok;
 
 	/* Never analyze dropped columns */
@@ -764,6 +791,20 @@ examine_attribute(Relation onerel, int attnum)
 	stats->anl_context = anl_context;
 	stats->tupattnum = attnum;
 
+	/*
+	 * The fields describing the stats->stavalues[n] element types default
+	 * to the type of the field being analyzed, but the type-specific
+	 * typanalyze function can change them if it wants to store something
+	 * else.
+	 */
+	for (i = 0; i < STATISTIC_NUM_SLOTS; i++)
+	{
+		stats->statypid[i] = stats->attr->atttypid;
+		stats->statyplen[i] = stats->attrtype->typlen;
+		stats->statypbyval[i] = stats->attrtype->typbyval;
+		stats->statypalign[i] = stats->attrtype->typalign;
+	}
+
 	/*
 	 * Call the type-specific typanalyze function.	If none is specified, use
 	 * std_typanalyze().
@@ -1318,7 +1359,6 @@ acquire_sample_rows_by_query(Relation onerel, int nattrs, VacAttrStats **attrsta
 	float4		randomThreshold = 0.0;
 	float4		relTuples;
 	float4		relPages;
-	int			ret;
 	int			sampleTuples;
 	Datum	   *vals;
 	bool	   *nulls;
@@ -1419,41 +1459,7 @@ acquire_sample_rows_by_query(Relation onerel, int nattrs, VacAttrStats **attrsta
 		ereport(ERROR, (errcode(ERRCODE_CDB_INTERNAL_ERROR),
 						errmsg("Unable to connect to execute internal query.")));
 
-	elog(elevel, "Executing SQL: %s", str.data);
-
-	/*
-	 * Temporarily disable ORCA because it's slow to start up, and it
-	 * wouldn't come up with any better plan for this simple query.
-	 */
-	{
-		bool		optimizerBackup = optimizer;
-
-		optimizer = false;
-
-		PG_TRY();
-		{
-			/*
-			 * Do the query. We pass readonly==false, to force SPI to take a new
-			 * snapshot. That ensures that we see all changes by our own transaction.
-			 */
-			ret = SPI_execute(str.data, false, 0);
-			Assert(ret > 0);
-			sampleTuples = SPI_processed;
-
-			optimizer = optimizerBackup;
-		}
-
-		/* Clean up in case of error. */
-		PG_CATCH();
-		{
-			optimizer = optimizerBackup;
-
-			/* Carry on with error handling. */
-			PG_RE_THROW();
-		}
-		PG_END_TRY();
-		Assert(optimizer == optimizerBackup);
-	}
+	sampleTuples = analyzeExecuteQuery(str.data);
 
 	/* Ok, read in the tuples to *rows */
 	MemoryContextSwitchTo(oldcxt);
@@ -1502,6 +1508,53 @@ acquire_sample_rows_by_query(Relation onerel, int nattrs, VacAttrStats **attrsta
 }
 
 
+/*
+ * Run one of the internal queries of ANALYZE, after connecting to SPI.
+ * Returns the number of rows in SPI_tuptable.
+ */
+static int
+analyzeExecuteQuery(const char *query)
+{
+	int			ret;
+
+	elog(elevel, "Executing SQL: %s", query);
+
+	/*
+	 * Temporarily disable ORCA because it's slow to start up, and it
+	 * wouldn't come up with any better plan for these simple queries.
+	 */
+	{
+		bool		optimizerBackup = optimizer;
+
+		optimizer = false;
+
+		PG_TRY();
+		{
+			/*
+			 * Do the query. We pass readonly==false, to force SPI to take a new
+			 * snapshot. That ensures that we see all changes by our own transaction.
+			 */
+			ret = SPI_execute(query, false, 0);
+			Assert(ret > 0);
+
+			optimizer = optimizerBackup;
+		}
+
+		/* Clean up in case of error. */
+		PG_CATCH();
+		{
+			optimizer = optimizerBackup;
+
+			/* Carry on with error handling. */
+			PG_RE_THROW();
+		}
+		PG_END_TRY();
+		Assert(optimizer == optimizerBackup);
+	}
+
+	return SPI_processed;
+}
+
 /**
  * This method estimates reltuples/relpages for a relation. To do this, it employs
  * the built-in function 'gp_statistics_estimate_reltuples_relpages'. If the table to be
@@ -1761,10 +1814,10 @@ update_attstats(Oid relid, int natts, VacAttrStats **vacattrstats)
 
 				arry = construct_array(stats->stavalues[k],
 									   stats->numvalues[k],
-									   stats->attr->atttypid,
-									   stats->attrtype->typlen,
-									   stats->attrtype->typbyval,
-									   stats->attrtype->typalign);
+									   stats->statypid[k],
+									   stats->statyplen[k],
+									   stats->statypbyval[k],
+									   stats->statypalign[k]);
 				values[i++] = PointerGetDatum(arry);	/* stavaluesN */
 			}
 			else
@@ -1894,6 +1947,19 @@ typedef struct
 	int		   *tupnoLink;
 } CompareScalarsContext;
 
+/* A value found in the statistics of a leaf partition, see merge_leaf_stats */
+typedef struct
+{
+	Datum		value;			/* a data value */
+	double		count;			/* # of rows it stands for */
+} MergeItem;
+
+typedef struct
+{
+	FmgrInfo   *cmpFn;
+	int			cmpFlags;
+} CompareMergeItemsContext;
+
 
 static void compute_minimal_stats(VacAttrStatsP stats,
 					  AnalyzeAttrFetchFunc fetchfunc,
@@ -1910,6 +1976,15 @@ static void compute_scalar_stats(VacAttrStatsP stats,
 static int	compare_scalars(const void *a, const void *b, void *arg);
 static int	compare_mcvs(const void *a, const void *b);
 
+static void store_hll_stats(VacAttrStats *stats, HyperLogLog *hll,
+				double totalrows);
+static bool merge_leaf_attr_stats(VacAttrStats *stats, int nleaves,
+					  Oid *leafoids, double *leafrows, double totalrows);
+static void append_merge_item(MergeItem **items, int *nitems, int *maxitems,
+				  Datum value, double count);
+static int	compare_merge_items(const void *a, const void *b, void *arg);
+static int	compare_merge_counts(const void *a, const void *b);
+
 
 /*
  * std_typanalyze -- the default type-specific typanalyze function
@@ -2941,3 +3016,623 @@ compare_mcvs(const void *a, const void *b)
 
 	return da - db;
 }
+
+/*
+ *	compute_hll_stats() -- estimate the number of distinct values of the
+ *		columns from HyperLogLog sketches
+ *
+ *	The sketches are built by one query that scans the whole table on all
+ *	segments in parallel, with the gp_hll_sketch() aggregate. That is much
+ *	more accurate than extrapolating from the sample for columns with many
+ *	distinct values. The sketches are also stored in pg_statistic, so that
+ *	the statistics of partitioned tables can be merged from those of their
+ *	leaf partitions, see merge_leaf_stats().
+ *
+ *	This is in addition to the sample, which is still gathered on the master
+ *	by acquire_sample_rows_by_query() and used for everything else. So each
+ *	table is read in full once more, on top of the sampling query: the cost
+ *	of a sequential scan of the whole table, spread over the segments. Only
+ *	the sketches, 16kB per column and segment, come back to the master.
+ */
+static void
+compute_hll_stats(Relation onerel, int attr_cnt, VacAttrStats **vacattrstats,
+				  double totalrows)
+{
+	StringInfoData str;
+	HyperLogLog **sketches;
+	int			i;
+
+	if (attr_cnt <= 0)
+		return;
+
+	/* The sampling query skips external partitions, and so would we */
+	if (rel_has_external_partition(RelationGetRelid(onerel)))
+		return;
+
+	initStringInfo(&str);
+	appendStringInfoString(&str, "select ");
+	for (i = 0; i < attr_cnt; i++)
+	{
+		if (i != 0)
+			appendStringInfoString(&str, ", ");
+		appendStringInfo(&str, "pg_catalog.gp_hll_sketch(Ta.%s)",
+						 quote_identifier(NameStr(vacattrstats[i]->attr->attname)));
+	}
+	appendStringInfo(&str, " from %s.%s as Ta",
+					 quote_identifier(get_namespace_name(RelationGetNamespace(onerel))),
+					 quote_identifier(RelationGetRelationName(onerel)));
+
+	sketches = (HyperLogLog **) palloc0(attr_cnt * sizeof(HyperLogLog *));
+
+	if (SPI_OK_CONNECT != SPI_connect())
+		ereport(ERROR, (errcode(ERRCODE_CDB_INTERNAL_ERROR),
+						errmsg("Unable to connect to execute internal query.")));
+
+	if (analyzeExecuteQuery(str.data) == 1)
+	{
+		for (i = 0; i < attr_cnt; i++)
+		{
+			Datum		value;
+			bool		isnull;
+			HyperLogLog *hll;
+
+			value = SPI_getbinval(SPI_tuptable->vals[0], SPI_tuptable->tupdesc,
+								  i + 1, &isnull);
+			if (isnull)
+				continue;
+
+			/*
+			 * The aggregate returns an empty bytea if there are no non-null
+			 * values; that's an empty sketch, too.
+			 */
+			hll = (HyperLogLog *) DatumGetByteaP(value);
+			if (!HllIsValid(hll) && VARSIZE(hll) != VARHDRSZ)
+				continue;
+
+			/* Must copy the sketch out of the SPI context */
+			sketches[i] = (HyperLogLog *) MemoryContextAllocZero(anl_context, HLL_SIZE);
+			if (HllIsValid(hll))
+				memcpy(sketches[i], hll, HLL_SIZE);
+			else
+			{
+				SET_VARSIZE(sketches[i], HLL_SIZE);
+				sketches[i]->precision = HLL_PRECISION;
+			}
+		}
+	}
+
+	SPI_finish();
+
+	for (i = 0; i < attr_cnt; i++)
+	{
+		if (sketches[i] != NULL && vacattrstats[i]->stats_valid)
+			store_hll_stats(vacattrstats[i], sketches[i], totalrows);
+	}
+}
+
+/*
+ * Set the number of distinct values of a column from its HyperLogLog sketch,
+ * and save the sketch in the first free statistics slot. The sketch must be
+ * allocated in anl_context.
+ */
+static void
+store_hll_stats(VacAttrStats *stats, HyperLogLog *hll, double totalrows)
+{
+	double		nonnullrows = (1.0 - stats->stanullfrac) * totalrows;
+	Datum	   *values;
+	int			slot_idx;
+
+	if (nonnullrows >= 1.0)
+	{
+		double		ndistinct = hll_estimate(hll);
+
+		/* Clamp to sane range in case of estimation error */
+		if (ndistinct < 1.0)
+			ndistinct = 1.0;
+		if (ndistinct > nonnullrows)
+			ndistinct = nonnullrows;
+		stats->stadistinct = floor(ndistinct + 0.5);
+
+		/* Scale with the row count, as in compute_scalar_stats() */
+		if (stats->stadistinct > 0.1 * totalrows)
+			stats->stadistinct = -(stats->stadistinct / totalrows);
+	}
+
+	for (slot_idx = 0; slot_idx < STATISTIC_NUM_SLOTS; slot_idx++)
+	{
+		if (stats->stakind[slot_idx] == 0)
+			break;
+	}
+	if (slot_idx >= STATISTIC_NUM_SLOTS)
+		return;
+
+	values = (Datum *) MemoryContextAlloc(stats->anl_context, sizeof(Datum));
+	values[0] = PointerGetDatum(hll);
+
+	stats->stakind[slot_idx] = STATISTIC_KIND_HLL;
+	stats->staop[slot_idx] = InvalidOid;
+	stats->stavalues[slot_idx] = values;
+	stats->numvalues[slot_idx] = 1;
+	stats->statypid[slot_idx] = BYTEAOID;
+	stats->statyplen[slot_idx] = -1;
+	stats->statypbyval[slot_idx] = false;
+	stats->statypalign[slot_idx] = 'i';
+}
+
+/*
+ *	merge_leaf_stats() -- merge the statistics of a partitioned table from
+ *		those of its leaf partitions
+ *
+ *	This is used instead of sampling a partitioned table when
+ *	gp_statistics_use_hll is set. get_rel_oids() has arranged for the leaf
+ *	partitions to be analyzed first. Row counts come from pg_class, the
+ *	number of distinct values from the union of the partitions' HyperLogLog
+ *	sketches, and the other statistics are combined weighting each partition
+ *	by its number of rows.
+ *
+ *	Returns false, leaving vacattrstats alone, if the statistics can't be
+ *	merged: the table is not partitioned, or a partition that has rows has no
+ *	sketch (e.g. it was analyzed without gp_statistics_use_hll).
+ */
+static bool
+merge_leaf_stats(Relation onerel, int attr_cnt, VacAttrStats **vacattrstats,
+				 double *totalrows, BlockNumber *totalpages)
+{
+	Oid			relid = RelationGetRelid(onerel);
+	PartStatus	ps = rel_part_status(relid);
+	List	   *leaves;
+	ListCell   *lc;
+	int			nleaves;
+	Oid		   *leafoids;
+	double	   *leafrows;
+	double		rows = 0;
+	BlockNumber pages = 0;
+	VacAttrStats *merged;
+	MemoryContext col_context,
+				old_context;
+	bool		ok = true;
+	int			i;
+
+	if (ps != PART_STATUS_ROOT && ps != PART_STATUS_INTERIOR)
+		return false;
+
+	/* See analyzeEstimateReltuplesRelpages() */
+	if (ps == PART_STATUS_ROOT && !optimizer_analyze_root_partition)
+		return false;
+
+	/* We only know how to merge the standard statistics */
+	for (i = 0; i < attr_cnt; i++)
+	{
+		if (vacattrstats[i]->compute_stats != compute_scalar_stats &&
+			vacattrstats[i]->compute_stats != compute_minimal_stats &&
+			vacattrstats[i]->compute_stats != compute_very_minimal_stats)
+			return false;
+	}
+
+	leaves = rel_get_leaf_children_relids(relid);
+	nleaves = list_length(leaves);
+	leafoids = (Oid *) palloc(nleaves * sizeof(Oid));
+	leafrows = (double *) palloc(nleaves * sizeof(double));
+
+	i = 0;
+	foreach(lc, leaves)
+	{
+		Oid			leafoid = lfirst_oid(lc);
+		HeapTuple	tuple;
+		Form_pg_class classForm;
+
+		tuple = SearchSysCache(RELOID,
+							   ObjectIdGetDatum(leafoid),
+							   0, 0, 0);
+		if (!HeapTupleIsValid(tuple))
+			elog(ERROR, "cache lookup failed for relation %u", leafoid);
+		classForm = (Form_pg_class) GETSTRUCT(tuple);
+
+		/* There are no statistics for external partitions */
+		if (classForm->relstorage == RELSTORAGE_EXTERNAL)
+		{
+			ReleaseSysCache(tuple);
+			return false;
+		}
+
+		leafoids[i] = leafoid;
+		leafrows[i] = classForm->reltuples;
+		rows += classForm->reltuples;
+		pages += classForm->relpages;
+		i++;
+
+		ReleaseSysCache(tuple);
+	}
+
+	/* Let the sampling code deal with empty tables */
+	if (rows < 1.0)
+		return false;
+
+	/* Merge into copies, in case some column can't be merged */
+	merged = (VacAttrStats *) palloc(attr_cnt * sizeof(VacAttrStats));
+
+	col_context = AllocSetContextCreate(anl_context,
+										"Analyze Column",
+										ALLOCSET_DEFAULT_MINSIZE,
+										ALLOCSET_DEFAULT_INITSIZE,
+										ALLOCSET_DEFAULT_MAXSIZE);
+	old_context = MemoryContextSwitchTo(col_context);
+
+	for (i = 0; i < attr_cnt && ok; i++)
+	{
+		merged[i] = *vacattrstats[i];
+		ok = merge_leaf_attr_stats(&merged[i], nleaves, leafoids, leafrows,
+								   rows);
+		MemoryContextResetAndDeleteChildren(col_context);
+	}
+
+	MemoryContextSwitchTo(old_context);
+	MemoryContextDelete(col_context);
+
+	if (!ok)
+		return false;
+
+	for (i = 0; i < attr_cnt; i++)
+		*vacattrstats[i] = merged[i];
+
+	elog(elevel, "ANALYZE merged statistics of %d leaf partitions into %s",
+		 nleaves, RelationGetRelationName(onerel));
+
+	*totalrows = rows;
+	*totalpages = pages;
+
+	return true;
+}
+
+/*
+ * Merge the statistics of one column from the leaf partitions. Called in a
+ * short-lived memory context; the results are copied into anl_context.
+ *
+ * The most common values are added up over all partitions, and kept if they
+ * are common enough by the same rule as compute_scalar_stats(). Histogram
+ * bounds are merged assuming the rows of each bucket are at its upper bound.
+ * Both need a "<" operator to bring equal values together; otherwise we only
+ * produce the simple stats.
+ */
+static bool
+merge_leaf_attr_stats(VacAttrStats *stats, int nleaves, Oid *leafoids,
+					  double *leafrows, double totalrows)
+{
+	StdAnalyzeData *mystats = (StdAnalyzeData *) stats->extra_data;
+	bool		sortable = (mystats != NULL && OidIsValid(mystats->ltopr));
+	const char *attname = NameStr(stats->attr->attname);
+	HyperLogLog *hll;
+	double		nonnullrows = 0;
+	double		total_width = 0;
+	double		ndistinct;
+	MergeItem  *mcvitems = NULL;
+	int			nmcvitems = 0;
+	int			maxmcvitems = 0;
+	MergeItem  *histitems = NULL;
+	int			nhistitems = 0;
+	int			maxhistitems = 0;
+	int			num_mcv = stats->attr->attstattarget;
+	int			num_bins = stats->attr->attstattarget;
+	int			slot_idx = 0;
+	CompareMergeItemsContext cxt;
+	FmgrInfo	f_cmpfn;
+	MemoryContext old_context;
+	int			i,
+				j;
+
+	old_context = MemoryContextSwitchTo(stats->anl_context);
+	hll = hll_create();
+	MemoryContextSwitchTo(old_context);
+
+	for (i = 0; i < nleaves; i++)
+	{
+		AttrNumber	attnum;
+		HeapTuple	statstup;
+		Form_pg_statistic statsForm;
+		Datum	   *values;
+		int			nvalues;
+		float4	   *numbers;
+		int			nnumbers;
+		HyperLogLog *leafhll;
+		double		leafnonnull;
+		double		mcvrows = 0;
+
+		/* Empty partitions have no statistics, and need none */
+		if (leafrows[i] < 1.0)
+			continue;
+
+		vacuum_delay_point();
+
+		/* The column may have a different number in the partition */
+		attnum = get_attnum(leafoids[i], attname);
+		if (attnum == InvalidAttrNumber)
+			return false;
+
+		statstup = SearchSysCache(STATRELATT,
+								  ObjectIdGetDatum(leafoids[i]),
+								  Int16GetDatum(attnum),
+								  0, 0);
+		if (!HeapTupleIsValid(statstup))
+			return false;
+		statsForm = (Form_pg_statistic) GETSTRUCT(statstup);
+
+		if (!get_attstatsslot(statstup, BYTEAOID, -1,
+							  STATISTIC_KIND_HLL, InvalidOid,
+							  &values, &nvalues,
+							  NULL, NULL))
+		{
+			ReleaseSysCache(statstup);
+			return false;
+		}
+		leafhll = (nvalues == 1) ? (HyperLogLog *) DatumGetByteaP(values[0]) : NULL;
+		if (leafhll == NULL || !HllIsValid(leafhll))
+		{
+			ReleaseSysCache(statstup);
+			return false;
+		}
+		hll_merge(hll, leafhll);
+
+		leafnonnull = leafrows[i] * (1.0 - statsForm->stanullfrac);
+		nonnullrows += leafnonnull;
+		total_width += leafnonnull * statsForm->stawidth;
+
+		/*
+		 * Collect the most common values and histogram bounds. The values
+		 * returned by get_attstatsslot are copies, which we keep.
+		 */
+		if (sortable &&
+			get_attstatsslot(statstup, stats->attr->atttypid, stats->attr->atttypmod,
+							 STATISTIC_KIND_MCV, InvalidOid,
+							 &values, &nvalues,
+							 &numbers, &nnumbers))
+		{
+			for (j = 0; j < nvalues && j < nnumbers; j++)
+			{
+				append_merge_item(&mcvitems, &nmcvitems, &maxmcvitems,
+								  values[j], numbers[j] * leafrows[i]);
+				mcvrows += numbers[j] * leafrows[i];
+			}
+		}
+
+		if (sortable &&
+			get_attstatsslot(statstup, stats->attr->atttypid, stats->attr->atttypmod,
+							 STATISTIC_KIND_HISTOGRAM, InvalidOid,
+							 &values, &nvalues,
+							 NULL, NULL) &&
+			nvalues >= 2)
+		{
+			double		histrows = leafnonnull - mcvrows;
+			double		bucketrows;
+
+			if (histrows < 0)
+				histrows = 0;
+			bucketrows = histrows / (nvalues - 1);
+
+			append_merge_item(&histitems, &nhistitems, &maxhistitems,
+							  values[0], 0);
+			for (j = 1; j < nvalues; j++)
+				append_merge_item(&histitems, &nhistitems, &maxhistitems,
+								  values[j], bucketrows);
+		}
+
+		ReleaseSysCache(statstup);
+	}
+
+	/* Do the simple null-frac and width stats */
+	stats->stats_valid = true;
+	stats->stanullfrac = 1.0 - nonnullrows / totalrows;
+	if (stats->stanullfrac < 0.0)
+		stats->stanullfrac = 0.0;
+	if (nonnullrows > 0)
+		stats->stawidth = total_width / nonnullrows;
+	else if (stats->attrtype->typlen > 0)
+		stats->stawidth = stats->attrtype->typlen;
+	else
+		stats->stawidth = 0;	/* "unknown" */
+	stats->stadistinct = 0.0;	/* "unknown", see store_hll_stats() */
+
+	ndistinct = hll_estimate(hll);
+	if (ndistinct < 1.0)
+		ndistinct = 1.0;
+
+	if (sortable && (nmcvitems > 0 || nhistitems > 0))
+	{
+		Oid			cmpFn;
+
+		SelectSortFunction(mystats->ltopr, false, &cmpFn, &cxt.cmpFlags);
+		fmgr_info(cmpFn, &f_cmpfn);
+		cxt.cmpFn = &f_cmpfn;
+	}
+
+	/* Add up the counts of each of the most common values */
+	if (nmcvitems > 0)
+	{
+		double		avgcount,
+					mincount,
+					maxmincount;
+		int			ngroups = 0;
+
+		qsort_arg((void *) mcvitems, nmcvitems, sizeof(MergeItem),
+				  compare_merge_items, (void *) &cxt);
+		for (i = 0; i < nmcvitems; i++)
+		{
+			if (ngroups > 0 &&
+				compare_merge_items(&mcvitems[ngroups - 1], &mcvitems[i], &cxt) == 0)
+				mcvitems[ngroups - 1].count += mcvitems[i].count;
+			else
+				mcvitems[ngroups++] = mcvitems[i];
+		}
+		qsort((void *) mcvitems, ngroups, sizeof(MergeItem),
+			  compare_merge_counts);
+
+		/*
+		 * Keep the values that are significantly more common than average,
+		 * by the rule of compute_scalar_stats().
+		 */
+		avgcount = nonnullrows / ndistinct;
+		mincount = avgcount * 1.25;
+		maxmincount = nonnullrows / (double) num_bins;
+		if (mincount > maxmincount)
+			mincount = maxmincount;
+		if (num_mcv > ngroups)
+			num_mcv = ngroups;
+		for (i = 0; i < num_mcv; i++)
+		{
+			if (mcvitems[i].count < mincount)
+			{
+				num_mcv = i;
+				break;
+			}
+		}
+
+		if (num_mcv > 0)
+		{
+			Datum	   *mcv_values;
+			float4	   *mcv_freqs;
+
+			/* Must copy the target values into anl_context */
+			old_context = MemoryContextSwitchTo(stats->anl_context);
+			mcv_values = (Datum *) palloc(num_mcv * sizeof(Datum));
+			mcv_freqs = (float4 *) palloc(num_mcv * sizeof(float4));
+			for (i = 0; i < num_mcv; i++)
+			{
+				mcv_values[i] = datumCopy(mcvitems[i].value,
+										  stats->attr->attbyval,
+										  stats->attr->attlen);
+				mcv_freqs[i] = mcvitems[i].count / totalrows;
+			}
+			MemoryContextSwitchTo(old_context);
+
+			stats->stakind[slot_idx] = STATISTIC_KIND_MCV;
+			stats->staop[slot_idx] = mystats->eqopr;
+			stats->stanumbers[slot_idx] = mcv_freqs;
+			stats->numnumbers[slot_idx] = num_mcv;
+			stats->stavalues[slot_idx] = mcv_values;
+			stats->numvalues[slot_idx] = num_mcv;
+			slot_idx++;
+		}
+	}
+
+	/*
+	 * Pick the bounds of equally populated buckets from the sorted bounds of
+	 * all the partitions' histograms.
+	 */
+	if (nhistitems >= 2)
+	{
+		Datum	   *hist_values;
+		int			num_hist = num_bins + 1;
+		int			nbounds = 0;
+		double		totalcount = 0;
+		double		cumcount;
+
+		qsort_arg((void *) histitems, nhistitems, sizeof(MergeItem),
+				  compare_merge_items, (void *) &cxt);
+		for (i = 0; i < nhistitems; i++)
+			totalcount += histitems[i].count;
+		if (num_hist > nhistitems)
+			num_hist = nhistitems;
+
+		hist_values = (Datum *) palloc(num_hist * sizeof(Datum));
+		j = 0;
+		cumcount = histitems[0].count;
+		for (i = 0; i < num_hist; i++)
+		{
+			double		target = totalcount * i / (num_hist - 1);
+
+			if (i == num_hist - 1)
+				j = nhistitems - 1;
+			while (j < nhistitems - 1 && cumcount < target)
+			{
+				j++;
+				cumcount += histitems[j].count;
+			}
+
+			/* Bounds must be distinct */
+			if (nbounds > 0 &&
+				ApplySortFunction(cxt.cmpFn, cxt.cmpFlags,
+								  hist_values[nbounds - 1], false,
+								  histitems[j].value, false) == 0)
+				continue;
+			hist_values[nbounds++] = histitems[j].value;
+		}
+
+		if (nbounds >= 2)
+		{
+			Datum	   *bounds;
+
+			/* Must copy the target values into anl_context */
+			old_context = MemoryContextSwitchTo(stats->anl_context);
+			bounds = (Datum *) palloc(nbounds * sizeof(Datum));
+			for (i = 0; i < nbounds; i++)
+				bounds[i] = datumCopy(hist_values[i],
+									  stats->attr->attbyval,
+									  stats->attr->attlen);
+			MemoryContextSwitchTo(old_context);
+
+			stats->stakind[slot_idx] = STATISTIC_KIND_HISTOGRAM;
+			stats->staop[slot_idx] = mystats->ltopr;
+			stats->stavalues[slot_idx] = bounds;
+			stats->numvalues[slot_idx] = nbounds;
+			slot_idx++;
+		}
+	}
+
+	store_hll_stats(stats, hll, totalrows);
+
+	return true;
+}
+
+/*
+ * Add an item to a growing array of MergeItems.
+ */
+static void
+append_merge_item(MergeItem **items, int *nitems, int *maxitems,
+				  Datum value, double count)
+{
+	if (*nitems >= *maxitems)
+	{
+		if (*maxitems == 0)
+		{
+			*maxitems = 64;
+			*items = (MergeItem *) palloc(*maxitems * sizeof(MergeItem));
+		}
+		else
+		{
+			*maxitems *= 2;
+			*items = (MergeItem *) repalloc(*items, *maxitems * sizeof(MergeItem));
+		}
+	}
+	(*items)[*nitems].value = value;
+	(*items)[*nitems].count = count;
+	(*nitems)++;
+}
+
+/*
+ * qsort_arg comparator for sorting MergeItems by value
+ */
+static int
+compare_merge_items(const void *a, const void *b, void *arg)
+{
+	Datum		da = ((MergeItem *) a)->value;
+	Datum		db = ((MergeItem *) b)->value;
+	CompareMergeItemsContext *cxt = (CompareMergeItemsContext *) arg;
+
+	return ApplySortFunction(cxt->cmpFn, cxt->cmpFlags,
+							 da, false, db, false);
+}
+
+/*
+ * qsort comparator for sorting MergeItems by decreasing count
+ */
+static int
+compare_merge_counts(const void *a, const void *b)
+{
+	double		ca = ((MergeItem *) a)->count;
+	double		cb = ((MergeItem *) b)->count;
+
+	if (ca > cb)
+		return -1;
+	if (ca < cb)
+		return 1;
+	return 0;
+}
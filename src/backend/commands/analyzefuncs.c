@@ -1,12 +1,15 @@
 #include "postgres.h"
 
 #include "access/aocssegfiles.h"
+#include "access/hash.h"
 #include "catalog/pg_appendonly_fn.h"
 #include "cdb/cdbappendonlyam.h"
 #include "cdb/cdbfilerepprimary.h"
 #include "cdb/cdbvars.h"
+#include "lib/hyperloglog.h"
 #include "storage/bufmgr.h"
 #include "utils/builtins.h"
+#include "utils/lsyscache.h"
 #include "utils/rel.h"
 #include "miscadmin.h"
 
@@ -20,6 +23,7 @@ bool			gp_statistics_use_fkeys = FALSE;
 int				gp_statistics_blocks_target = 25;
 double			gp_statistics_ndistinct_scaling_ratio_threshold = 0.10;
 double			gp_statistics_sampling_threshold = 10000;
+bool			gp_statistics_use_hll = false;
 
 /**
  * This method estimates the number of tuples and pages in a heaptable relation. Getting the number of blocks is straightforward.
@@ -370,3 +374,123 @@ gp_statistics_estimate_reltuples_relpages_oid(PG_FUNCTION_ARGS)
 
 	PG_RETURN_ARRAYTYPE_P(result);
 }
+
+/*
+ * Type information about the input of gp_hll_accum, cached in fn_extra.
+ */
+typedef struct HllAccumTypeInfo
+{
+	int16		typlen;
+	bool		typbyval;
+} HllAccumTypeInfo;
+
+/*
+ * Hash a value for a HyperLogLog sketch. We hash the binary representation,
+ * so values that are equal but stored differently (e.g. numerics with
+ * different scales) count as distinct; that is good enough for estimating
+ * the number of distinct values.
+ */
+static uint64
+hll_hash_datum(Datum value, int16 typlen, bool typbyval)
+{
+	uint64		hash;
+
+	if (typbyval)
+		hash = hash_any64((unsigned char *) &value, sizeof(Datum));
+	else if (typlen == -1)
+	{
+		struct varlena *v = PG_DETOAST_DATUM_PACKED(value);
+
+		hash = hash_any64((unsigned char *) VARDATA_ANY(v),
+						  VARSIZE_ANY_EXHDR(v));
+		if ((Pointer) v != DatumGetPointer(value))
+			pfree(v);
+	}
+	else if (typlen == -2)
+	{
+		char	   *s = DatumGetCString(value);
+
+		hash = hash_any64((unsigned char *) s, strlen(s));
+	}
+	else
+		hash = hash_any64((unsigned char *) DatumGetPointer(value), typlen);
+
+	return hash;
+}
+
+/**
+ * Transition function of the gp_hll_sketch(anyelement) aggregate, which
+ * ANALYZE uses to count the distinct values of a column on all segments
+ * in parallel. The initial state is an empty bytea, replaced by an empty
+ * sketch on the first call.
+ */
+Datum
+gp_hll_accum(PG_FUNCTION_ARGS)
+{
+	HyperLogLog *hll = (HyperLogLog *) PG_GETARG_BYTEA_P(0);
+	Datum		value = PG_GETARG_DATUM(1);
+	HllAccumTypeInfo *typinfo = (HllAccumTypeInfo *) fcinfo->flinfo->fn_extra;
+
+	if (typinfo == NULL)
+	{
+		Oid			typid = get_fn_expr_argtype(fcinfo->flinfo, 1);
+
+		if (!OidIsValid(typid))
+			ereport(ERROR,
+					(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+					 errmsg("could not determine input data type")));
+
+		typinfo = (HllAccumTypeInfo *) MemoryContextAlloc(fcinfo->flinfo->fn_mcxt,
+														  sizeof(HllAccumTypeInfo));
+		get_typlenbyval(typid, &typinfo->typlen, &typinfo->typbyval);
+		fcinfo->flinfo->fn_extra = typinfo;
+	}
+
+	/* the state lives in the aggregate context, so we can scribble on it */
+	if (!HllIsValid(hll))
+		hll = hll_create();
+
+	hll_add_hash(hll, hll_hash_datum(value, typinfo->typlen, typinfo->typbyval));
+
+	PG_RETURN_BYTEA_P(hll);
+}
+
+/**
+ * Preliminary function of the gp_hll_sketch aggregate: merge the sketches
+ * built on two segments.
+ */
+Datum
+gp_hll_merge(PG_FUNCTION_ARGS)
+{
+	HyperLogLog *hll0 = (HyperLogLog *) PG_GETARG_BYTEA_P(0);
+	HyperLogLog *hll1 = (HyperLogLog *) PG_GETARG_BYTEA_P(1);
+
+	if (!HllIsValid(hll1))
+		PG_RETURN_BYTEA_P(hll0);
+	if (!HllIsValid(hll0))
+		PG_RETURN_BYTEA_P(hll1);
+
+	hll_merge(hll0, hll1);
+
+	PG_RETURN_BYTEA_P(hll0);
+}
+
+/**
+ * Estimate the number of distinct values in a sketch built by gp_hll_sketch.
+ */
+Datum
+gp_hll_estimate(PG_FUNCTION_ARGS)
+{
+	HyperLogLog *hll = (HyperLogLog *) PG_GETARG_BYTEA_P(0);
+
+	/* no input values */
+	if (VARSIZE(hll) == VARHDRSZ)
+		PG_RETURN_FLOAT8(0.0);
+
+	if (!HllIsValid(hll))
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("invalid HyperLogLog sketch")));
+
+	PG_RETURN_FLOAT8(hll_estimate(hll));
+}
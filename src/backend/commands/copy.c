@@ -21,6 +21,9 @@
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <sys/file.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 #include "access/fileam.h"
 #include "access/heapam.h"
@@ -104,6 +107,7 @@ static int	CopyGetData(CopyState cstate, void *databuf, int datasize);
 /* byte scaning utils */
 static char *scanTextLine(CopyState cstate, const char *s, char c, size_t len);
 static char *scanCSVLine(CopyState cstate, const char *s, char c1, char c2, char c3, size_t len);
+static inline const char *scanSpecialChar(const char *s, const char *end, char c1, char c2, char c3);
 
 static void CopyExtractRowMetaData(CopyState cstate);
 static void preProcessDataLine(CopyState cstate);
@@ -3441,12 +3445,14 @@ CopyFromDispatch(CopyState cstate)
 				 * modify the data to look like:
 				 *    "<lineno>^<linebuf_converted>^<data>"
 				 */
-				appendStringInfo(&line_buf_with_lineno, "%d%c%d%c%s",
+				appendStringInfo(&line_buf_with_lineno, "%d%c%d%c",
 								 original_lineno_for_qe,
 								 COPY_METADATA_DELIM,
-								 cstate->line_buf_converted, \
-								 COPY_METADATA_DELIM, \
-								 cstate->line_buf.data);
+								 cstate->line_buf_converted,
+								 COPY_METADATA_DELIM);
+				appendBinaryStringInfo(&line_buf_with_lineno,
+									   cstate->line_buf.data,
+									   cstate->line_buf.len);
 				
 				/* send modified data */
 				cdbCopySendData(cdbCopy,
@@ -5120,8 +5126,7 @@ CopyReadAttributesText(CopyState cstate, bool * __restrict nulls,
 		*(stop-1) = delimc;
 
 		/* Find the next of: delimiter, or escape, or end of buffer */
-		for (scanner = scan_start; *scanner != delimc && *scanner != escapec; scanner++)
-			;
+		scanner = (char *) scanSpecialChar(scan_start, stop, delimc, escapec, escapec);
 		if (scanner == (stop-1) && endchar != delimc)
 		{
 			if (endchar != escapec)
@@ -5549,6 +5554,28 @@ CopyReadAttributesCSV(CopyState cstate, bool *nulls, int *attr_offsets,
 			break;
 		}
 
+		/*
+		 * Copy any run of ordinary characters in one go. They are added to
+		 * the attribute whether we are in quotes or not.
+		 */
+		{
+			const char *run = cstate->line_buf.data + cstate->line_buf.cursor;
+			const char *run_end;
+			int			run_len;
+
+			run_end = scanSpecialChar(run,
+									  cstate->line_buf.data + cstate->line_buf.len - 1,
+									  delimc, quotec, escapec);
+			run_len = run_end - run;
+			if (run_len > 0)
+			{
+				appendBinaryStringInfo(&cstate->attribute_buf, run, run_len);
+				cstate->line_buf.cursor += run_len;
+				cstate->attribute_buf.cursor += run_len;
+				continue;
+			}
+		}
+
 		c = cstate->line_buf.data[cstate->line_buf.cursor++];
 
 		/* unquoted field delimiter  */
@@ -6474,14 +6501,27 @@ scanCSVLine(CopyState cstate, const char *s, char eol, char escapec, char quotec
 	else
 		/* safe to scroll byte by byte */
 	{	
-		for ( ; *s != eol && s < end ; s++)
+		for (;;)
 		{
+			/* skip ahead to the next eol, escape or quote */
+			const char *special = scanSpecialChar(s, end, eol, escapec, quotec);
+
+			if (special != s)
+			{
+				cstate->last_was_esc = false;
+				s = special;
+			}
+
+			if (s == end || *s == eol)
+				break;
+
 			if (cstate->in_quote && *s == escapec)
 				cstate->last_was_esc = !cstate->last_was_esc;
 			if (*s == quotec && !cstate->last_was_esc)
 				cstate->in_quote = !cstate->in_quote;
 			if (*s != escapec)
 				cstate->last_was_esc = false;
+			s++;
 		}
 	}
 
@@ -6494,6 +6534,49 @@ scanCSVLine(CopyState cstate, const char *s, char eol, char escapec, char quotec
 	return ((*s == eol) ? (char *) s : NULL);
 }
 
+/*
+ * Find the first of the characters c1, c2 and c3 in the bytes from s up to
+ * (not including) end. Returns end if none of them is there.
+ *
+ * Lines and attributes are mostly made of ordinary characters, so where SSE2
+ * is available we compare 16 bytes at a time, and only look at single bytes
+ * once a chunk contains a special character. Callers must only use this when
+ * a byte can't be part of a multibyte character, as in the memchr() case of
+ * scanTextLine.
+ */
+static inline const char *
+scanSpecialChar(const char *s, const char *end, char c1, char c2, char c3)
+{
+#ifdef __SSE2__
+	const __m128i v1 = _mm_set1_epi8(c1);
+	const __m128i v2 = _mm_set1_epi8(c2);
+	const __m128i v3 = _mm_set1_epi8(c3);
+
+	while (end - s >= (int) sizeof(__m128i))
+	{
+		__m128i		chunk = _mm_loadu_si128((const __m128i *) s);
+		__m128i		match;
+		int			mask;
+
+		match = _mm_or_si128(_mm_cmpeq_epi8(chunk, v1),
+							 _mm_or_si128(_mm_cmpeq_epi8(chunk, v2),
+										  _mm_cmpeq_epi8(chunk, v3)));
+		mask = _mm_movemask_epi8(match);
+		if (mask != 0)
+			return s + __builtin_ctz(mask);
+		s += sizeof(__m128i);
+	}
+#endif
+
+	for (; s < end; s++)
+	{
+		if (*s == c1 || *s == c2 || *s == c3)
+			break;
+	}
+
+	return s;
+}
+
 /* remove end of line chars from end of a buffer */
 void truncateEol(StringInfo buf, EolType eol_type)
 {
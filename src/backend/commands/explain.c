@@ -684,6 +684,15 @@ ExplainOnePlan(PlannedStmt *plannedstmt, ParamListInfo params,
 			appendStringInfo(&buf, "PQO version %s\n", str->data);
 			pfree(str->data);
 			pfree(str);
+
+			/* time spent in each phase, unless the plan came from the cache */
+			if (queryDesc->plannedstmt->optimizerQueryToDXLTime > 0 ||
+				queryDesc->plannedstmt->optimizerSearchTime > 0 ||
+				queryDesc->plannedstmt->optimizerDXLToPlStmtTime > 0)
+				appendStringInfo(&buf, "Optimizer time: query translation %.3f ms, search %.3f ms, plan translation %.3f ms\n",
+								 queryDesc->plannedstmt->optimizerQueryToDXLTime,
+								 queryDesc->plannedstmt->optimizerSearchTime,
+								 queryDesc->plannedstmt->optimizerDXLToPlStmtTime);
     	}
     }
 #endif
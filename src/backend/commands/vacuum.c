@@ -1408,6 +1408,21 @@ get_rel_oids(List *relids, VacuumStmt *vacstmt, const char *stmttype)
 		oldcontext = MemoryContextSwitchTo(vac_context);
 		oid_list = lappend_oid(oid_list, relid);
 		oid_list = list_concat_unique_oid(oid_list, prels);
+
+		/*
+		 * With gp_statistics_use_hll, ANALYZE merges the statistics of a
+		 * partitioned table from those of its leaf partitions, so process
+		 * the partitions before their parents.
+		 */
+		if (gp_statistics_use_hll && vacstmt->analyze && prels != NIL)
+		{
+			List	   *reversed = NIL;
+			ListCell   *lc;
+
+			foreach(lc, oid_list)
+				reversed = lcons_oid(lfirst_oid(lc), reversed);
+			oid_list = reversed;
+		}
 		MemoryContextSwitchTo(oldcontext);
 	}
 	else
@@ -1417,6 +1432,8 @@ get_rel_oids(List *relids, VacuumStmt *vacstmt, const char *stmttype)
 		HeapScanDesc scan;
 		HeapTuple	tuple;
 		ScanKeyData key;
+		List	   *parent_list = NIL;
+		PartStatus	partstatus;
 
 		ScanKeyInit(&key,
 					Anum_pg_class_relkind,
@@ -1453,14 +1470,26 @@ get_rel_oids(List *relids, VacuumStmt *vacstmt, const char *stmttype)
 				 GpPersistent_IsPersistentRelation(HeapTupleGetOid(tuple)))
 				 continue;
 
+			/* Partitioned tables go after the leaf partitions, see above */
+			if (gp_statistics_use_hll && vacstmt->analyze)
+				partstatus = rel_part_status(HeapTupleGetOid(tuple));
+			else
+				partstatus = PART_STATUS_NONE;
+
 			/* Make a relation list entry for this guy */
 			oldcontext = MemoryContextSwitchTo(vac_context);
-			oid_list = lappend_oid(oid_list, HeapTupleGetOid(tuple));
+			if (partstatus == PART_STATUS_ROOT ||
+				partstatus == PART_STATUS_INTERIOR)
+				parent_list = lappend_oid(parent_list, HeapTupleGetOid(tuple));
+			else
+				oid_list = lappend_oid(oid_list, HeapTupleGetOid(tuple));
 			MemoryContextSwitchTo(oldcontext);
 		}
 
 		heap_endscan(scan);
 		heap_close(pgclass, AccessShareLock);
+
+		oid_list = list_concat(oid_list, parent_list);
 	}
 
 	return oid_list;
@@ -110,6 +110,7 @@ static HashAggEntry *lookup_agg_hash_entry(AggState *aggstate, void *input_recor
 										   InputRecordType input_type, int32 input_size,
 										   uint32 hashkey, unsigned parent_hash_bit, bool *p_isnew);
 static void agg_hash_table_stat_upd(HashAggTable *ht);
+static bool agg_hash_borrow_memory(HashAggTable *hashtable);
 static void reset_agg_hash_table(AggState *aggstate);
 static bool agg_hash_reload(AggState *aggstate);
 static inline void *mpool_cxt_alloc(void *manager, Size len);
@@ -846,6 +847,14 @@ agg_hash_initial_pass(AggState *aggstate)
 				break;
 			}
 
+			/* Before spilling, see if another operator can spare some memory */
+			if (agg_hash_borrow_memory(hashtable))
+				entry = lookup_agg_hash_entry(aggstate, (void *)outerslot,
+											  INPUT_RECORD_TUPLE, 0, hashkey, 0, &isNew);
+		}
+
+		if (entry == NULL)
+		{
 			/* CDB: Report statistics for EXPLAIN ANALYZE. */
 			if (!hashtable->is_spilling && aggstate->ss.ps.instrument)
 				agg_hash_table_stat_upd(hashtable);
@@ -1601,6 +1610,13 @@ agg_hash_reload(AggState *aggstate)
 						(errcode(ERRCODE_GP_INTERNAL_ERROR),
 								 ERRMSG_GP_INSUFFICIENT_STATEMENT_MEMORY));
 
+			if (agg_hash_borrow_memory(hashtable))
+				entry = lookup_agg_hash_entry(aggstate, input, INPUT_RECORD_GROUP_AND_AGGS, input_size,
+											  hashkey, reloaded_hash_bit, &isNew);
+		}
+
+		if (entry == NULL)
+		{
 			/* CDB: Report statistics for EXPLAIN ANALYZE. */
 			if (!hashtable->is_spilling && aggstate->ss.ps.instrument)
 				agg_hash_table_stat_upd(hashtable);
@@ -1924,6 +1940,32 @@ agg_hash_next_pass(AggState *aggstate)
 	return more;
 }
 
+/* Function: agg_hash_borrow_memory
+ *
+ * Try to raise the memory limit of the hash table with quota that other
+ * operators of the query have given back to the memory broker, so that
+ * we can keep going without spilling. Returns true if the limit was raised.
+ */
+static bool
+agg_hash_borrow_memory(HashAggTable *hashtable)
+{
+	uint64 granted;
+
+	/* Don't bother for less than an eighth of what we have */
+	granted = MemoryBroker_Request((uint64) (hashtable->max_mem / 8),
+								   (uint64) hashtable->max_mem);
+	if (granted == 0)
+		return false;
+
+	elog(HHA_MSG_LVL,
+		 "HashAgg: borrowed " UINT64_FORMAT " bytes of memory quota",
+		 granted);
+
+	hashtable->max_mem += granted;
+	hashtable->mem_borrowed += granted;
+	return true;
+}
+
 /* Function: reset_agg_hash_table
  *
  * Clear the hash table content anchored by the bucket array.
@@ -1989,6 +2031,8 @@ void destroy_agg_hash_table(AggState *aggstate)
 
 		mpool_delete(aggstate->hhashtable->group_buf);
 
+		MemoryBroker_Release((uint64) aggstate->hhashtable->mem_borrowed);
+
 		pfree(aggstate->hhashtable);
 		aggstate->hhashtable = NULL;
 	}
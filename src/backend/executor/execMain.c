@@ -5126,6 +5126,15 @@ get_part(EState *estate, Datum *values, bool *isnull, TupleDesc tupdesc)
 				(errcode(ERRCODE_NO_PARTITION_FOR_PARTITIONING_KEY),
 				 errmsg("no partition for partitioning key")));
 
+	/* Rows tend to come in runs for the same partition. */
+	if (targetid == estate->es_partition_state->last_result_partition)
+	{
+		resultRelInfo = estate->es_result_relations;
+		resultRelInfo += estate->es_partition_state->last_result_partition_offset;
+		Assert(RelationGetRelid(resultRelInfo->ri_RelationDesc) == targetid);
+		return resultRelInfo;
+	}
+
 	if (estate->es_partition_state->result_partition_hash == NULL)
 	{
 		HASHCTL ctl;
@@ -5201,6 +5210,10 @@ get_part(EState *estate, Datum *values, bool *isnull, TupleDesc tupdesc)
 			resultRelInfo->ri_partSlot = 
 				MakeSingleTupleTableSlot(resultRelInfo->ri_RelationDesc->rd_att);
 	}
+
+	estate->es_partition_state->last_result_partition = targetid;
+	estate->es_partition_state->last_result_partition_offset = entry->offset;
+
 	return resultRelInfo;
 }
 
@@ -404,13 +404,22 @@ CreateExprContext(EState *estate)
 
 	/*
 	 * Create working memory for expression evaluation in this context.
+	 *
+	 * This memory is reset after every tuple, so per-chunk bookkeeping buys
+	 * nothing here.  gp_enable_per_tuple_arena makes it an arena instead.
 	 */
-	econtext->ecxt_per_tuple_memory =
-		AllocSetContextCreate(estate->es_query_cxt,
-							  "ExprContext",
-							  ALLOCSET_DEFAULT_MINSIZE,
-							  ALLOCSET_DEFAULT_INITSIZE,
-							  ALLOCSET_DEFAULT_MAXSIZE);
+	if (gp_enable_per_tuple_arena)
+		econtext->ecxt_per_tuple_memory =
+			ArenaContextCreate(estate->es_query_cxt,
+							   "ExprContext",
+							   ARENA_DEFAULT_BLOCKSIZE);
+	else
+		econtext->ecxt_per_tuple_memory =
+			AllocSetContextCreate(estate->es_query_cxt,
+								  "ExprContext",
+								  ALLOCSET_DEFAULT_MINSIZE,
+								  ALLOCSET_DEFAULT_INITSIZE,
+								  ALLOCSET_DEFAULT_MAXSIZE);
 
 	econtext->ecxt_param_exec_vals = estate->es_param_exec_vals;
 	econtext->ecxt_param_list_info = estate->es_param_list_info;
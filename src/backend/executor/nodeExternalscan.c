@@ -30,7 +30,17 @@
 #include "optimizer/var.h"
 #include "optimizer/clauses.h"
 
+typedef struct NeededColumnsContext
+{
+	Index		scanrelid;
+	bool	   *cols;
+	bool		all;			/* a whole-row Var was found */
+} NeededColumnsContext;
+
 static TupleTableSlot *ExternalNext(ExternalScanState *node);
+static bool *ExternalScanNeededColumns(ExternalScan *node, Relation rel);
+static bool ExternalScanNeededColumnsWalker(Node *node, NeededColumnsContext *context);
+static List *ExternalScanPushdownQuals(ExternalScan *node);
 
 static bool
 ExternalConstraintCheck(TupleTableSlot *slot, ExternalScanState *node)
@@ -256,7 +266,9 @@ ExecInitExternalScan(ExternalScan *node, EState *estate, int eflags)
 									 node->rejLimit,
 									 node->rejLimitInRows,
 									 node->fmterrtbl,
-									 node->encoding);
+									 node->encoding,
+									 ExternalScanNeededColumns(node, currentRelation),
+									 ExternalScanPushdownQuals(node));
 
 	externalstate->ss.ss_currentRelation = currentRelation;
 	externalstate->ess_ScanDesc = currentScanDesc;
@@ -282,6 +294,114 @@ ExecInitExternalScan(ExternalScan *node, EState *estate, int eflags)
 }
 
 
+/*
+ * Find the columns that the target list and quals use, so that the others
+ * don't have to be converted from their external representation.
+ *
+ * Returns NULL if all columns are needed.
+ */
+static bool *
+ExternalScanNeededColumns(ExternalScan *node, Relation rel)
+{
+	NeededColumnsContext context;
+	int			natts = RelationGetNumberOfAttributes(rel);
+	int			i;
+
+	/* the partition constraints are checked on every scanned row */
+	if (rel->rd_att->constr != NULL && rel->rd_att->constr->num_check > 0)
+		return NULL;
+
+	context.scanrelid = node->scan.scanrelid;
+	context.cols = (bool *) palloc0(natts * sizeof(bool));
+	context.all = false;
+
+	ExternalScanNeededColumnsWalker((Node *) node->scan.plan.targetlist, &context);
+	ExternalScanNeededColumnsWalker((Node *) node->scan.plan.qual, &context);
+
+	for (i = 0; i < natts && !context.all; i++)
+	{
+		if (!context.cols[i])
+			return context.cols;
+	}
+
+	pfree(context.cols);
+	return NULL;
+}
+
+static bool
+ExternalScanNeededColumnsWalker(Node *node, NeededColumnsContext *context)
+{
+	if (node == NULL)
+		return false;
+	if (IsA(node, Var))
+	{
+		Var		   *var = (Var *) node;
+
+		if (var->varno == context->scanrelid && var->varlevelsup == 0)
+		{
+			if (var->varattno == InvalidAttrNumber)
+				context->all = true;
+			else if (var->varattno > 0)
+				context->cols[var->varattno - 1] = true;
+		}
+		return false;
+	}
+	return expression_tree_walker(node, ExternalScanNeededColumnsWalker,
+								  (void *) context);
+}
+
+/*
+ * Collect the quals of the form "Var op Const", commuted if needed so that
+ * the Var is on the left, to let the formatter or protocol skip the data that
+ * can't match them. The scan still checks all quals on the rows it gets.
+ */
+static List *
+ExternalScanPushdownQuals(ExternalScan *node)
+{
+	List	   *quals = NIL;
+	ListCell   *lc;
+
+	foreach(lc, node->scan.plan.qual)
+	{
+		OpExpr	   *op = (OpExpr *) lfirst(lc);
+		Node	   *left;
+		Node	   *right;
+		Oid			opno;
+
+		if (!IsA(op, OpExpr) || list_length(op->args) != 2)
+			continue;
+
+		left = (Node *) linitial(op->args);
+		right = (Node *) lsecond(op->args);
+		opno = op->opno;
+
+		if (IsA(right, Var) && IsA(left, Const))
+		{
+			Node	   *tmp = left;
+
+			left = right;
+			right = tmp;
+			opno = get_commutator(opno);
+			if (!OidIsValid(opno))
+				continue;
+		}
+
+		if (!IsA(left, Var) || !IsA(right, Const))
+			continue;
+		if (((Var *) left)->varno != node->scan.scanrelid ||
+			((Var *) left)->varlevelsup != 0 ||
+			((Var *) left)->varattno <= 0 ||
+			((Const *) right)->constisnull)
+			continue;
+
+		quals = lappend(quals, make_opclause(opno, op->opresulttype, false,
+											 (Expr *) copyObject(left),
+											 (Expr *) copyObject(right)));
+	}
+
+	return quals;
+}
+
 int
 ExecCountSlotsExternalScan(ExternalScan *node)
 {
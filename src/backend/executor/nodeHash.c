@@ -42,8 +42,10 @@
 
 #include "cdb/cdbexplain.h"
 #include "cdb/cdbvars.h"
+#include "cdb/memquota.h"
 
 static void ExecHashIncreaseNumBatches(HashJoinTable hashtable);
+static bool ExecHashBorrowSpace(HashJoinTable hashtable, Size spaceNeeded);
 static void ExecHashTableExplainEnd(PlanState *planstate, struct StringInfoData *buf);
 static void
 ExecHashTableExplainBatches(HashJoinTable   hashtable,
@@ -150,6 +152,21 @@ MultiExecHash(HashState *node)
 	/* Now we have set up all the initial batches & primary overflow batches. */
 	hashtable->nbatch_outstart = hashtable->nbatch;
 
+	/*
+	 * If the whole inner side fit in memory, the table won't grow any more.
+	 * Offer the rest of our quota to the other operators of this query.
+	 */
+	if (gp_resqueue_memory_broker &&
+		hashtable->nbatch == 1 &&
+		hashtable->spaceAllowed > hashtable->batches[0]->innerspace)
+	{
+		Size		unused = hashtable->spaceAllowed - hashtable->batches[0]->innerspace;
+
+		hashtable->spaceAllowed -= unused;
+		hashtable->spaceReleased += unused;
+		MemoryBroker_Release(unused);
+	}
+
 	/* must provide our own instrumentation support */
 	if (node->ps.instrument)
 		InstrStopNode(node->ps.instrument, hashtable->totalTuples);
@@ -186,6 +203,7 @@ ExecInitHash(Hash *node, EState *estate, int eflags)
 	hashstate->ps.state = estate;
 	hashstate->hashtable = NULL;
 	hashstate->hashkeys = NIL;	/* will be set by parent HashJoin */
+	hashstate->hs_spaceLent = 0;
 
 	/*
 	 * Miscellaneous initialization
@@ -323,10 +341,25 @@ ExecHashTableCreate(HashState *hashState, HashJoinState *hjstate, List *hashOper
 	hashtable->work_set = NULL;
 	hashtable->state_file = NULL;
 	hashtable->spaceAllowed = operatorMemKB * 1024L;
+	hashtable->spaceReleased = 0;
+	hashtable->spaceBorrowed = 0;
 	hashtable->stats = NULL;
 	hashtable->eagerlyReleased = false;
 	hashtable->hjstate = hjstate;
 
+	/*
+	 * If the table is rebuilt for a rescan, quota that the previous table lent
+	 * out may still be in use by the borrower. Don't count it as ours again
+	 * until the broker gives it back, see ExecHashTableDestroy.
+	 */
+	if (hashState->hs_spaceLent > 0)
+	{
+		Assert(hashState->hs_spaceLent <= hashtable->spaceAllowed);
+		hashtable->spaceAllowed -= hashState->hs_spaceLent;
+		hashtable->spaceReleased = hashState->hs_spaceLent;
+		hashState->hs_spaceLent = 0;
+	}
+
 	/*
 	 * Get info about the hash functions to be used for each hash key. Also
 	 * remember whether the join operators are strict.
@@ -703,10 +736,46 @@ ExecHashTableDestroy(HashState *hashState, HashJoinTable hashtable)
 	/* Release working memory (batchCxt is a child, so it goes away too) */
 	MemoryContextDelete(hashtable->hashCxt);
 	hashtable->batches = NULL;
+
+	/*
+	 * Settle up with the memory broker. Whatever we lent that another
+	 * operator still holds stays lent, in case the table is rebuilt.
+	 */
+	hashState->hs_spaceLent = hashtable->spaceReleased -
+		MemoryBroker_Reclaim(hashtable->spaceReleased);
+	MemoryBroker_Release(hashtable->spaceBorrowed);
+	hashtable->spaceReleased = 0;
+	hashtable->spaceBorrowed = 0;
 	}
 	END_MEMORY_ACCOUNT();
 }
 
+/*
+ * ExecHashBorrowSpace
+ *		try to raise spaceAllowed to at least spaceNeeded with quota borrowed
+ *		from the memory broker, instead of spilling to more batches.
+ *		Returns true if spaceAllowed now covers spaceNeeded.
+ */
+static bool
+ExecHashBorrowSpace(HashJoinTable hashtable, Size spaceNeeded)
+{
+	Size		shortfall;
+	uint64		granted;
+
+	Assert(spaceNeeded > hashtable->spaceAllowed);
+	shortfall = spaceNeeded - hashtable->spaceAllowed;
+
+	/* Leave some headroom, so that we don't come back for every tuple */
+	granted = MemoryBroker_Request(shortfall,
+								   shortfall + hashtable->spaceAllowed / 2);
+	if (granted == 0)
+		return false;
+
+	hashtable->spaceAllowed += granted;
+	hashtable->spaceBorrowed += granted;
+	return true;
+}
+
 /*
  * ExecHashIncreaseNumBatches
  *		increase the original number of batches in order to reduce
@@ -971,9 +1040,13 @@ ExecHashTableInsert(HashState *hashState, HashJoinTable hashtable,
 		if(gp_hashjoin_bloomfilter!=0)
 			hashtable->bloom[bucketno] |= BLOOMVAL(hashvalue);
 
-		/* Double the number of batches when too much data in hash table. */
-		if (batch->innerspace > hashtable->spaceAllowed ||
-			batch->innertuples > UINT_MAX/2)
+		/*
+		 * Double the number of batches when too much data in hash table,
+		 * unless the memory broker can lend us the space.
+		 */
+		if (batch->innertuples > UINT_MAX/2 ||
+			(batch->innerspace > hashtable->spaceAllowed &&
+			 !ExecHashBorrowSpace(hashtable, batch->innerspace)))
 		{
 			ExecHashIncreaseNumBatches(hashtable);
 
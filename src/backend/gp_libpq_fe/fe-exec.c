@@ -1035,11 +1035,12 @@ fail:
 	return 0;
 }
 
-int
-PQsendGpQuery_shared(PGconn *conn, char *shared_query, int query_len, bool nonblock)
+/*
+ * Install a shared mpp-query string as the connection's outgoing message.
+ */
+static int
+installGpQuery_shared(PGconn *conn, char *shared_query, int query_len)
 {
-	int ret;
-
 	if (!PQsendQueryStart(conn))
 		return 0;
 
@@ -1073,6 +1074,17 @@ PQsendGpQuery_shared(PGconn *conn, char *shared_query, int query_len, bool nonbl
 	/* remember we are using simple query protocol */
 	conn->queryclass = PGQUERY_SIMPLE;
 
+	return 1;
+}
+
+int
+PQsendGpQuery_shared(PGconn *conn, char *shared_query, int query_len, bool nonblock)
+{
+	int ret;
+
+	if (!installGpQuery_shared(conn, shared_query, query_len))
+		return 0;
+
 	/*
 	 * Give the data a push.  In nonblock mode, don't complain if we're unable
 	 * to send it all; PQgetResult() will do any additional flushing needed.
@@ -1093,6 +1105,27 @@ PQsendGpQuery_shared(PGconn *conn, char *shared_query, int query_len, bool nonbl
 	return 1;
 }
 
+/*
+ * PQstageGpQuery_shared
+ *	 Like PQsendGpQuery_shared, but don't push any data to the socket yet.
+ *
+ * The caller is responsible for flushing the connection afterwards, e.g.
+ * with pqFlushNonBlocking(). This lets the dispatcher stage the same query
+ * on many connections first and push them all in one batch.
+ *
+ * Returns: 1 if successfully staged
+ *			0 if error (conn->errorMessage is set)
+ */
+int
+PQstageGpQuery_shared(PGconn *conn, char *shared_query, int query_len)
+{
+	if (!installGpQuery_shared(conn, shared_query, query_len))
+		return 0;
+
+	conn->asyncStatus = PGASYNC_BUSY;
+	return 1;
+}
+
 
 /*
  * PQsendQuery
@@ -407,6 +407,9 @@ extern int PQsendGpQuery_shared(PGconn       *conn,
 								 char         *query,
 								 int          query_len,
 								 bool         nonblock);
+extern int PQstageGpQuery_shared(PGconn       *conn,
+								  char         *query,
+								  int          query_len);
 
 /* Interface for multiple-result or asynchronous queries */
 extern int	PQsendQuery(PGconn *conn, const char *query);
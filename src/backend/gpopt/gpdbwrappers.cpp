@@ -1249,6 +1249,11 @@ gpdb::PpnParts
 	GP_WRAP_START;
 	{
 		/* catalog tables: pg_partition, pg_partition_rule */
+		if (0 == level && InvalidOid == parent && includesubparts)
+		{
+			/* the whole tree comes from the backend's partition descriptor cache */
+			return RelationBuildPartitionDescByOid(relid, inctemplate);
+		}
 		return get_parts(relid, level, parent, inctemplate, includesubparts);
 	}
 	GP_WRAP_END;
@@ -2841,16 +2846,29 @@ gpdb::UlLeafPartitions
 }
 
 /*
- * To detect changes to catalog tables that require resetting the Metadata
- * Cache, we use the normal PostgreSQL catalog cache invalidation mechanism.
- * We register a callback to a cache on all the catalog tables that contain
- * information that's contained in the ORCA metadata cache.
-
- * There is no fine-grained mechanism in the metadata cache for invalidating
- * individual entries ATM, so we just blow the whole cache whenever anything
- * changes. The callback simply increments a counter. Whenever we start
- * planning a query, we check the counter to see if it has changed since the
- * last planned query, and reset the whole cache if it has.
+ * To detect changes to catalog tables that affect the Metadata Cache, we use
+ * the normal PostgreSQL catalog cache invalidation mechanism. We register a
+ * callback to a cache on all the catalog tables that contain information
+ * that's contained in the ORCA metadata cache.
+ *
+ * The callbacks run while invalidation messages are being processed, where
+ * we cannot access the catalogs, so they merely remember what changed: the
+ * cache id, TID and hash value of each invalidated catalog tuple, and the OID
+ * of each invalidated relcache entry. Whenever we start planning a query, we
+ * look at the remembered catalog tuples to find out which objects they
+ * describe, and hand the list of those objects back to the caller, which
+ * evicts only the corresponding entries from the metadata cache.
+ *
+ * A TID alone is not a reliable identifier: the tuple may have been pruned
+ * and the slot reused by the time we get to look at it. So we fetch the
+ * tuple regardless of visibility and check that its hash value in the
+ * syscache matches the one carried by the invalidation message. If it doesn't,
+ * or the tuple is gone altogether, we don't know what changed and fall back
+ * to resetting the whole cache. We do the same when too many invalidations
+ * pile up between two queries, when the whole syscache or relcache is reset
+ * (e.g. after a sinval queue overflow), and for catalogs whose contents end up
+ * in entries that are not keyed by the OID of the changed object, see
+ * mdsyscache_invalidation_callback().
  *
  * To make sure we've covered all catalog tables that contain information
  * that's stored in the metadata cache, there are "catalog tables: xxx"
@@ -2859,20 +2877,103 @@ gpdb::UlLeafPartitions
  * anything fetched via the wrapper functions in this file can end up in the
  * metadata cache and hence need to have an invalidation callback registered.
  */
-static bool mdcache_invalidation_counter_registered = false;
-static int64 mdcache_invalidation_counter = 0;
-static int64 last_mdcache_invalidation_counter = 0;
+#define MDCACHE_MAX_PENDING_INVALS	256
+
+typedef struct MDCachePendingCatInval
+{
+	int			cacheid;
+	ItemPointerData tuplePtr;
+	uint32		hashValue;
+} MDCachePendingCatInval;
+
+static bool mdcache_invalidation_callbacks_registered = false;
+
+/* set when the pending invalidations are not enough to tell what changed */
+static bool mdcache_reset_pending = false;
+
+/* set while we resolve pending invalidations, in case we error out */
+static bool mdcache_resolving_invalidations = false;
+
+static MDCachePendingCatInval mdcache_pending_catinvals[MDCACHE_MAX_PENDING_INVALS];
+static int	mdcache_num_pending_catinvals = 0;
+static Oid	mdcache_pending_relinvals[MDCACHE_MAX_PENDING_INVALS];
+static int	mdcache_num_pending_relinvals = 0;
 
 static void
-mdsyscache_invalidation_counter_callback(Datum arg, int cacheid,  ItemPointer tuplePtr)
+mdsyscache_invalidation_callback(Datum arg, int cacheid, ItemPointer tuplePtr, uint32 hashValue)
 {
-	mdcache_invalidation_counter++;
+	int			i;
+
+	if (mdcache_reset_pending)
+		return;
+
+	/*
+	 * Casts and scalar comparisons are cached under the pair of types they
+	 * apply to, and type entries embed the OIDs of their operators and
+	 * aggregates. A change in any of the catalogs below can thus affect
+	 * entries we cannot identify from the changed tuple, so blow the whole
+	 * cache. These catalogs rarely change outside of extension DDL.
+	 */
+	if (tuplePtr == NULL ||
+		cacheid == AGGFNOID ||
+		cacheid == AMOPOPID ||
+		cacheid == CASTSOURCETARGET ||
+		cacheid == OPEROID ||
+		cacheid == OPFAMILYOID)
+	{
+		mdcache_reset_pending = true;
+		return;
+	}
+
+	for (i = 0; i < mdcache_num_pending_catinvals; i++)
+	{
+		MDCachePendingCatInval *inval = &mdcache_pending_catinvals[i];
+
+		if (inval->cacheid == cacheid &&
+			inval->hashValue == hashValue &&
+			ItemPointerEquals(&inval->tuplePtr, tuplePtr))
+			return;
+	}
+
+	if (mdcache_num_pending_catinvals >= MDCACHE_MAX_PENDING_INVALS)
+	{
+		mdcache_reset_pending = true;
+		return;
+	}
+
+	mdcache_pending_catinvals[mdcache_num_pending_catinvals].cacheid = cacheid;
+	mdcache_pending_catinvals[mdcache_num_pending_catinvals].tuplePtr = *tuplePtr;
+	mdcache_pending_catinvals[mdcache_num_pending_catinvals].hashValue = hashValue;
+	mdcache_num_pending_catinvals++;
 }
 
 static void
-mdrelcache_invalidation_counter_callback(Datum arg, Oid relid)
+mdrelcache_invalidation_callback(Datum arg, Oid relid)
 {
-	mdcache_invalidation_counter++;
+	int			i;
+
+	if (mdcache_reset_pending)
+		return;
+
+	if (!OidIsValid(relid))
+	{
+		mdcache_reset_pending = true;
+		return;
+	}
+
+	for (i = 0; i < mdcache_num_pending_relinvals; i++)
+	{
+		if (mdcache_pending_relinvals[i] == relid)
+			return;
+	}
+
+	if (mdcache_num_pending_relinvals >= MDCACHE_MAX_PENDING_INVALS)
+	{
+		mdcache_reset_pending = true;
+		return;
+	}
+
+	mdcache_pending_relinvals[mdcache_num_pending_relinvals++] = relid;
 }
 
 static void
@@ -2934,40 +3035,247 @@ register_mdcache_invalidation_callbacks(void)
 	for (i = 0; i < lengthof(metadata_caches); i++)
 	{
 		CacheRegisterSyscacheCallback(metadata_caches[i],
-									  &mdsyscache_invalidation_counter_callback,
+									  &mdsyscache_invalidation_callback,
 									  (Datum) 0);
 	}
 
 	/* also register the relcache callback */
-	CacheRegisterRelcacheCallback(&mdrelcache_invalidation_counter_callback,
+	CacheRegisterRelcacheCallback(&mdrelcache_invalidation_callback,
 								  (Datum) 0);
 }
 
-// Has there been any catalog changes since last call?
+/*
+ * Add an entry to the list of metadata cache entries to evict. For relations,
+ * we also report an upper bound on the number of columns, so that the caller
+ * knows how many column statistics entries there may be.
+ */
+static List *
+append_mdcache_inval(List *invals, MDCacheInvalKind kind, Oid oid)
+{
+	MDCacheInval *inval;
+
+	if (!OidIsValid(oid))
+		return invals;
+
+	inval = (MDCacheInval *) palloc(sizeof(MDCacheInval));
+	inval->kind = kind;
+	inval->oid = oid;
+	inval->natts = 0;
+
+	if (kind != MDCacheInvalObject)
+	{
+		HeapTuple	reltup;
+
+		reltup = SearchSysCache(RELOID, ObjectIdGetDatum(oid), 0, 0, 0);
+		if (HeapTupleIsValid(reltup))
+		{
+			inval->natts = ((Form_pg_class) GETSTRUCT(reltup))->relnatts;
+			ReleaseSysCache(reltup);
+		}
+	}
+
+	return lappend(invals, inval);
+}
+
+/*
+ * Work out which metadata cache entries are affected by an invalidated catalog
+ * tuple, and append them to *invals. Returns false if the tuple that the
+ * invalidation was about cannot be found anymore.
+ */
+static bool
+resolve_mdcache_catalog_invalidation(MDCachePendingCatInval *pending, List **invals)
+{
+	HeapTuple	tuple;
+
+	/* catalog tables: pg_constraint, pg_partition, pg_partition_rule,
+	 * pg_statistic, pg_type, pg_proc */
+	tuple = SearchSysCacheByTid(pending->cacheid, &pending->tuplePtr, pending->hashValue);
+	if (!HeapTupleIsValid(tuple))
+		return false;
+
+	switch (pending->cacheid)
+	{
+		case CONSTROID:
+			/* dropping a constraint also invalidates its relation's relcache entry */
+			*invals = append_mdcache_inval(*invals, MDCacheInvalObject,
+										   HeapTupleGetOid(tuple));
+			*invals = append_mdcache_inval(*invals, MDCacheInvalRelation,
+										   get_check_constraint_relid(HeapTupleGetOid(tuple)));
+			break;
+
+		case PARTOID:
+			*invals = append_mdcache_inval(*invals, MDCacheInvalRelation,
+										   ((Form_pg_partition) GETSTRUCT(tuple))->parrelid);
+			break;
+
+		case PARTRULEOID:
+		{
+			Form_pg_partition_rule rule = (Form_pg_partition_rule) GETSTRUCT(tuple);
+			HeapTuple	partup;
+
+			/* the partitioned table's entry describes all its parts */
+			partup = SearchSysCache(PARTOID, ObjectIdGetDatum(rule->paroid), 0, 0, 0);
+			if (HeapTupleIsValid(partup))
+			{
+				*invals = append_mdcache_inval(*invals, MDCacheInvalRelation,
+											   ((Form_pg_partition) GETSTRUCT(partup))->parrelid);
+				ReleaseSysCache(partup);
+			}
+			*invals = append_mdcache_inval(*invals, MDCacheInvalRelation,
+										   rule->parchildrelid);
+			break;
+		}
+
+		case STATRELATT:
+			*invals = append_mdcache_inval(*invals, MDCacheInvalRelStats,
+										   ((Form_pg_statistic) GETSTRUCT(tuple))->starelid);
+			break;
+
+		case TYPEOID:
+		case PROCOID:
+			*invals = append_mdcache_inval(*invals, MDCacheInvalObject,
+										   HeapTupleGetOid(tuple));
+			break;
+
+		default:
+			elog(ERROR, "unexpected cache id %d in metadata cache invalidation",
+				 pending->cacheid);
+	}
+
+	heap_freetuple(tuple);
+
+	return true;
+}
+
+// Has there been any catalog changes since last call? If only some objects
+// were affected, return false and the list of MDCacheInval entries for them
+// in *pplMDInval.
 bool
 gpdb::FMDCacheNeedsReset
 		(
-			void
+			List **pplMDInval
 		)
 {
+	*pplMDInval = NIL;
+
 	GP_WRAP_START;
 	{
-		if (!mdcache_invalidation_counter_registered)
+		MDCachePendingCatInval *catinvals;
+		Oid		   *relinvals;
+		int			ncatinvals;
+		int			nrelinvals;
+		bool		reset;
+		int			i;
+
+		if (!mdcache_invalidation_callbacks_registered)
 		{
 			register_mdcache_invalidation_callbacks();
-			mdcache_invalidation_counter_registered = true;
+			mdcache_invalidation_callbacks_registered = true;
 		}
-		if (last_mdcache_invalidation_counter == mdcache_invalidation_counter)
-			return false;
-		else
+
+		/*
+		 * Take over the pending invalidations. Looking up the catalogs below
+		 * processes incoming invalidation messages, which will be queued up
+		 * for the next call. If we error out half-way, the next call resets
+		 * the whole cache.
+		 */
+		reset = mdcache_reset_pending || mdcache_resolving_invalidations;
+		ncatinvals = mdcache_num_pending_catinvals;
+		nrelinvals = mdcache_num_pending_relinvals;
+		catinvals = (MDCachePendingCatInval *) palloc((ncatinvals + 1) * sizeof(MDCachePendingCatInval));
+		relinvals = (Oid *) palloc((nrelinvals + 1) * sizeof(Oid));
+		memcpy(catinvals, mdcache_pending_catinvals, ncatinvals * sizeof(MDCachePendingCatInval));
+		memcpy(relinvals, mdcache_pending_relinvals, nrelinvals * sizeof(Oid));
+
+		mdcache_reset_pending = false;
+		mdcache_num_pending_catinvals = 0;
+		mdcache_num_pending_relinvals = 0;
+
+		mdcache_resolving_invalidations = true;
+		for (i = 0; !reset && i < nrelinvals; i++)
+			*pplMDInval = append_mdcache_inval(*pplMDInval, MDCacheInvalRelation, relinvals[i]);
+		for (i = 0; !reset && i < ncatinvals; i++)
+			reset = !resolve_mdcache_catalog_invalidation(&catinvals[i], pplMDInval);
+		mdcache_resolving_invalidations = false;
+
+		pfree(relinvals);
+		pfree(catinvals);
+
+		if (reset)
 		{
-			last_mdcache_invalidation_counter = mdcache_invalidation_counter;
-			return true;
+			list_free_deep(*pplMDInval);
+			*pplMDInval = NIL;
 		}
+
+		return reset;
 	}
 	GP_WRAP_END;
 
 	return true;
 }
 
+uint64
+gpdb::UllMDSharedCacheObjectVersion
+	(
+	Oid oid
+	)
+{
+	GP_WRAP_START;
+	{
+		return MDSharedCacheObjectVersion(oid);
+	}
+	GP_WRAP_END;
+
+	return 0;
+}
+
+uint64
+gpdb::UllMDSharedCacheStatsVersion
+	(
+	Oid oidRelation,
+	int iAttno
+	)
+{
+	GP_WRAP_START;
+	{
+		/* catalog tables: pg_statistic */
+		return MDSharedCacheStatsVersion(oidRelation, (AttrNumber) iAttno);
+	}
+	GP_WRAP_END;
+
+	return 0;
+}
+
+char *
+gpdb::SzMDSharedCacheLookup
+	(
+	const char *szKey,
+	uint64 ullVersion
+	)
+{
+	GP_WRAP_START;
+	{
+		return MDSharedCacheLookup(szKey, ullVersion);
+	}
+	GP_WRAP_END;
+
+	return NULL;
+}
+
+void
+gpdb::MDSharedCacheInsert
+	(
+	const char *szKey,
+	uint64 ullVersion,
+	const char *szDXL
+	)
+{
+	GP_WRAP_START;
+	{
+		::MDSharedCacheInsert(szKey, ullVersion, szDXL);
+		return;
+	}
+	GP_WRAP_END;
+}
+
 // EOF
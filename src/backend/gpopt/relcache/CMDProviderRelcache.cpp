@@ -17,9 +17,16 @@
 #include "postgres.h"
 #include "gpopt/relcache/CMDProviderRelcache.h"
 #include "gpopt/translate/CTranslatorRelcacheToDXL.h"
+#include "gpopt/translate/CTranslatorUtils.h"
 #include "gpopt/mdcache/CMDAccessor.h"
+#include "gpopt/gpdbwrappers.h"
+#include "utils/guc.h"
 
 #include "naucrates/dxl/CDXLUtils.h"
+#include "naucrates/md/CMDIdGPDB.h"
+#include "naucrates/md/CMDIdRelStats.h"
+#include "naucrates/md/CMDIdColStats.h"
+#include "naucrates/md/IMDRelation.h"
 
 #include "naucrates/exception.h"
 
@@ -45,12 +52,110 @@ CMDProviderRelcache::CMDProviderRelcache
 	GPOS_ASSERT(NULL != m_pmp);
 }
 
+//---------------------------------------------------------------------------
+//	@function:
+//		CMDProviderRelcache::FSharedVersion
+//
+//	@doc:
+//		Compute the version of the given object in the shared MDCache.
+//		Returns false if objects of this kind are not kept in the shared
+//		MDCache
+//
+//---------------------------------------------------------------------------
+BOOL
+CMDProviderRelcache::FSharedVersion
+	(
+	CMDAccessor *pmda,
+	IMDId *pmdid,
+	ULLONG *pullVersion
+	)
+{
+	switch (pmdid->Emdidt())
+	{
+		case IMDId::EmdidGPDB:
+			*pullVersion = gpdb::UllMDSharedCacheObjectVersion(CMDIdGPDB::PmdidConvert(pmdid)->OidObjectId());
+			return true;
+
+		case IMDId::EmdidRelStats:
+		{
+			IMDId *pmdidRel = CMDIdRelStats::PmdidConvert(pmdid)->PmdidRel();
+			OID oidRelation = CMDIdGPDB::PmdidConvert(pmdidRel)->OidObjectId();
+
+			*pullVersion = gpdb::UllMDSharedCacheStatsVersion(oidRelation, InvalidAttrNumber);
+			return true;
+		}
+
+		case IMDId::EmdidColStats:
+		{
+			CMDIdColStats *pmdidColStats = CMDIdColStats::PmdidConvert(pmdid);
+			IMDId *pmdidRel = pmdidColStats->PmdidRel();
+			OID oidRelation = CMDIdGPDB::PmdidConvert(pmdidRel)->OidObjectId();
+			const IMDColumn *pmdcol = pmda->Pmdrel(pmdidRel)->Pmdcol(pmdidColStats->UlPos());
+
+			*pullVersion = gpdb::UllMDSharedCacheStatsVersion(oidRelation, pmdcol->IAttno());
+			return true;
+		}
+
+		default:
+			return false;
+	}
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CMDProviderRelcache::FShareable
+//
+//	@doc:
+//		Can the DXL of the given object be kept in the shared MDCache?
+//		Indexes, triggers, check constraints, casts and comparisons are
+//		looked up by mdids whose version we cannot track, so they stay in
+//		the backend-local cache only
+//
+//---------------------------------------------------------------------------
+BOOL
+CMDProviderRelcache::FShareable
+	(
+	const IMDCacheObject *pimdobj,
+	const CWStringBase *pstr
+	)
+{
+	switch (pimdobj->Emdt())
+	{
+		case IMDCacheObject::EmdtRel:
+		case IMDCacheObject::EmdtType:
+		case IMDCacheObject::EmdtFunc:
+		case IMDCacheObject::EmdtAgg:
+		case IMDCacheObject::EmdtOp:
+		case IMDCacheObject::EmdtRelStats:
+		case IMDCacheObject::EmdtColStats:
+			break;
+
+		default:
+			return false;
+	}
+
+	// the shared cache stores plain character strings, only keep objects
+	// which survive the conversion unchanged
+	const WCHAR *wsz = pstr->Wsz();
+	for (ULONG ul = 0; ul < pstr->UlLength(); ul++)
+	{
+		if (0x7f < (ULONG) wsz[ul])
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
 //---------------------------------------------------------------------------
 //	@function:
 //		CMDProviderRelcache::PstrObject
 //
 //	@doc:
-//		Returns the DXL of the requested object in the provided memory pool
+//		Returns the DXL of the requested object in the provided memory pool.
+//		On the master, the DXL is first looked up in the MDCache shared by
+//		all sessions, and newly translated objects are added to it
 //
 //---------------------------------------------------------------------------
 CWStringBase *
@@ -62,12 +167,44 @@ CMDProviderRelcache::PstrObject
 	)
 	const
 {
+	CHAR *szKey = NULL;
+	ULLONG ullVersion = 0;
+
+	// the version must be read before translating the object, so that
+	// concurrent catalog changes make our copy stale rather than the other
+	// way around
+	if (0 < optimizer_mdcache_shared_size && FSharedVersion(pmda, pmdid, &ullVersion))
+	{
+		szKey = CTranslatorUtils::SzFromWsz(pmdid->Wsz());
+
+		CHAR *szDXL = gpdb::SzMDSharedCacheLookup(szKey, ullVersion);
+		if (NULL != szDXL)
+		{
+			CWStringDynamic *pstr = CDXLUtils::PstrFromSz(m_pmp, szDXL);
+			gpdb::GPDBFree(szDXL);
+			gpdb::GPDBFree(szKey);
+
+			return pstr;
+		}
+	}
+
 	IMDCacheObject *pimdobj = CTranslatorRelcacheToDXL::Pimdobj(pmp, pmda, pmdid);
 
 	GPOS_ASSERT(NULL != pimdobj);
 
 	CWStringDynamic *pstr = CDXLUtils::PstrSerializeMDObj(m_pmp, pimdobj, true /*fSerializeHeaders*/, false /*findent*/);
 
+	if (NULL != szKey)
+	{
+		if (FShareable(pimdobj, pstr))
+		{
+			CHAR *szDXL = CTranslatorUtils::SzFromWsz(pstr->Wsz());
+			gpdb::MDSharedCacheInsert(szKey, ullVersion, szDXL);
+			gpdb::GPDBFree(szDXL);
+		}
+		gpdb::GPDBFree(szKey);
+	}
+
 	// cleanup DXL object
 	pimdobj->Release();
 
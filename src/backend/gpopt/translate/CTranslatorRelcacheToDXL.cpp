@@ -2245,11 +2245,7 @@ CTranslatorRelcacheToDXL::PimdobjColStats
 
 		if (!pmdcol->FDropped())
 		{
-			CMDIdGPDB *pmdidAttType = GPOS_NEW(pmp) CMDIdGPDB(oidAttType);
-			IMDType *pmdtype = Pmdtype(pmp, pmdidAttType);
-			dWidth = CStatisticsUtils::DDefaultColumnWidth(pmdtype);
-			pmdtype->Release();
-			pmdidAttType->Release();
+			dWidth = CStatisticsUtils::DDefaultColumnWidth(pmda->Pmdtype(pmdcol->PmdidType()));
 		}
 
 		return CDXLColStats::PdxlcolstatsDummy(pmp, pmdidColStats, pmdnameCol, dWidth);
@@ -2341,7 +2337,7 @@ CTranslatorRelcacheToDXL::PimdobjColStats
 			PdrgpdxlbucketTransformStats
 					(
 					pmp,
-					oidAttType,
+					pmda->Pmdtype(pmdcol->PmdidType()),
 					dDistinct,
 					dNullFrequency,
 					pdrgdatumMCVValues,
@@ -2645,7 +2641,7 @@ DrgPdxlbucket *
 CTranslatorRelcacheToDXL::PdrgpdxlbucketTransformStats
 	(
 	IMemoryPool *pmp,
-	OID oidAttType,
+	const IMDType *pmdtype,
 	CDouble dDistinct,
 	CDouble dNullFreq,
 	const Datum *pdrgdatumMCVValues,
@@ -2655,9 +2651,6 @@ CTranslatorRelcacheToDXL::PdrgpdxlbucketTransformStats
 	ULONG ulNumHistValues
 	)
 {
-	CMDIdGPDB *pmdidAttType = GPOS_NEW(pmp) CMDIdGPDB(oidAttType);
-	IMDType *pmdtype = Pmdtype(pmp, pmdidAttType);
-
 	// translate MCVs to Orca histogram. Create an empty histogram if there are no MCVs.
 	CHistogram *phistGPDBMCV = PhistTransformGPDBMCV
 							(
@@ -2724,8 +2717,6 @@ CTranslatorRelcacheToDXL::PdrgpdxlbucketTransformStats
 	}
 
 	// cleanup
-	pmdidAttType->Release();
-	pmdtype->Release();
 	GPOS_DELETE(phistGPDBMCV);
 
 	if (NULL != phistGPDBHist)
@@ -2814,15 +2805,32 @@ CTranslatorRelcacheToDXL::PhistTransformGPDBHist
 	CDouble dFreqPerBucket = dFreqHist / CDouble(ulNumBuckets);
 
 	const ULONG ulBuckets = ulNumHistValues - 1;
-	// create buckets
+	// create buckets; each boundary is translated once, and the point is
+	// shared by the two buckets on either side of it
 	DrgPbucket *pdrgppbucket = GPOS_NEW(pmp) DrgPbucket(pmp);
+	CPoint *ppMin = GPOS_NEW(pmp) CPoint(CTranslatorScalarToDXL::Pdatum(pmp, pmdtype, false /* fNull */, pdrgdatumHistValues[0]));
 	for (ULONG ul = 0; ul < ulBuckets; ul++)
 	{
-		Datum datumMin = pdrgdatumHistValues[ul];
-		IDatum *pdatumMin = CTranslatorScalarToDXL::Pdatum(pmp, pmdtype, false /* fNull */, datumMin);
+		IDatum *pdatumMin = ppMin->Pdatum();
 
 		Datum datumMax = pdrgdatumHistValues[ul + 1];
 		IDatum *pdatumMax = CTranslatorScalarToDXL::Pdatum(pmp, pmdtype, false /* fNull */, datumMax);
+		CPoint *ppMax = GPOS_NEW(pmp) CPoint(pdatumMax);
+
+		if (!pdatumMin->FStatsComparable(pdatumMin) || !pdatumMin->FStatsLessThan(pdatumMax))
+		{
+			// if less than operation is not supported on this datum,
+			// or the translated histogram does not conform to GPDB sort order (e.g. text column in Linux platform),
+			// then no point building a histogram. return an empty histogram
+
+			// TODO: 03/01/2014 translate histogram into Orca even if sort
+			// order is different in GPDB, and use const expression eval to compare
+			// datums in Orca (MPP-22780)
+			ppMin->Release();
+			ppMax->Release();
+			pdrgppbucket->Release();
+			return GPOS_NEW(pmp) CHistogram(GPOS_NEW(pmp) DrgPbucket(pmp));
+		}
 
 		BOOL fLowerClosed = true; // GPDB histograms assumes lower bound to be closed
 		BOOL fUpperClosed = false; // GPDB histograms assumes upper bound to be open
@@ -2832,10 +2840,12 @@ CTranslatorRelcacheToDXL::PhistTransformGPDBHist
 			fUpperClosed = true;
 		}
 
+		// the upper bound is also the lower bound of the next bucket
+		ppMax->AddRef();
 		CBucket *pbucket = GPOS_NEW(pmp) CBucket
 									(
-									GPOS_NEW(pmp) CPoint(pdatumMin),
-									GPOS_NEW(pmp) CPoint(pdatumMax),
+									ppMin,
+									ppMax,
 									fLowerClosed,
 									fUpperClosed,
 									dFreqPerBucket,
@@ -2843,20 +2853,12 @@ CTranslatorRelcacheToDXL::PhistTransformGPDBHist
 									);
 		pdrgppbucket->Append(pbucket);
 
-		if (!pdatumMin->FStatsComparable(pdatumMin) || !pdatumMin->FStatsLessThan(pdatumMax))
-		{
-			// if less than operation is not supported on this datum,
-			// or the translated histogram does not conform to GPDB sort order (e.g. text column in Linux platform),
-			// then no point building a histogram. return an empty histogram
-
-			// TODO: 03/01/2014 translate histogram into Orca even if sort
-			// order is different in GPDB, and use const expression eval to compare
-			// datums in Orca (MPP-22780)
-			pdrgppbucket->Release();
-			return GPOS_NEW(pmp) CHistogram(GPOS_NEW(pmp) DrgPbucket(pmp));
-		}
+		ppMin = ppMax;
 	}
 
+	// release the reference kept for the bucket after the last one
+	ppMin->Release();
+
 	CHistogram *phist = GPOS_NEW(pmp) CHistogram(pdrgppbucket);
 	return phist;
 }
@@ -2881,13 +2883,30 @@ CTranslatorRelcacheToDXL::Pdrgpdxlbucket
 	DrgPdxlbucket *pdrgpdxlbucket = GPOS_NEW(pmp) DrgPdxlbucket(pmp);
 	const DrgPbucket *pdrgpbucket = phist->Pdrgpbucket();
 	ULONG ulNumBuckets = pdrgpbucket->UlLength();
+
+	// upper bound of the previous bucket, shared with the current bucket
+	// if it is the same datum
+	IDatum *pdatumPrevUB = NULL;
+	CDXLDatum *pdxldatumPrevUB = NULL;
+
 	for (ULONG ul = 0; ul < ulNumBuckets; ul++)
 	{
 		CBucket *pbucket = (*pdrgpbucket)[ul];
 		IDatum *pdatumLB = pbucket->PpLower()->Pdatum();
-		CDXLDatum *pdxldatumLB = pmdtype->Pdxldatum(pmp, pdatumLB);
+		CDXLDatum *pdxldatumLB = NULL;
+		if (pdatumLB == pdatumPrevUB)
+		{
+			pdxldatumPrevUB->AddRef();
+			pdxldatumLB = pdxldatumPrevUB;
+		}
+		else
+		{
+			pdxldatumLB = pmdtype->Pdxldatum(pmp, pdatumLB);
+		}
 		IDatum *pdatumUB = pbucket->PpUpper()->Pdatum();
 		CDXLDatum *pdxldatumUB = pmdtype->Pdxldatum(pmp, pdatumUB);
+		pdatumPrevUB = pdatumUB;
+		pdxldatumPrevUB = pdxldatumUB;
 		CDXLBucket *pdxlbucket = GPOS_NEW(pmp) CDXLBucket
 											(
 											pdxldatumLB,
@@ -31,15 +31,20 @@
 #include "cdb/cdbvars.h"
 #include "utils/guc.h"
 
+#include <pthread.h>
+#include <sys/time.h>
+
 #include "gpos/base.h"
 #include "gpos/error/CException.h"
 #undef setstate
 
 #include "gpos/_api.h"
 #include "gpos/common/CAutoP.h"
+#include "gpos/common/CWallClock.h"
 #include "gpos/io/COstreamFile.h"
 #include "gpos/io/COstreamString.h"
 #include "gpos/memory/CAutoMemoryPool.h"
+#include "gpos/memory/CCacheAccessor.h"
 #include "gpos/task/CAutoTraceFlag.h"
 #include "gpos/common/CAutoP.h"
 
@@ -52,6 +57,7 @@
 #include "gpopt/engine/CCTEConfig.h"
 #include "gpopt/mdcache/CAutoMDAccessor.h"
 #include "gpopt/mdcache/CMDCache.h"
+#include "gpopt/mdcache/CMDKey.h"
 #include "gpopt/minidump/CMinidumperUtils.h"
 #include "gpopt/optimizer/COptimizer.h"
 #include "gpopt/optimizer/COptimizerConfig.h"
@@ -65,6 +71,8 @@
 
 #include "naucrates/md/IMDId.h"
 #include "naucrates/md/CMDIdRelStats.h"
+#include "naucrates/md/CMDIdColStats.h"
+#include "naucrates/md/IMDRelation.h"
 
 #include "naucrates/md/CSystemId.h"
 #include "naucrates/md/IMDRelStats.h"
@@ -122,6 +130,130 @@ const ULONG rgulExpectedDXLErrors[] =
 		gpdxl::ExmiQuery2DXLNotNullViolation,	// not null violation
 	};
 
+// abort flag of the task run by COptTasks::Execute(), GPOS checks it between
+// the jobs of the optimizer's job scheduler; set when the optimizer runs out
+// of its time budget; volatile, as the deadline thread sets it while the
+// optimizer polls it
+static volatile bool fAbortRequested = false;
+
+
+//---------------------------------------------------------------------------
+//	@class:
+//		CAutoSearchDeadline
+//
+//	@doc:
+//		Sets the abort flag of the running task once the given number of
+//		milliseconds has passed, unless the object goes out of scope before.
+//		The time thresholds of the search stages are only checked between
+//		stages, this also bounds the time spent within a stage
+//
+//---------------------------------------------------------------------------
+class CAutoSearchDeadline
+{
+	private:
+
+		// thread waiting for the deadline
+		pthread_t m_thread;
+
+		// protects m_fDone
+		pthread_mutex_t m_mutex;
+
+		// signalled when the search is done
+		pthread_cond_t m_cond;
+
+		// deadline, as absolute time
+		struct timespec m_tsDeadline;
+
+		// is the search done?
+		BOOL m_fDone;
+
+		// was the thread started?
+		BOOL m_fStarted;
+
+		// wait for the deadline or the end of the search
+		static
+		void *PvWait(void *pv);
+
+	public:
+
+		// ctor
+		explicit
+		CAutoSearchDeadline(ULONG ulTimeoutMS);
+
+		// dtor
+		~CAutoSearchDeadline();
+};
+
+void *
+CAutoSearchDeadline::PvWait
+	(
+	void *pv
+	)
+{
+	CAutoSearchDeadline *pasd = static_cast<CAutoSearchDeadline *>(pv);
+
+	gp_set_thread_sigmasks();
+
+	pthread_mutex_lock(&pasd->m_mutex);
+	while (!pasd->m_fDone)
+	{
+		if (ETIMEDOUT == pthread_cond_timedwait(&pasd->m_cond, &pasd->m_mutex, &pasd->m_tsDeadline))
+		{
+			fAbortRequested = true;
+			break;
+		}
+	}
+	pthread_mutex_unlock(&pasd->m_mutex);
+
+	return NULL;
+}
+
+CAutoSearchDeadline::CAutoSearchDeadline
+	(
+	ULONG ulTimeoutMS
+	)
+	:
+	m_fDone(false),
+	m_fStarted(false)
+{
+	struct timeval tv;
+
+	gettimeofday(&tv, NULL);
+	m_tsDeadline.tv_sec = tv.tv_sec + ulTimeoutMS / 1000;
+	m_tsDeadline.tv_nsec = tv.tv_usec * 1000L + (ulTimeoutMS % 1000) * 1000000L;
+	if (1000000000L <= m_tsDeadline.tv_nsec)
+	{
+		m_tsDeadline.tv_sec++;
+		m_tsDeadline.tv_nsec -= 1000000000L;
+	}
+
+	pthread_mutex_init(&m_mutex, NULL);
+	pthread_cond_init(&m_cond, NULL);
+
+	// if we cannot start the thread, only the stage thresholds apply
+	m_fStarted = (0 == pthread_create(&m_thread, NULL, PvWait, this));
+}
+
+CAutoSearchDeadline::~CAutoSearchDeadline()
+{
+	if (m_fStarted)
+	{
+		pthread_mutex_lock(&m_mutex);
+		m_fDone = true;
+		pthread_cond_signal(&m_cond);
+		pthread_mutex_unlock(&m_mutex);
+
+		pthread_join(m_thread, NULL);
+	}
+
+	pthread_cond_destroy(&m_cond);
+	pthread_mutex_destroy(&m_mutex);
+
+	// the deadline may have passed after the search was done, in which case
+	// the plan found must not be thrown away
+	fAbortRequested = false;
+}
+
 
 //---------------------------------------------------------------------------
 //	@function:
@@ -542,7 +674,7 @@ COptTasks::Execute
 	// initialize DXL support
 	InitDXL();
 
-	bool abort_flag = false;
+	fAbortRequested = false;
 
 	CAutoMemoryPool amp(CAutoMemoryPool::ElcNone, CMemoryPoolManager::EatTracker, false /* fThreadSafe */);
 	IMemoryPool *pmp = amp.Pmp();
@@ -554,7 +686,8 @@ COptTasks::Execute
 	params.stack_start = &params;
 	params.error_buffer = err_buf;
 	params.error_buffer_size = GPOPT_ERROR_BUFFER_SIZE;
-	params.abort_requested = &abort_flag;
+	// GPOS takes a plain pointer, it reads the flag through it on every check
+	params.abort_requested = const_cast<bool *>(&fAbortRequested);
 
 	// execute task and send log message to server log
 	GPOS_TRY
@@ -753,6 +886,60 @@ COptTasks::PdrgPssLoad
 	return pdrgpss;
 }
 
+//---------------------------------------------------------------------------
+//	@function:
+//		COptTasks::PdrgpssTimeLimited
+//
+//	@doc:
+//		Create a copy of the given search strategy, or of the default one if
+//		none is given, whose stages time out after the given number of
+//		milliseconds altogether. When a stage times out, the optimizer moves
+//		on to the next one, and uses the best plan found so far at the end
+//
+//---------------------------------------------------------------------------
+DrgPss *
+COptTasks::PdrgpssTimeLimited
+	(
+	IMemoryPool *pmp,
+	DrgPss *pdrgpss,
+	ULONG ulTimeThreshold
+	)
+{
+	if (NULL == pdrgpss)
+	{
+		pdrgpss = CSearchStage::PdrgpssDefault(pmp);
+	}
+
+	DrgPss *pdrgpssLimited = GPOS_NEW(pmp) DrgPss(pmp);
+	const ULONG ulStages = pdrgpss->UlLength();
+	ULONG ulStageTimeThreshold = ulTimeThreshold / ulStages;
+	if (0 == ulStageTimeThreshold)
+	{
+		ulStageTimeThreshold = 1;
+	}
+
+	for (ULONG ul = 0; ul < ulStages; ul++)
+	{
+		CSearchStage *pss = (*pdrgpss)[ul];
+		CXformSet *pxfs = pss->Pxfs();
+		pxfs->AddRef();
+
+		ULONG ulStageThreshold = pss->UlTimeThreshold();
+		if (ulStageThreshold > ulStageTimeThreshold)
+		{
+			ulStageThreshold = ulStageTimeThreshold;
+		}
+
+		pdrgpssLimited->Append
+			(
+			GPOS_NEW(pmp) CSearchStage(pxfs, ulStageThreshold, pss->CostThreshold())
+			);
+	}
+	pdrgpss->Release();
+
+	return pdrgpssLimited;
+}
+
 //---------------------------------------------------------------------------
 //	@function:
 //		COptTasks::PoconfCreate
@@ -853,7 +1040,11 @@ COptTasks::FUnexpectedFailure
 		(gpdxl::ExmaDXL == ulMajor || gpdxl::ExmaMD == ulMajor) &&
 		FExceptionFound(exc, rgulExpectedDXLFallback, GPOS_ARRAY_SIZE(rgulExpectedDXLFallback));
 
-	return (!fExpectedOptFailure && !fExpectedDXLFailure);
+	// the task is only aborted when the optimizer runs out of time
+	BOOL fOutOfTime =
+		CException::ExmaSystem == ulMajor && CException::ExmiAbort == exc.UlMinor();
+
+	return (!fExpectedOptFailure && !fExpectedDXLFailure && !fOutOfTime);
 }
 
 //---------------------------------------------------------------------------
@@ -976,33 +1167,14 @@ COptTasks::PvOptimizeTask
 	// initially assume no unexpected failure
 	poctx->m_fUnexpectedFailure = false;
 
+	// the time budget covers all phases of the optimization, starting now
+	CWallClock clock;
+
 	AUTO_MEM_POOL(amp);
 	IMemoryPool *pmp = amp.Pmp();
 
-	// Does the metadatacache need to be reset?
-	//
-	// On the first call, before the cache has been initialized, we
-	// don't care about the return value of FMDCacheNeedsReset(). But
-	// we need to call it anyway, to give it a chance to initialize
-	// the invalidation mechanism.
-	bool reset_mdcache = gpdb::FMDCacheNeedsReset();
-
-	// initialize metadata cache, or purge if needed, or change size if requested
-	if (!CMDCache::FInitialized())
-	{
-		CMDCache::Init();
-		CMDCache::SetCacheQuota(optimizer_mdcache_size * 1024L);
-	}
-	else if (reset_mdcache)
-	{
-		CMDCache::Reset();
-		CMDCache::SetCacheQuota(optimizer_mdcache_size * 1024L);
-	}
-	else if (CMDCache::ULLGetCacheQuota() != optimizer_mdcache_size * 1024L)
-	{
-		CMDCache::SetCacheQuota(optimizer_mdcache_size * 1024L);
-	}
-
+	// initialize metadata cache, or purge or evict entries if needed
+	(void) FUpdateMDCache(pmp);
 
 	// load search strategy
 	DrgPss *pdrgpss = PdrgPssLoad(pmp, optimizer_search_strategy_path);
@@ -1065,24 +1237,55 @@ COptTasks::PvOptimizeTask
 			DrgPdxln *pdrgpdxlnCTE = ptrquerytodxl->PdrgpdxlnCTE();
 			GPOS_ASSERT(NULL != pdrgpdxlnQueryOutput);
 
+			ULONG ulQueryToDXLTime = clock.UlElapsedUS();
+
+			// the search gets whatever is left of the time budget
+			ULONG ulSearchBudgetMS = 0;
+			if (0 < optimizer_time_budget)
+			{
+				ULONG ulElapsedMS = ulQueryToDXLTime / 1000;
+				if (ulElapsedMS >= (ULONG) optimizer_time_budget)
+				{
+					// no time left to search for a plan, let the planner
+					// handle the query
+					CRefCount::SafeRelease(pdrgpss);
+					GPOS_RAISE(CException::ExmaSystem, CException::ExmiAbort);
+				}
+
+				ulSearchBudgetMS = optimizer_time_budget - ulElapsedMS;
+				pdrgpss = PdrgpssTimeLimited(pmp, pdrgpss, ulSearchBudgetMS);
+			}
+
 			BOOL fMasterOnly = !optimizer_enable_motions ||
 						(!optimizer_enable_motions_masteronly_queries && !ptrquerytodxl->FHasDistributedTables());
 			CAutoTraceFlag atf(EopttraceDisableMotions, fMasterOnly);
 
-			pdxlnPlan = COptimizer::PdxlnOptimize
-									(
-									pmp,
-									&mda,
-									pdxlnQuery,
-									pdrgpdxlnQueryOutput,
-									pdrgpdxlnCTE,
-									pceeval,
-									ulSegments,
-									gp_session_id,
-									gp_command_count,
-									pdrgpss,
-									pocconf
-									);
+			{
+				// abort the search if it overruns the budget, the query is
+				// then planned by the planner
+				CAutoP<CAutoSearchDeadline> a_pasd;
+				if (0 < ulSearchBudgetMS)
+				{
+					a_pasd = GPOS_NEW(pmp) CAutoSearchDeadline(ulSearchBudgetMS);
+				}
+
+				pdxlnPlan = COptimizer::PdxlnOptimize
+										(
+										pmp,
+										&mda,
+										pdxlnQuery,
+										pdrgpdxlnQueryOutput,
+										pdrgpdxlnCTE,
+										pceeval,
+										ulSegments,
+										gp_session_id,
+										gp_command_count,
+										pdrgpss,
+										pocconf
+										);
+			}
+
+			ULONG ulSearchTime = clock.UlElapsedUS() - ulQueryToDXLTime;
 
 			if (poctx->m_fSerializePlanDXL)
 			{
@@ -1098,6 +1301,11 @@ COptTasks::PvOptimizeTask
 				// always use poctx->m_pquery->canSetTag as the ptrquerytodxl->Pquery() is a mutated Query object
 				// that may not have the correct canSetTag
 				poctx->m_pplstmt = (PlannedStmt *) gpdb::PvCopyObject(Pplstmt(pmp, &mda, pdxlnPlan, poctx->m_pquery->canSetTag));
+
+				// remember the time spent in each phase, for EXPLAIN
+				poctx->m_pplstmt->optimizerQueryToDXLTime = ulQueryToDXLTime / 1000.0;
+				poctx->m_pplstmt->optimizerSearchTime = ulSearchTime / 1000.0;
+				poctx->m_pplstmt->optimizerDXLToPlStmtTime = (clock.UlElapsedUS() - ulQueryToDXLTime - ulSearchTime) / 1000.0;
 			}
 
 			CStatisticsConfig *pstatsconf = pocconf->Pstatsconf();
@@ -1158,6 +1366,189 @@ COptTasks::PvOptimizeTask
 }
 
 
+//---------------------------------------------------------------------------
+//	@function:
+//		COptTasks::EvictMDCacheEntry
+//
+//	@doc:
+//		Mark the metadata cache entry with the given mdid for deletion, if
+//		there is one
+//
+//---------------------------------------------------------------------------
+void
+COptTasks::EvictMDCacheEntry
+	(
+	IMDId *pmdid
+	)
+{
+	CMDKey mdkey(pmdid);
+	CCacheAccessor<IMDCacheObject*, CMDKey*> ca(CMDCache::Pcache());
+
+	ca.Lookup(&mdkey);
+	if (NULL != ca.PtVal())
+	{
+		ca.MarkForDeletion();
+	}
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptTasks::EvictMDCacheEntries
+//
+//	@doc:
+//		Evict the metadata cache entries affected by catalog changes. The
+//		entries of a relation's indexes, triggers and check constraints, as
+//		well as its relation and column statistics, are evicted along with
+//		the relation itself
+//
+//---------------------------------------------------------------------------
+void
+COptTasks::EvictMDCacheEntries
+	(
+	IMemoryPool *pmp,
+	List *plMDInval
+	)
+{
+	ListCell *plc = NULL;
+	ForEach (plc, plMDInval)
+	{
+		MDCacheInval *pmdinval = (MDCacheInval *) lfirst(plc);
+		CMDIdGPDB *pmdid = GPOS_NEW(pmp) CMDIdGPDB(pmdinval->oid, 1 /* major */, 0 /* minor */);
+
+		// column statistics are keyed by the position of the column in the
+		// relation, counting system columns; the number of attributes is an
+		// upper bound on that, as it includes dropped columns
+		ULONG ulPositions = 0;
+		if (MDCacheInvalObject != pmdinval->kind)
+		{
+			ulPositions = pmdinval->natts - FirstLowInvalidHeapAttributeNumber;
+		}
+
+		if (MDCacheInvalRelation == pmdinval->kind)
+		{
+			DrgPmdid *pdrgpmdidDependent = GPOS_NEW(pmp) DrgPmdid(pmp);
+			{
+				CMDKey mdkey(pmdid);
+				CCacheAccessor<IMDCacheObject*, CMDKey*> ca(CMDCache::Pcache());
+
+				ca.Lookup(&mdkey);
+				const IMDRelation *pmdrel = dynamic_cast<const IMDRelation *>(ca.PtVal());
+				if (NULL != pmdrel)
+				{
+					for (ULONG ul = 0; ul < pmdrel->UlIndices(); ul++)
+					{
+						IMDId *pmdidIndex = pmdrel->PmdidIndex(ul);
+						pmdidIndex->AddRef();
+						pdrgpmdidDependent->Append(pmdidIndex);
+					}
+					for (ULONG ul = 0; ul < pmdrel->UlTriggers(); ul++)
+					{
+						IMDId *pmdidTrigger = pmdrel->PmdidTrigger(ul);
+						pmdidTrigger->AddRef();
+						pdrgpmdidDependent->Append(pmdidTrigger);
+					}
+					for (ULONG ul = 0; ul < pmdrel->UlCheckConstraints(); ul++)
+					{
+						IMDId *pmdidCheckConstraint = pmdrel->PmdidCheckConstraint(ul);
+						pmdidCheckConstraint->AddRef();
+						pdrgpmdidDependent->Append(pmdidCheckConstraint);
+					}
+
+					// the relation may have been dropped meanwhile
+					if (ulPositions < pmdrel->UlColumns())
+					{
+						ulPositions = pmdrel->UlColumns();
+					}
+					ca.MarkForDeletion();
+				}
+			}
+
+			for (ULONG ul = 0; ul < pdrgpmdidDependent->UlLength(); ul++)
+			{
+				EvictMDCacheEntry((*pdrgpmdidDependent)[ul]);
+			}
+			pdrgpmdidDependent->Release();
+		}
+		else if (MDCacheInvalObject == pmdinval->kind)
+		{
+			EvictMDCacheEntry(pmdid);
+		}
+
+		if (MDCacheInvalObject != pmdinval->kind)
+		{
+			pmdid->AddRef();
+			CMDIdRelStats *pmdidRelStats = GPOS_NEW(pmp) CMDIdRelStats(pmdid);
+			EvictMDCacheEntry(pmdidRelStats);
+			pmdidRelStats->Release();
+
+			for (ULONG ulPos = 0; ulPos < ulPositions; ulPos++)
+			{
+				pmdid->AddRef();
+				CMDIdColStats *pmdidColStats = GPOS_NEW(pmp) CMDIdColStats(pmdid, ulPos);
+				EvictMDCacheEntry(pmdidColStats);
+				pmdidColStats->Release();
+			}
+		}
+
+		pmdid->Release();
+	}
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptTasks::FUpdateMDCache
+//
+//	@doc:
+//		Initialize the metadata cache, or purge it if needed, or evict the
+//		entries affected by catalog changes, or change its size if requested.
+//		Returns true if the cache was initialized by this call
+//
+//---------------------------------------------------------------------------
+BOOL
+COptTasks::FUpdateMDCache
+	(
+	IMemoryPool *pmp
+	)
+{
+	// Does the metadatacache need to be reset?
+	//
+	// On the first call, before the cache has been initialized, we
+	// don't care about the return value of FMDCacheNeedsReset(). But
+	// we need to call it anyway, to give it a chance to initialize
+	// the invalidation mechanism.
+	List *plMDInval = NIL;
+	bool reset_mdcache = gpdb::FMDCacheNeedsReset(&plMDInval);
+	BOOL fInitialized = false;
+
+	if (!CMDCache::FInitialized())
+	{
+		CMDCache::Init();
+		CMDCache::SetCacheQuota(optimizer_mdcache_size * 1024L);
+		fInitialized = true;
+	}
+	else if (reset_mdcache)
+	{
+		CMDCache::Reset();
+		CMDCache::SetCacheQuota(optimizer_mdcache_size * 1024L);
+	}
+	else
+	{
+		EvictMDCacheEntries(pmp, plMDInval);
+
+		if (CMDCache::ULLGetCacheQuota() != optimizer_mdcache_size * 1024L)
+		{
+			CMDCache::SetCacheQuota(optimizer_mdcache_size * 1024L);
+		}
+	}
+
+	gpdb::FreeListDeep(plMDInval);
+
+	return fInitialized;
+}
+
+
 //---------------------------------------------------------------------------
 //	@function:
 //		COptTasks::PrintMissingStatsWarning
@@ -1549,32 +1940,8 @@ COptTasks::PvEvalExprFromDXLTask
 	GPOS_ASSERT(NULL != pdxlnInput);
 
 	CDXLNode *pdxlnResult = NULL;
-	BOOL fReleaseCache = false;
-
-	// Does the metadatacache need to be reset?
-	//
-	// On the first call, before the cache has been initialized, we
-	// don't care about the return value of FMDCacheNeedsReset(). But
-	// we need to call it anyway, to give it a chance to initialize
-	// the invalidation mechanism.
-	bool reset_mdcache = gpdb::FMDCacheNeedsReset();
-
-	// initialize metadata cache, or purge if needed, or change size if requested
-	if (!CMDCache::FInitialized())
-	{
-		CMDCache::Init();
-		CMDCache::SetCacheQuota(optimizer_mdcache_size * 1024L);
-		fReleaseCache = true;
-	}
-	else if (reset_mdcache)
-	{
-		CMDCache::Reset();
-		CMDCache::SetCacheQuota(optimizer_mdcache_size * 1024L);
-	}
-	else if (CMDCache::ULLGetCacheQuota() != optimizer_mdcache_size * 1024L)
-	{
-		CMDCache::SetCacheQuota(optimizer_mdcache_size * 1024L);
-	}
+	// initialize metadata cache, or purge or evict entries if needed
+	BOOL fReleaseCache = FUpdateMDCache(pmp);
 
 	GPOS_TRY
 	{
@@ -0,0 +1,109 @@
+/*-------------------------------------------------------------------------
+ *
+ * hyperloglog.c
+ *	  HyperLogLog sketches, for estimating the number of distinct values
+ *
+ * This follows "HyperLogLog: the analysis of a near-optimal cardinality
+ * estimation algorithm" by Flajolet, Fusy, Gandouet and Meunier (2007),
+ * with the small-range correction from that paper. The first HLL_PRECISION
+ * bits of the hash select a register, which remembers the longest run of
+ * leading zeroes seen in the rest of the hash. We use 64-bit hashes, so
+ * hash collisions don't bias the estimate even for billions of distinct
+ * values, and the paper's large-range correction is not needed.
+ *
+ * Copyright (c) 2016, Pivotal Software, Inc.
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include <math.h>
+
+#include "lib/hyperloglog.h"
+
+
+/*
+ * hll_create -- allocate an empty sketch in the current memory context
+ */
+HyperLogLog *
+hll_create(void)
+{
+	HyperLogLog *hll = (HyperLogLog *) palloc0(HLL_SIZE);
+
+	SET_VARSIZE(hll, HLL_SIZE);
+	hll->precision = HLL_PRECISION;
+
+	return hll;
+}
+
+/*
+ * hll_add_hash -- add a hashed value to the sketch
+ */
+void
+hll_add_hash(HyperLogLog *hll, uint64 hash)
+{
+	uint32		index = (uint32) (hash >> (64 - HLL_PRECISION));
+	uint64		rest = hash << HLL_PRECISION;
+	uint8		rank = 1;
+
+	/* position of the leftmost 1-bit in the remaining bits */
+	if (rest == 0)
+		rank = 64 - HLL_PRECISION + 1;
+	else
+	{
+		while ((rest & UINT64CONST(0x8000000000000000)) == 0)
+		{
+			rest <<= 1;
+			rank++;
+		}
+	}
+
+	if (rank > hll->registers[index])
+		hll->registers[index] = rank;
+}
+
+/*
+ * hll_merge -- add all values seen by src to dst
+ */
+void
+hll_merge(HyperLogLog *dst, const HyperLogLog *src)
+{
+	int			i;
+
+	Assert(HllIsValid(dst) && HllIsValid(src));
+
+	for (i = 0; i < HLL_NREGISTERS; i++)
+	{
+		if (src->registers[i] > dst->registers[i])
+			dst->registers[i] = src->registers[i];
+	}
+}
+
+/*
+ * hll_estimate -- estimate the number of distinct values added to the sketch
+ */
+double
+hll_estimate(const HyperLogLog *hll)
+{
+	double		m = HLL_NREGISTERS;
+	double		alpha = 0.7213 / (1.0 + 1.079 / m);
+	double		sum = 0.0;
+	int			zeroes = 0;
+	double		estimate;
+	int			i;
+
+	for (i = 0; i < HLL_NREGISTERS; i++)
+	{
+		sum += ldexp(1.0, -hll->registers[i]);
+		if (hll->registers[i] == 0)
+			zeroes++;
+	}
+
+	estimate = alpha * m * m / sum;
+
+	/* small range: count empty registers instead (linear counting) */
+	if (estimate <= 2.5 * m && zeroes > 0)
+		estimate = m * log(m / zeroes);
+
+	return estimate;
+}
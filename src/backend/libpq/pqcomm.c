@@ -1057,6 +1057,27 @@ pq_getbyte_if_available(unsigned char *c)
 	return r;
 }
 
+/* --------------------------------
+ *		pq_input_pending	- has the client sent data we haven't consumed yet?
+ *
+ *	Only looks at what is buffered in this process; the caller polls the
+ *	socket for what the kernel has.
+ * --------------------------------
+ */
+bool
+pq_input_pending(void)
+{
+	if (PqRecvPointer < PqRecvLength)
+		return true;
+
+#ifdef USE_SSL
+	if (MyProcPort->ssl && SSL_pending(MyProcPort->ssl) > 0)
+		return true;
+#endif
+
+	return false;
+}
+
 /* --------------------------------
  *		pq_getbytes		- get a known number of bytes from connection
  *
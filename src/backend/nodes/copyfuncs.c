@@ -134,6 +134,10 @@ _copyPlannedStmt(PlannedStmt *from)
 
 	COPY_SCALAR_FIELD(query_mem);
 
+	COPY_SCALAR_FIELD(optimizerQueryToDXLTime);
+	COPY_SCALAR_FIELD(optimizerSearchTime);
+	COPY_SCALAR_FIELD(optimizerDXLToPlStmtTime);
+
 	return newnode;
 }
 
@@ -1085,6 +1085,8 @@ opstream_free(StreamNode *self)
 			inp->free(inp);
 	}
 	list_free(self->input);
+	if (self->inputEntries)
+		pfree(self->inputEntries);
 	pfree(self);
 }
 
@@ -1307,6 +1309,49 @@ tbm_stream_upd_instrument(StreamNode *self)
  * Returns false when no more results can be obtained, otherwise true.
  */
 
+/*
+ * Combine the words of page 'b' into page 'a'.  The loops are kept free of
+ * branches so that the compiler can turn them into vector instructions.
+ */
+static inline void
+tbm_words_union(tbm_bitmapword * restrict a, const tbm_bitmapword * restrict b)
+{
+	int			wordnum;
+
+	for (wordnum = 0; wordnum < WORDS_PER_PAGE; wordnum++)
+		a[wordnum] |= b[wordnum];
+}
+
+static inline void
+tbm_words_intersect(tbm_bitmapword * restrict a, const tbm_bitmapword * restrict b)
+{
+	int			wordnum;
+
+	for (wordnum = 0; wordnum < WORDS_PER_PAGE; wordnum++)
+		a[wordnum] &= b[wordnum];
+}
+
+/*
+ * Return the per-input page buffers of an OpStream, one for each input
+ * stream.  They are kept across calls, so that pulling a block from every
+ * input doesn't allocate.
+ */
+static PagetableEntry *
+opstream_input_entries(OpStream *op)
+{
+	int			ninputs = list_length(op->input);
+
+	if (op->nInputEntries < ninputs)
+	{
+		if (op->inputEntries)
+			pfree(op->inputEntries);
+		op->inputEntries = (PagetableEntry *)
+			palloc(ninputs * sizeof(PagetableEntry));
+		op->nInputEntries = ninputs;
+	}
+	return op->inputEntries;
+}
+
 bool
 bitmap_stream_iterate(StreamNode *n, PagetableEntry *e)
 {
@@ -1336,9 +1381,9 @@ bitmap_stream_iterate(StreamNode *n, PagetableEntry *e)
 		ListCell   *map;
 		OpStream   *op = (OpStream *) n;
 		BlockNumber minblockno;
-		ListCell   *cell;
-		int			wordnum;
-		List	   *matches;
+		PagetableEntry *entries;
+		int			nentries;
+		int			i;
 		bool		empty;
 
 
@@ -1363,17 +1408,16 @@ bitmap_stream_iterate(StreamNode *n, PagetableEntry *e)
 restart:
 		e->blockno = InvalidBlockNumber;
 		empty = false;
-		matches = NIL;
 		minblockno = InvalidBlockNumber;
 		Assert(PointerIsValid(op->input));
+		entries = opstream_input_entries(op);
+		nentries = 0;
 		foreach(map, op->input)
 		{
 			StreamNode *in = (StreamNode *) lfirst(map);
-			PagetableEntry *new;
+			PagetableEntry *new = &entries[nentries++];
 			bool		r;
 
-			new = (PagetableEntry *) palloc(sizeof(PagetableEntry));
-
 			/* set the desired block */
 			in->nextblock = op->nextblock;
 			r = in->pull((void *) in, new);
@@ -1394,11 +1438,11 @@ restart:
 					minblockno = Min(minblockno, new->blockno);
 				else
 					minblockno = Max(minblockno, new->blockno);
-				matches = lappend(matches, (void *) new);
 			}
 			else
 			{
-				pfree(new);
+				/* mark the buffer as holding no match */
+				new->blockno = InvalidBlockNumber;
 
 				if (n->type == BMS_AND)
 				{
@@ -1419,9 +1463,12 @@ restart:
 		 * Now we iterate through the actual matches and perform the desired
 		 * operation on those from the same minimum block
 		 */
-		foreach(cell, matches)
+		for (i = 0; i < nentries; i++)
 		{
-			PagetableEntry *tmp = (PagetableEntry *) lfirst(cell);
+			PagetableEntry *tmp = &entries[i];
+
+			if (tmp->blockno == InvalidBlockNumber)
+				continue;
 
 			if (tmp->blockno == minblockno)
 			{
@@ -1440,17 +1487,13 @@ restart:
 					e->ischunk = true;
 					/* XXX: we can just return now... I think :) */
 					op->nextblock = minblockno + 1;
-					list_free_deep(matches);
 					return res;
 				}
 				/* union/intersect existing output and new matches */
-				for (wordnum = 0; wordnum < WORDS_PER_PAGE; wordnum++)
-				{
-					if (n->type == BMS_OR)
-						e->words[wordnum] |= tmp->words[wordnum];
-					else
-						e->words[wordnum] &= tmp->words[wordnum];
-				}
+				if (n->type == BMS_OR)
+					tbm_words_union(e->words, tmp->words);
+				else
+					tbm_words_intersect(e->words, tmp->words);
 			}
 			else if (n->type == BMS_AND)
 			{
@@ -1473,11 +1516,8 @@ restart:
 			/* start again */
 			empty = false;
 			MemSet(e->words, 0, sizeof(tbm_bitmapword) * WORDS_PER_PAGE);
-			list_free_deep(matches);
 			goto restart;
 		}
-		else
-			list_free_deep(matches);
 		if (res)
 			op->nextblock = minblockno + 1;
 	}
@@ -498,6 +498,13 @@ use_physical_tlist(PlannerInfo *root, RelOptInfo *rel)
 			return false;
 	}
 
+	/*
+	 * CDB: External scans only convert the columns that their target list
+	 * and quals use, don't make them convert all of them.
+	 */
+	if (rel->relstorage == RELSTORAGE_EXTERNAL)
+		return false;
+
 	/* CDB: Don't use physical tlist if rel has pseudo columns. */
 	rte = rt_fetch(rel->relid, root->parse->rtable);
 	if (rte->pseudocols)
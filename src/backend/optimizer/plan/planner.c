@@ -43,6 +43,7 @@
 #include "parser/parse_oper.h"
 #include "parser/parsetree.h"
 #include "utils/lsyscache.h"
+#include "utils/orcaplancache.h"
 #include "utils/selfuncs.h"
 #include "utils/syscache.h"
 
@@ -180,6 +181,7 @@ optimize_query(Query *parse, ParamListInfo boundParams)
 	PlannerGlobal *glob;
 	Query	   *pqueryCopy;
 	PlannedStmt *result;
+	char	   *plancachekey;
 	List	   *relationOids;
 	List	   *invalItems;
 	ListCell   *lc;
@@ -220,6 +222,14 @@ optimize_query(Query *parse, ParamListInfo boundParams)
 	 */
 	pqueryCopy = preprocess_query_optimizer(glob, pqueryCopy, boundParams);
 
+	/*
+	 * If the same query was optimized earlier in this session, and nothing
+	 * it depends on has changed since, reuse that plan.
+	 */
+	result = OrcaPlanCacheLookup(pqueryCopy, &plancachekey);
+	if (result)
+		return result;
+
 	/* Ok, invoke ORCA. */
 	result = PplstmtOptimize(pqueryCopy, &fUnexpectedFailure);
 
@@ -324,6 +334,9 @@ optimize_query(Query *parse, ParamListInfo boundParams)
 	result->relationOids = glob->relationOids;
 	result->invalItems = glob->invalItems;
 
+	if (plancachekey)
+		OrcaPlanCacheInsert(plancachekey, result);
+
 	return result;
 }
 #endif
@@ -57,6 +57,7 @@
 #include "storage/spin.h"
 #include "utils/resscheduler.h"
 #include "utils/faultinjector.h"
+#include "utils/mdsharedcache.h"
 #include "utils/sharedsnapshot.h"
 #include "utils/simex.h"
 
@@ -67,6 +68,7 @@
 #include "cdb/memquota.h"
 #include "executor/spi.h"
 #include "utils/workfile_mgr.h"
+#include "utils/memaccounting.h"
 #include "utils/session_state.h"
 
 shmem_startup_hook_type shmem_startup_hook = NULL;
@@ -147,6 +149,7 @@ CreateSharedMemoryAndSemaphores(bool makePrivate, int port)
 				size = add_size(size, ResPortalIncrementShmemSize());				
 			}
 		}
+		size = add_size(size, MDSharedCacheShmemSize());
 		size = add_size(size, ProcGlobalShmemSize());
 		size = add_size(size, XLOGShmemSize());
 		size = add_size(size, DistributedLog_ShmemSize());
@@ -233,6 +236,9 @@ CreateSharedMemoryAndSemaphores(bool makePrivate, int port)
 		/* Consider the size of the SessionState array */
 		size = add_size(size, SessionState_ShmemSize());
 
+		/* Live memory accounting balances of each backend */
+		size = add_size(size, MemoryAccounting_ShmemSize());
+
 		/*
 		 * Create the shmem segment
 		 */
@@ -333,6 +339,11 @@ CreateSharedMemoryAndSemaphores(bool makePrivate, int port)
 		InitResPortalIncrementHash();
 	}
 
+	/*
+	 * Set up the optimizer metadata cache shared by all sessions
+	 */
+	MDSharedCacheShmemInit();
+
 
 	if (!IsUnderPostmaster)
 	{
@@ -342,6 +353,8 @@ CreateSharedMemoryAndSemaphores(bool makePrivate, int port)
 
 	/* Initialize SessionState shared memory array */
 	SessionState_ShmemInit();
+	/* Initialize per-backend memory accounting balances */
+	MemoryAccounting_ShmemInit();
 	/* Initialize vmem protection */
 	GPMemoryProtect_ShmemInit();
 
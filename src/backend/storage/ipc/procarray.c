@@ -975,6 +975,7 @@ FillInDistributedSnapshot(Snapshot snapshot)
 				snapshot->haveDistribSnapshot = true;
 
 				dslm->header.distribTransactionTimeStamp = ds->header.distribTransactionTimeStamp;
+				dslm->header.xminAllDistributedSnapshots = ds->header.xminAllDistributedSnapshots;
 				dslm->header.distribSnapshotId = ds->header.distribSnapshotId;
 				
 				dslm->header.xmin = ds->header.xmin;
@@ -991,6 +992,8 @@ FillInDistributedSnapshot(Snapshot snapshot)
 					/* UNDONE: Lookup in distributed cache. */
 					dslm->inProgressEntryArray[i].localXid = InvalidTransactionId;
 				}
+
+				DistributedSnapshotWithLocalMapping_ResetXidCache(dslm);
 			}
 			else
 			{
@@ -21,6 +21,7 @@
 #include "storage/proc.h"
 #include "storage/sinvaladt.h"
 #include "utils/inval.h"
+#include "utils/mdsharedcache.h"
 
 #include "cdb/cdbtm.h"          /* DtxContext */
 
@@ -60,6 +61,9 @@ void
 SendSharedInvalidMessages(const SharedInvalidationMessage *msgs, int n)
 {
 	SIInsertDataEntries(msgs, n);
+
+	/* must come after the messages are queued, see mdsharedcache.c */
+	MDSharedCacheInvalidate(msgs, n);
 }
 
 /*
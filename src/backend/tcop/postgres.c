@@ -88,6 +88,7 @@
 #include "cdb/cdbdispatchresult.h"
 #include "cdb/cdbgang.h"
 #include "cdb/ml_ipc.h"
+#include "cdb/memquota.h"
 #include "utils/guc.h"
 #include "access/twophase.h"
 #include "postmaster/backoff.h"
@@ -1512,10 +1513,15 @@ exec_mpp_dtx_protocol_command(DtxProtocolCommand dtxProtocolCommand,
 	elog((Debug_print_full_dtm ? LOG : DEBUG5),"exec_mpp_dtx_protocol_command calling EndCommand for dtxProtocolCommand = %d (%s) gid = %s",
 		 dtxProtocolCommand, loggingStr, gid);
 
+	/*
+	 * A one-phase commit is done at this point, and an ERROR would tell the
+	 * master that it was rolled back.  Drop the connection instead, the way
+	 * a failure after the commit looks to the master.
+	 */
 	if (Debug_dtm_action == DEBUG_DTM_ACTION_FAIL_END_COMMAND && 
 		CheckDebugDtmActionProtocol(dtxProtocolCommand, contextInfo))
 	{
-		ereport(ERROR,
+		ereport((dtxProtocolCommand == DTX_PROTOCOL_COMMAND_COMMIT_ONEPHASE ? FATAL : ERROR),
 				(errcode(ERRCODE_FAULT_INJECT),
 				 errmsg("Raise error for debug_dtm_action = %d, debug_dtm_action_protocol = %s",
 						Debug_dtm_action, DtxProtocolCommandToString(dtxProtocolCommand))));
@@ -4818,6 +4824,7 @@ PostgresMain(int argc, char *argv[],
 		MemoryContextSwitchTo(MessageContext);
 		MemoryContextResetAndDeleteChildren(MessageContext);
 		VmemTracker_ResetMaxVmemReserved();
+		MemoryBroker_Reset();
 
 		/* Reset memory accounting */
 
@@ -4875,6 +4882,13 @@ PostgresMain(int argc, char *argv[],
 
 			ReadyForQuery(whereToSendOutput);
 			send_ready_for_query = false;
+
+			/*
+			 * Now that the client is not waiting for us, top up the idle
+			 * reader gangs for the next statement.
+			 */
+			if (Gp_role == GP_ROLE_DISPATCH)
+				replenishWarmReaderGangs();
 		}
 
 		/*
@@ -4924,6 +4938,7 @@ PostgresMain(int argc, char *argv[],
 					elog(FATAL, "could not set timer for client wait timeout");
 		}
 
+		VmemTracker_ReleaseReservationCache();
 		IdleTracker_DeactivateProcess();
 		firstchar = ReadCommand(&input_message);
 		IdleTracker_ActivateProcess();
@@ -24,6 +24,7 @@
 #include "catalog/pg_operator.h"
 #include "catalog/pg_type.h"
 #include "miscadmin.h"
+#include "storage/bufmgr.h"
 #ifdef CATCACHE_STATS
 #include "storage/ipc.h"		/* for on_proc_exit */
 #endif
@@ -36,6 +37,7 @@
 #include "utils/rel.h"
 #include "utils/resowner.h"
 #include "utils/syscache.h"
+#include "utils/tqual.h"
 
 
  /* #define CACHEDEBUG */	/* turns DEBUG elogs on */
@@ -1324,6 +1326,90 @@ ReleaseCatCache(HeapTuple tuple)
 }
 
 
+/*
+ *	GetCatCacheHashValue
+ *
+ *		Compute the hash value for a given set of search keys.
+ *
+ * The reason for exposing this as part of the API is that the hash value is
+ * exposed in cache invalidation operations, so there are places outside the
+ * catcache code that need to be able to compute the hash values.
+ */
+uint32
+GetCatCacheHashValue(CatCache *cache,
+					 Datum v1,
+					 Datum v2,
+					 Datum v3,
+					 Datum v4)
+{
+	ScanKeyData cur_skey[CATCACHE_MAXKEYS];
+
+	/*
+	 * one-time startup overhead for each cache
+	 */
+	if (cache->cc_tupdesc == NULL)
+		CatalogCacheInitializeCache(cache);
+
+	/*
+	 * initialize the search key information
+	 */
+	memcpy(cur_skey, cache->cc_skey, sizeof(cur_skey));
+	cur_skey[0].sk_argument = v1;
+	cur_skey[1].sk_argument = v2;
+	cur_skey[2].sk_argument = v3;
+	cur_skey[3].sk_argument = v4;
+
+	/*
+	 * calculate the hash value
+	 */
+	return CatalogCacheComputeHashValue(cache, cache->cc_nkeys, cur_skey);
+}
+
+
+/*
+ *	SearchCatCacheByTid
+ *
+ *		Fetch the catalog tuple at the given TID, regardless of its
+ *		visibility, provided it still hashes to the given value in this
+ *		cache.  This lets callers that remembered the TID and hash value of
+ *		a sinval message find out which tuple the message was about.  If the
+ *		tuple has since been pruned and its slot reused or removed, NULL is
+ *		returned.
+ *
+ *		The result is a palloc'd copy, not a cache entry; the caller should
+ *		heap_freetuple() it when done.
+ */
+HeapTuple
+SearchCatCacheByTid(CatCache *cache, ItemPointer tid, uint32 hashValue)
+{
+	Relation	relation;
+	HeapTupleData tuple;
+	Buffer		buffer;
+	HeapTuple	result = NULL;
+
+	if (cache->cc_tupdesc == NULL)
+		CatalogCacheInitializeCache(cache);
+
+	relation = heap_open(cache->cc_reloid, AccessShareLock);
+
+	/* the page may be gone too, if the catalog has been vacuumed */
+	if (ItemPointerGetBlockNumber(tid) < RelationGetNumberOfBlocks(relation))
+	{
+		tuple.t_self = *tid;
+		if (heap_fetch(relation, SnapshotAny, &tuple, &buffer, false, NULL))
+		{
+			if (CatalogCacheComputeTupleHashValue(cache, &tuple) == hashValue)
+				result = heap_copytuple(&tuple);
+			ReleaseBuffer(buffer);
+		}
+	}
+
+	heap_close(relation, AccessShareLock);
+
+	return result;
+}
+
+
 /*
  *	SearchCatCacheList
  *
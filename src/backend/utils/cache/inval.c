@@ -164,10 +164,12 @@ static TransInvalidationInfo *transInvalInfo = NULL;
  */
 /*
  * MAX_SYSCACHE_CALLBACKS has been bumped up in GPDB, because ORCA registers
- * a lot of callbacks.
+ * a lot of callbacks. MAX_RELCACHE_CALLBACKS has been bumped up as well,
+ * because the ORCA plan cache and the partition metadata cache register
+ * relcache callbacks too. Leave some room for extensions in both.
  */
-#define MAX_SYSCACHE_CALLBACKS 40
-#define MAX_RELCACHE_CALLBACKS 5
+#define MAX_SYSCACHE_CALLBACKS 64
+#define MAX_RELCACHE_CALLBACKS 16
 
 static struct SYSCACHECALLBACK
 {
@@ -537,7 +539,8 @@ LocalExecuteInvalidationMessage(SharedInvalidationMessage *msg)
 
 				if (ccitem->id == msg->cc.id)
 					(*ccitem->function) (ccitem->arg,
-										 msg->cc.id, &msg->cc.tuplePtr);
+										 msg->cc.id, &msg->cc.tuplePtr,
+										 msg->cc.hashValue);
 			}
 		}
 	}
@@ -595,7 +598,7 @@ InvalidateSystemCaches(void)
 	{
 		struct SYSCACHECALLBACK *ccitem = syscache_callback_list + i;
 
-		(*ccitem->function) (ccitem->arg, ccitem->id, NULL);
+		(*ccitem->function) (ccitem->arg, ccitem->id, NULL, 0);
 	}
 
 	for (i = 0; i < relcache_callback_count; i++)
@@ -928,6 +931,35 @@ inval_twophase_postcommit(TransactionId xid, uint16 info,
 }
 
 
+/*
+ * TransactionHasPendingInvalidations
+ *		Has the current transaction queued invalidation messages that have
+ *		not been sent to other backends yet?
+ *
+ * This is the case after the transaction, or any of its open
+ * subtransactions, has modified the catalogs. Caches shared between
+ * backends must not be used then, since what this backend sees in the
+ * catalogs differs from what everyone else sees.
+ */
+bool
+TransactionHasPendingInvalidations(void)
+{
+	TransInvalidationInfo *info;
+
+	for (info = transInvalInfo; info != NULL; info = info->parent)
+	{
+		if (info->CurrentCmdInvalidMsgs.cclist != NULL ||
+			info->CurrentCmdInvalidMsgs.rclist != NULL ||
+			info->PriorCmdInvalidMsgs.cclist != NULL ||
+			info->PriorCmdInvalidMsgs.rclist != NULL ||
+			info->RelcacheInitFileInval)
+			return true;
+	}
+
+	return false;
+}
+
+
 /*
  * AtEOXact_Inval
  *		Process queued-up invalidation messages at end of main transaction.
@@ -0,0 +1,480 @@
+/*-------------------------------------------------------------------------
+ *
+ * mdsharedcache.c
+ *	  Optimizer metadata cache shared by all backends on the master.
+ *
+ * Each backend running ORCA keeps its own metadata cache of objects
+ * translated from the catalogs, so a new session starts out cold and has to
+ * translate every relation, type, function and statistics object again.
+ * This module keeps the serialized (DXL) form of those objects in shared
+ * memory, so that a backend can populate its own cache from here instead.
+ *
+ * The objects are stored in a circular log: new objects are appended at the
+ * head, and the oldest ones are evicted from the tail to make room. A hash
+ * table in shared memory maps the key of each object (the database and the
+ * metadata id of the object) to its position in the log. Replacing an object
+ * just appends a new copy; the old one becomes garbage that is reclaimed
+ * when the tail passes it.
+ *
+ * Staleness is detected using invalidation clocks. Every catcache and
+ * relcache invalidation message sent by any backend advances one of a fixed
+ * number of clocks, chosen by the hash value of the invalidated key, see
+ * MDSharedCacheInvalidate(). The version of an object is the sum of the
+ * clocks for the catalog entries it is derived from, plus a global clock
+ * that is advanced by changes that can affect objects in ways we cannot
+ * track (operators, casts, partitioning and the like). A cached object is
+ * only used if its version matches the current one. Clocks are advanced
+ * after the messages have been queued, and backends read the version before
+ * catching up with the queue and translating the object, so an object can
+ * never be stamped with a version newer than the catalog state it was
+ * translated from.
+ *
+ * The clocks only cover committed catalog changes. A transaction that has
+ * modified the catalogs itself sees a catalog state that no other backend
+ * sees, and that may still be rolled back, so such transactions neither look
+ * up nor add objects here until they end.
+ *
+ * Copyright (c) 2016, Pivotal Software, Inc.
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include "access/hash.h"
+#include "cdb/cdbvars.h"
+#include "miscadmin.h"
+#include "storage/lwlock.h"
+#include "storage/shmem.h"
+#include "utils/guc.h"
+#include "utils/hsearch.h"
+#include "utils/inval.h"
+#include "utils/mdsharedcache.h"
+#include "utils/syscache.h"
+
+/* number of invalidation clocks; must be a power of 2 */
+#define MDSHAREDCACHE_NUM_CLOCKS	1024
+
+/* objects larger than this fraction of the log are not cached */
+#define MDSHAREDCACHE_MAX_OBJECT_FRACTION	4
+
+/* assumed average object size, used to size the hash table */
+#define MDSHAREDCACHE_AVG_OBJECT_SIZE	1024
+
+#define MDSharedCacheClock(hashValue) \
+	(MDSharedCache->clocks[(hashValue) & (MDSHAREDCACHE_NUM_CLOCKS - 1)])
+
+typedef struct MDSharedCacheKey
+{
+	Oid			dbid;
+	char		mdid[MDSHAREDCACHE_KEYSIZE];
+} MDSharedCacheKey;
+
+/* hash table entry */
+typedef struct MDSharedCacheEntry
+{
+	MDSharedCacheKey key;		/* hash key, must be first */
+	uint64		offset;			/* logical position of the object in the log */
+	uint64		version;		/* version the object was translated at */
+} MDSharedCacheEntry;
+
+/* header of an object in the log; the DXL text follows */
+typedef struct MDSharedCacheRecord
+{
+	uint32		size;			/* MAXALIGN'd size, including this header */
+	uint32		len;			/* length of the DXL text, 0 for padding */
+	MDSharedCacheKey key;
+} MDSharedCacheRecord;
+
+#define MDSHAREDCACHE_RECORD_HDRSZ	MAXALIGN(sizeof(MDSharedCacheRecord))
+
+typedef struct MDSharedCacheHeader
+{
+	uint64		head;			/* logical position of the next object */
+	uint64		tail;			/* logical position of the oldest object */
+	Size		logSize;		/* size of the log, in bytes */
+	long		maxEntries;		/* maximum number of objects in the log */
+	uint64		globalClock;
+	uint64		clocks[MDSHAREDCACHE_NUM_CLOCKS];
+	char		log[1];			/* VARIABLE LENGTH ARRAY */
+} MDSharedCacheHeader;
+
+static MDSharedCacheHeader *MDSharedCache = NULL;
+static HTAB *MDSharedCacheHash = NULL;
+
+static bool MDSharedCacheEnabled(void);
+static Size MDSharedCacheLogSize(void);
+static long MDSharedCacheMaxEntries(void);
+static bool MDSharedCacheMakeKey(MDSharedCacheKey *hashkey, const char *key);
+static void MDSharedCacheEvictOldest(void);
+
+
+static bool
+MDSharedCacheEnabled(void)
+{
+	return Gp_role == GP_ROLE_DISPATCH && optimizer_mdcache_shared_size > 0;
+}
+
+static Size
+MDSharedCacheLogSize(void)
+{
+	return MAXALIGN_DOWN((Size) optimizer_mdcache_shared_size * 1024L);
+}
+
+static long
+MDSharedCacheMaxEntries(void)
+{
+	return Max((long) (MDSharedCacheLogSize() / MDSHAREDCACHE_AVG_OBJECT_SIZE), 64);
+}
+
+/*
+ * Report shared-memory space needed by MDSharedCacheShmemInit
+ */
+Size
+MDSharedCacheShmemSize(void)
+{
+	Size		size;
+
+	if (!MDSharedCacheEnabled())
+		return 0;
+
+	size = add_size(offsetof(MDSharedCacheHeader, log), MDSharedCacheLogSize());
+	size = add_size(size, hash_estimate_size(MDSharedCacheMaxEntries(),
+											 sizeof(MDSharedCacheEntry)));
+
+	return size;
+}
+
+/*
+ * Initialize the shared metadata cache, or attach to it
+ */
+void
+MDSharedCacheShmemInit(void)
+{
+	HASHCTL		info;
+	bool		found;
+
+	if (!MDSharedCacheEnabled())
+		return;
+
+	MDSharedCache = (MDSharedCacheHeader *)
+		ShmemInitStruct("Optimizer Shared MDCache",
+						add_size(offsetof(MDSharedCacheHeader, log), MDSharedCacheLogSize()),
+						&found);
+	if (MDSharedCache == NULL)
+		ereport(FATAL,
+				(errcode(ERRCODE_OUT_OF_MEMORY),
+				 errmsg("insufficient shared memory for optimizer shared MDCache")));
+
+	if (!found)
+	{
+		MDSharedCache->head = 0;
+		MDSharedCache->tail = 0;
+		MDSharedCache->logSize = MDSharedCacheLogSize();
+		MDSharedCache->maxEntries = MDSharedCacheMaxEntries();
+		MDSharedCache->globalClock = 0;
+		MemSet(MDSharedCache->clocks, 0, sizeof(MDSharedCache->clocks));
+	}
+
+	MemSet(&info, 0, sizeof(info));
+	info.keysize = sizeof(MDSharedCacheKey);
+	info.entrysize = sizeof(MDSharedCacheEntry);
+	info.hash = tag_hash;
+
+	MDSharedCacheHash = ShmemInitHash("Optimizer Shared MDCache Hash",
+									  MDSharedCacheMaxEntries(),
+									  MDSharedCacheMaxEntries(),
+									  &info,
+									  HASH_ELEM | HASH_FUNCTION);
+	if (MDSharedCacheHash == NULL)
+		ereport(FATAL,
+				(errcode(ERRCODE_OUT_OF_MEMORY),
+				 errmsg("insufficient shared memory for optimizer shared MDCache")));
+}
+
+/*
+ * Advance the invalidation clocks for a batch of invalidation messages that
+ * have just been added to the shared invalidation queue.
+ *
+ * Catcache messages advance the clock picked by their hash value. Relcache
+ * messages use the hash of the relation OID, which is also the hash value of
+ * an OID key in the catcaches, so that a single clock covers both the
+ * relcache entry and the syscache entries of an object with that OID.
+ */
+void
+MDSharedCacheInvalidate(const SharedInvalidationMessage *msgs, int n)
+{
+	int			i;
+
+	if (MDSharedCache == NULL)
+		return;
+
+	LWLockAcquire(MDSharedCacheLock, LW_EXCLUSIVE);
+
+	for (i = 0; i < n; i++)
+	{
+		const SharedInvalidationMessage *msg = &msgs[i];
+
+		if (msg->id >= 0)
+		{
+			switch (msg->cc.id)
+			{
+				/*
+				 * These end up in objects that are not keyed by the changed
+				 * catalog entry: type objects embed operators and
+				 * aggregates, and relation objects embed their partitioning.
+				 */
+				case AGGFNOID:
+				case AMOPOPID:
+				case CASTSOURCETARGET:
+				case OPEROID:
+				case OPFAMILYOID:
+				case PARTOID:
+				case PARTRULEOID:
+					MDSharedCache->globalClock++;
+					break;
+
+				default:
+					MDSharedCacheClock(msg->cc.hashValue)++;
+					break;
+			}
+		}
+		else if (msg->id == SHAREDINVALRELCACHE_ID)
+		{
+			if (OidIsValid(msg->rc.relId))
+				MDSharedCacheClock(DatumGetUInt32(hash_uint32(msg->rc.relId)))++;
+			else
+				MDSharedCache->globalClock++;
+		}
+	}
+
+	LWLockRelease(MDSharedCacheLock);
+}
+
+/*
+ * Return the current version of a type, function, operator or relation
+ * object with the given OID.
+ *
+ * This also processes pending invalidation messages, so that an object
+ * translated from the catalogs right after this call is at least as new as
+ * the returned version.
+ */
+uint64
+MDSharedCacheObjectVersion(Oid objid)
+{
+	uint64		version;
+
+	if (MDSharedCache == NULL)
+		return 0;
+
+	LWLockAcquire(MDSharedCacheLock, LW_SHARED);
+	version = MDSharedCache->globalClock +
+		MDSharedCacheClock(DatumGetUInt32(hash_uint32(objid)));
+	LWLockRelease(MDSharedCacheLock);
+
+	AcceptInvalidationMessages();
+
+	return version;
+}
+
+/*
+ * Return the current version of the statistics of the given relation, or of
+ * the given column of it if attno is valid. Like MDSharedCacheObjectVersion,
+ * this also processes pending invalidation messages.
+ *
+ * Relation statistics come from pg_class, so the relcache clock of the
+ * relation covers them. Column statistics also depend on the pg_statistic
+ * entry of the column.
+ */
+uint64
+MDSharedCacheStatsVersion(Oid relid, AttrNumber attno)
+{
+	uint32		stathash = 0;
+	uint64		version;
+
+	if (MDSharedCache == NULL)
+		return 0;
+
+	if (AttributeNumberIsValid(attno))
+		stathash = GetSysCacheHashValue(STATRELATT,
+										ObjectIdGetDatum(relid),
+										Int16GetDatum(attno),
+										0, 0);
+
+	LWLockAcquire(MDSharedCacheLock, LW_SHARED);
+	version = MDSharedCache->globalClock +
+		MDSharedCacheClock(DatumGetUInt32(hash_uint32(relid)));
+	if (AttributeNumberIsValid(attno))
+		version += MDSharedCacheClock(stathash);
+	LWLockRelease(MDSharedCacheLock);
+
+	AcceptInvalidationMessages();
+
+	return version;
+}
+
+/*
+ * Build the hash key of an object, returns false if the key is too long
+ */
+static bool
+MDSharedCacheMakeKey(MDSharedCacheKey *hashkey, const char *key)
+{
+	if (strlen(key) >= MDSHAREDCACHE_KEYSIZE)
+		return false;
+
+	MemSet(hashkey, 0, sizeof(MDSharedCacheKey));
+	hashkey->dbid = MyDatabaseId;
+	strcpy(hashkey->mdid, key);
+
+	return true;
+}
+
+/*
+ * Look up an object in the shared cache. Returns a palloc'd copy of its DXL,
+ * or NULL if it is not cached at the given version, or if the current
+ * transaction has catalog changes of its own.
+ */
+char *
+MDSharedCacheLookup(const char *key, uint64 version)
+{
+	MDSharedCacheKey hashkey;
+	MDSharedCacheEntry *entry;
+	char	   *result = NULL;
+
+	if (MDSharedCache == NULL || TransactionHasPendingInvalidations() ||
+		!MDSharedCacheMakeKey(&hashkey, key))
+		return NULL;
+
+	LWLockAcquire(MDSharedCacheLock, LW_SHARED);
+
+	entry = (MDSharedCacheEntry *) hash_search(MDSharedCacheHash, &hashkey,
+											   HASH_FIND, NULL);
+	if (entry != NULL && entry->version == version)
+	{
+		MDSharedCacheRecord *record = (MDSharedCacheRecord *)
+			(MDSharedCache->log + entry->offset % MDSharedCache->logSize);
+
+		result = palloc(record->len + 1);
+		memcpy(result, (char *) record + MDSHAREDCACHE_RECORD_HDRSZ, record->len);
+		result[record->len] = '\0';
+	}
+
+	LWLockRelease(MDSharedCacheLock);
+
+	return result;
+}
+
+/*
+ * Add an object to the shared cache, replacing any older version of it.
+ *
+ * The version must have been obtained before translating the object.
+ */
+void
+MDSharedCacheInsert(const char *key, uint64 version, const char *data)
+{
+	MDSharedCacheKey hashkey;
+	MDSharedCacheEntry *entry;
+	MDSharedCacheRecord *record;
+	Size		len = strlen(data);
+	Size		size = MAXALIGN(MDSHAREDCACHE_RECORD_HDRSZ + len);
+	Size		padding;
+	bool		found;
+
+	if (MDSharedCache == NULL || TransactionHasPendingInvalidations() ||
+		!MDSharedCacheMakeKey(&hashkey, key))
+		return;
+
+	if (size > MDSharedCache->logSize / MDSHAREDCACHE_MAX_OBJECT_FRACTION)
+		return;
+
+	LWLockAcquire(MDSharedCacheLock, LW_EXCLUSIVE);
+
+	/* don't replace an object translated at a newer version */
+	entry = (MDSharedCacheEntry *) hash_search(MDSharedCacheHash, &hashkey,
+											   HASH_FIND, NULL);
+	if (entry != NULL && entry->version >= version)
+	{
+		LWLockRelease(MDSharedCacheLock);
+		return;
+	}
+
+	/* objects are stored contiguously, so wrap around if needed */
+	padding = MDSharedCache->logSize - MDSharedCache->head % MDSharedCache->logSize;
+	if (padding >= size)
+		padding = 0;
+
+	while (MDSharedCache->head + padding + size - MDSharedCache->tail > MDSharedCache->logSize ||
+		   (entry == NULL && hash_get_num_entries(MDSharedCacheHash) >= MDSharedCache->maxEntries))
+	{
+		MDSharedCacheEvictOldest();
+
+		/* we may have just evicted the old version of this object */
+		entry = (MDSharedCacheEntry *) hash_search(MDSharedCacheHash, &hashkey,
+												   HASH_FIND, NULL);
+	}
+
+	if (padding > 0)
+	{
+		if (padding >= MDSHAREDCACHE_RECORD_HDRSZ)
+		{
+			record = (MDSharedCacheRecord *)
+				(MDSharedCache->log + MDSharedCache->head % MDSharedCache->logSize);
+			record->size = padding;
+			record->len = 0;
+		}
+		MDSharedCache->head += padding;
+	}
+
+	record = (MDSharedCacheRecord *)
+		(MDSharedCache->log + MDSharedCache->head % MDSharedCache->logSize);
+	record->size = size;
+	record->len = len;
+	record->key = hashkey;
+	memcpy((char *) record + MDSHAREDCACHE_RECORD_HDRSZ, data, len);
+
+	entry = (MDSharedCacheEntry *) hash_search(MDSharedCacheHash, &hashkey,
+											   HASH_ENTER_NULL, &found);
+	if (entry != NULL)
+	{
+		entry->offset = MDSharedCache->head;
+		entry->version = version;
+		MDSharedCache->head += size;
+	}
+
+	LWLockRelease(MDSharedCacheLock);
+}
+
+/*
+ * Evict the oldest object in the log. Caller must hold MDSharedCacheLock
+ * exclusively, and the log must not be empty.
+ */
+static void
+MDSharedCacheEvictOldest(void)
+{
+	Size		remaining;
+	MDSharedCacheRecord *record;
+	MDSharedCacheEntry *entry;
+
+	Assert(MDSharedCache->tail < MDSharedCache->head);
+
+	/* skip the end of the log if there was no room for a padding record */
+	remaining = MDSharedCache->logSize - MDSharedCache->tail % MDSharedCache->logSize;
+	if (remaining < MDSHAREDCACHE_RECORD_HDRSZ)
+	{
+		MDSharedCache->tail += remaining;
+		return;
+	}
+
+	record = (MDSharedCacheRecord *)
+		(MDSharedCache->log + MDSharedCache->tail % MDSharedCache->logSize);
+
+	if (record->len > 0)
+	{
+		/* the object may have been replaced by a newer copy meanwhile */
+		entry = (MDSharedCacheEntry *) hash_search(MDSharedCacheHash, &record->key,
+												   HASH_FIND, NULL);
+		if (entry != NULL && entry->offset == MDSharedCache->tail)
+			hash_search(MDSharedCacheHash, &record->key, HASH_REMOVE, NULL);
+	}
+
+	MDSharedCache->tail += record->size;
+}
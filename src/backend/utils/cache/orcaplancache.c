@@ -0,0 +1,340 @@
+/*-------------------------------------------------------------------------
+ *
+ * orcaplancache.c
+ *	  Per-session cache of plans produced by the ORCA optimizer.
+ *
+ * Optimizing a large join with ORCA can take much longer than executing it,
+ * and the plans cached by plancache.c are thrown away on every invalidation
+ * and are not shared between statements that happen to be identical. This
+ * cache remembers the final PlannedStmt that ORCA produced for a query, so
+ * that optimizing the same query again can be skipped.
+ *
+ * Plans are keyed by the text form of the query tree after constant folding
+ * (so the values of any bound parameters are part of the key), plus the
+ * values of all GUCs that can change the chosen plan. ORCA folds constants
+ * into partition selection and cardinality estimates, so a plan can only be
+ * reused for the very same constants.
+ *
+ * Invalidation follows plancache.c: a relcache invalidation drops the plans
+ * that mention the relation (ANALYZE also sends one, as it updates pg_class),
+ * a pg_proc invalidation drops the plans depending on the function, and any
+ * change to the other catalogs that ORCA looks at drops all plans.
+ *
+ * Copyright (c) 2016, Pivotal Software, Inc.
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include "lib/dllist.h"
+#include "lib/stringinfo.h"
+#include "libpq/md5.h"
+#include "utils/guc.h"
+#include "utils/hsearch.h"
+#include "utils/inval.h"
+#include "utils/memutils.h"
+#include "utils/orcaplancache.h"
+#include "utils/syscache.h"
+
+/* length of a hex MD5 digest, including terminator */
+#define ORCAPLANCACHE_DIGESTSIZE	33
+
+typedef struct OrcaPlanCacheEntry
+{
+	char		digest[ORCAPLANCACHE_DIGESTSIZE];	/* hash key, must be first */
+	char	   *key;			/* full key, digests may collide */
+	PlannedStmt *plan;
+	MemoryContext context;		/* holds key and plan */
+	Size		size;			/* memory used by context */
+	Dlelem		lru_elem;		/* link in OrcaPlanCacheLRU */
+} OrcaPlanCacheEntry;
+
+static HTAB *OrcaPlanCacheHash = NULL;
+
+/* entries, most recently used first */
+static Dllist OrcaPlanCacheLRU;
+
+/* total memory used by the cached plans */
+static Size OrcaPlanCacheSize = 0;
+
+static void InitOrcaPlanCache(void);
+static char *OrcaPlanCacheMakeKey(Query *query);
+static void OrcaPlanCacheRemove(OrcaPlanCacheEntry *entry);
+static void OrcaPlanCacheRelCallback(Datum arg, Oid relid);
+static void OrcaPlanCacheFuncCallback(Datum arg, int cacheid, ItemPointer tuplePtr, uint32 hashValue);
+static void OrcaPlanCacheSysCallback(Datum arg, int cacheid, ItemPointer tuplePtr, uint32 hashValue);
+
+
+/*
+ * InitOrcaPlanCache: set up the hash table and invalidation callbacks, on
+ * first use.
+ */
+static void
+InitOrcaPlanCache(void)
+{
+	/* changes to any of these invalidate all cached plans */
+	static const int reset_caches[] = {
+		AGGFNOID,
+		AMOPOPID,
+		CASTSOURCETARGET,
+		CONSTROID,
+		NAMESPACEOID,
+		OPEROID,
+		OPFAMILYOID,
+		PARTOID,
+		PARTRULEOID,
+		TYPEOID
+	};
+	HASHCTL		ctl;
+	int			i;
+
+	MemSet(&ctl, 0, sizeof(ctl));
+	ctl.keysize = ORCAPLANCACHE_DIGESTSIZE;
+	ctl.entrysize = sizeof(OrcaPlanCacheEntry);
+	ctl.hash = string_hash;
+	ctl.hcxt = CacheMemoryContext;
+	OrcaPlanCacheHash = hash_create("ORCA plan cache", 64, &ctl,
+									HASH_ELEM | HASH_FUNCTION | HASH_CONTEXT);
+
+	DLInitList(&OrcaPlanCacheLRU);
+
+	CacheRegisterRelcacheCallback(OrcaPlanCacheRelCallback, (Datum) 0);
+	CacheRegisterSyscacheCallback(PROCOID, OrcaPlanCacheFuncCallback, (Datum) 0);
+	for (i = 0; i < lengthof(reset_caches); i++)
+		CacheRegisterSyscacheCallback(reset_caches[i], OrcaPlanCacheSysCallback, (Datum) 0);
+}
+
+/*
+ * Build the cache key of a query: its text form, and the values of the GUCs
+ * that can change its plan.
+ */
+static char *
+OrcaPlanCacheMakeKey(Query *query)
+{
+	StringInfoData buf;
+	char	   *querystr;
+
+	querystr = nodeToString(query);
+
+	initStringInfo(&buf);
+	appendStringInfoString(&buf, querystr);
+	appendStringInfoChar(&buf, '\n');
+	gp_guc_list_show(&buf, NULL, "%s=%s; ", PGC_S_DEFAULT, gp_guc_list_for_plan_key);
+
+	pfree(querystr);
+
+	return buf.data;
+}
+
+/*
+ * OrcaPlanCacheLookup: find the plan of a query in the cache.
+ *
+ * 'query' is the query tree as handed to ORCA, after constant folding.
+ * Returns a copy of the cached plan, or NULL if there is none. In the latter
+ * case, *key is set to the cache key to pass to OrcaPlanCacheInsert once the
+ * query has been optimized, or to NULL if the cache is disabled.
+ */
+PlannedStmt *
+OrcaPlanCacheLookup(Query *query, char **key)
+{
+	OrcaPlanCacheEntry *entry;
+	char		digest[ORCAPLANCACHE_DIGESTSIZE];
+
+	*key = NULL;
+
+	if (optimizer_plan_cache_size <= 0)
+	{
+		/* the cache may have been disabled after filling it */
+		if (OrcaPlanCacheSize > 0)
+			ResetOrcaPlanCache();
+		return NULL;
+	}
+
+	if (OrcaPlanCacheHash == NULL)
+		InitOrcaPlanCache();
+
+	*key = OrcaPlanCacheMakeKey(query);
+	if (!pg_md5_hash(*key, strlen(*key), digest))
+		ereport(ERROR,
+				(errcode(ERRCODE_OUT_OF_MEMORY),
+				 errmsg("out of memory")));
+
+	entry = (OrcaPlanCacheEntry *) hash_search(OrcaPlanCacheHash, digest,
+											   HASH_FIND, NULL);
+	if (entry == NULL || strcmp(entry->key, *key) != 0)
+		return NULL;
+
+	DLMoveToFront(&entry->lru_elem);
+
+	pfree(*key);
+	*key = NULL;
+
+	return (PlannedStmt *) copyObject(entry->plan);
+}
+
+/*
+ * OrcaPlanCacheInsert: remember the plan produced for a query.
+ *
+ * 'key' is the key returned by OrcaPlanCacheLookup for the query. The plan
+ * is copied, the caller keeps ownership of it.
+ */
+void
+OrcaPlanCacheInsert(const char *key, PlannedStmt *plan)
+{
+	OrcaPlanCacheEntry *entry;
+	MemoryContext context;
+	MemoryContext oldcxt;
+	char		digest[ORCAPLANCACHE_DIGESTSIZE];
+	Size		limit = (Size) optimizer_plan_cache_size * 1024L;
+	bool		found;
+
+	Assert(OrcaPlanCacheHash != NULL);
+
+	if (!pg_md5_hash(key, strlen(key), digest))
+		ereport(ERROR,
+				(errcode(ERRCODE_OUT_OF_MEMORY),
+				 errmsg("out of memory")));
+
+	context = AllocSetContextCreate(CacheMemoryContext,
+									"ORCA cached plan",
+									ALLOCSET_SMALL_MINSIZE,
+									ALLOCSET_SMALL_INITSIZE,
+									ALLOCSET_DEFAULT_MAXSIZE);
+	oldcxt = MemoryContextSwitchTo(context);
+	plan = (PlannedStmt *) copyObject(plan);
+	key = pstrdup(key);
+	MemoryContextSwitchTo(oldcxt);
+
+	/* plans reused from the cache took no time to optimize */
+	plan->optimizerQueryToDXLTime = 0;
+	plan->optimizerSearchTime = 0;
+	plan->optimizerDXLToPlStmtTime = 0;
+
+	/* don't let a single plan flush the whole cache */
+	if (MemoryContextGetCurrentSpace(context) > limit / 4)
+	{
+		MemoryContextDelete(context);
+		return;
+	}
+
+	/* replace any plan cached under a colliding digest */
+	entry = (OrcaPlanCacheEntry *) hash_search(OrcaPlanCacheHash, digest,
+											   HASH_FIND, NULL);
+	if (entry != NULL)
+		OrcaPlanCacheRemove(entry);
+
+	entry = (OrcaPlanCacheEntry *) hash_search(OrcaPlanCacheHash, digest,
+											   HASH_ENTER, &found);
+	Assert(!found);
+	entry->key = (char *) key;
+	entry->plan = plan;
+	entry->context = context;
+	entry->size = MemoryContextGetCurrentSpace(context);
+	DLInitElem(&entry->lru_elem, entry);
+	DLAddHead(&OrcaPlanCacheLRU, &entry->lru_elem);
+	OrcaPlanCacheSize += entry->size;
+
+	/* evict the least recently used plans to stay within the limit */
+	while (OrcaPlanCacheSize > limit)
+		OrcaPlanCacheRemove((OrcaPlanCacheEntry *) DLE_VAL(DLGetTail(&OrcaPlanCacheLRU)));
+}
+
+/*
+ * Remove an entry from the cache, and free its plan.
+ */
+static void
+OrcaPlanCacheRemove(OrcaPlanCacheEntry *entry)
+{
+	DLRemove(&entry->lru_elem);
+	OrcaPlanCacheSize -= entry->size;
+	MemoryContextDelete(entry->context);
+
+	hash_search(OrcaPlanCacheHash, entry->digest, HASH_REMOVE, NULL);
+}
+
+/*
+ * OrcaPlanCacheRelCallback
+ *		Relcache inval callback function
+ *
+ * Drop all plans mentioning the given rel, or all plans if
+ * relid == InvalidOid.
+ */
+static void
+OrcaPlanCacheRelCallback(Datum arg, Oid relid)
+{
+	HASH_SEQ_STATUS status;
+	OrcaPlanCacheEntry *entry;
+
+	if (relid == InvalidOid)
+	{
+		ResetOrcaPlanCache();
+		return;
+	}
+
+	hash_seq_init(&status, OrcaPlanCacheHash);
+	while ((entry = (OrcaPlanCacheEntry *) hash_seq_search(&status)) != NULL)
+	{
+		if (list_member_oid(entry->plan->relationOids, relid))
+			OrcaPlanCacheRemove(entry);
+	}
+}
+
+/*
+ * OrcaPlanCacheFuncCallback
+ *		Syscache inval callback function for PROCOID cache
+ *
+ * Drop all plans depending on the given function, or on any function if
+ * tuplePtr == NULL.
+ */
+static void
+OrcaPlanCacheFuncCallback(Datum arg, int cacheid, ItemPointer tuplePtr, uint32 hashValue)
+{
+	HASH_SEQ_STATUS status;
+	OrcaPlanCacheEntry *entry;
+
+	hash_seq_init(&status, OrcaPlanCacheHash);
+	while ((entry = (OrcaPlanCacheEntry *) hash_seq_search(&status)) != NULL)
+	{
+		ListCell   *lc;
+
+		foreach(lc, entry->plan->invalItems)
+		{
+			PlanInvalItem *item = (PlanInvalItem *) lfirst(lc);
+
+			if (item->cacheId != cacheid)
+				continue;
+			if (tuplePtr == NULL ||
+				ItemPointerEquals(tuplePtr, &item->tupleId))
+			{
+				OrcaPlanCacheRemove(entry);
+				break;
+			}
+		}
+	}
+}
+
+/*
+ * OrcaPlanCacheSysCallback
+ *		Syscache inval callback function for other caches
+ *
+ * Just drop everything...
+ */
+static void
+OrcaPlanCacheSysCallback(Datum arg, int cacheid, ItemPointer tuplePtr, uint32 hashValue)
+{
+	ResetOrcaPlanCache();
+}
+
+/*
+ * ResetOrcaPlanCache: drop all cached plans.
+ */
+void
+ResetOrcaPlanCache(void)
+{
+	Dlelem	   *elem;
+
+	while ((elem = DLGetHead(&OrcaPlanCacheLRU)) != NULL)
+		OrcaPlanCacheRemove((OrcaPlanCacheEntry *) DLE_VAL(elem));
+
+	Assert(OrcaPlanCacheSize == 0);
+}
@@ -767,6 +767,47 @@ ReleaseSysCache(HeapTuple tuple)
 	ReleaseCatCache(tuple);
 }
 
+/*
+ * GetSysCacheHashValue
+ *
+ * Get the hash value that would be used for a tuple in the specified cache
+ * with the given search keys.
+ *
+ * The reason for exposing this as part of the API is that the hash value is
+ * exposed in cache invalidation operations, so there are places outside the
+ * catcache code that need to be able to compute the hash values.
+ */
+uint32
+GetSysCacheHashValue(int cacheId,
+					 Datum key1,
+					 Datum key2,
+					 Datum key3,
+					 Datum key4)
+{
+	if (cacheId < 0 || cacheId >= SysCacheSize ||
+		!PointerIsValid(SysCache[cacheId]))
+		elog(ERROR, "invalid cache id: %d", cacheId);
+
+	return GetCatCacheHashValue(SysCache[cacheId], key1, key2, key3, key4);
+}
+
+/*
+ * SearchSysCacheByTid
+ *
+ * Return a copy of the catalog tuple at the given TID, if it is still the
+ * tuple that an invalidation message with this TID and hash value was sent
+ * for.  See SearchCatCacheByTid.
+ */
+HeapTuple
+SearchSysCacheByTid(int cacheId, ItemPointer tid, uint32 hashValue)
+{
+	if (cacheId < 0 || cacheId >= SysCacheSize ||
+		!PointerIsValid(SysCache[cacheId]))
+		elog(ERROR, "invalid cache id: %d", cacheId);
+
+	return SearchCatCacheByTid(SysCache[cacheId], tid, hashValue);
+}
+
 /*
  * SearchSysCacheCopy
  *
@@ -376,6 +376,7 @@ errstart(int elevel, const char *filename, int lineno,
 				case DTX_STATE_INSERTED_FORGET_COMMITTED:
 				case DTX_STATE_NOTIFYING_ABORT_NO_PREPARED:
 				case DTX_STATE_CRASH_COMMITTED:
+				case DTX_STATE_ONE_PHASE_COMMIT:
 					break;
 			}
 		}
@@ -57,6 +57,7 @@
 #include "utils/sharedsnapshot.h"
 #include "utils/syscache.h"
 #include "pgstat.h"
+#include "utils/memaccounting.h"
 #include "utils/session_state.h"
 #include "codegen/codegen_wrapper.h"
 
@@ -616,6 +617,9 @@ InitPostgres(const char *in_dbname, Oid dboid, const char *username,
 	/* Now that we have a BackendId, we can participate in ProcSignal */
 	ProcSignalInit(MyBackendId);
 
+	/* ... and publish our memory accounting balances */
+	MemoryAccounting_BackendStatsInit();
+
 	/*
 	 * bufmgr needs another initialization call too
 	 */
@@ -1095,6 +1099,8 @@ ShutdownPostgres(int code, Datum arg)
 	GPMemoryProtect_Shutdown();
 	/* Release SessionState entry */
 	SessionState_Shutdown();
+	/* Release memory accounting balances slot */
+	MemoryAccounting_BackendStatsShutdown();
 
 	/*
 	 * User locks are not released by transaction end, so be sure to release
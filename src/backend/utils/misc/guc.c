@@ -2864,6 +2864,9 @@ int get_num_guc_variables(void)
  *
  * - gp_guc_list_for_explain: consists of planner GUCs, plus 'work_mem'
  * - gp_guc_list_for_no_plan: planner method enables for cdb_no_plan_for_query().
+ * - gp_guc_list_for_plan_key: GUCs that can change the plan chosen by the
+ *   optimizer, for the optimizer plan cache: the explain list, plus developer
+ *   options and the optimizer GUCs.
  */
 static void
 gp_guc_list_init(void)
@@ -2880,12 +2883,18 @@ gp_guc_list_init(void)
         list_free(gp_guc_list_for_no_plan);
         gp_guc_list_for_no_plan = NIL;
     }
+    if (gp_guc_list_for_plan_key)
+    {
+        list_free(gp_guc_list_for_plan_key);
+        gp_guc_list_for_plan_key = NIL;
+    }
 
 	for (i = 0; i < num_guc_variables; i++)
 	{
 		struct config_generic  *gconf = guc_variables[i];
         bool    explain = false;
         bool    no_plan = false;
+        bool    plan_key = false;
 
         switch (gconf->group)
         {
@@ -2905,14 +2914,24 @@ gp_guc_list_init(void)
                     explain = true;
                 break;
 
+            case DEVELOPER_OPTIONS:
+                plan_key = true;
+                break;
+
             default:
                 break;
         }
 
+        if (explain ||
+            0 == pg_strncasecmp(gconf->name, "optimizer", strlen("optimizer")))
+            plan_key = true;
+
         if (explain)
             gp_guc_list_for_explain = lappend(gp_guc_list_for_explain, gconf);
         if (no_plan)
             gp_guc_list_for_no_plan = lappend(gp_guc_list_for_no_plan, gconf);
+        if (plan_key)
+            gp_guc_list_for_plan_key = lappend(gp_guc_list_for_plan_key, gconf);
 	}
 }                               /* gp_guc_list_init */
 
@@ -135,6 +135,7 @@ extern bool gp_hash_index;
 /* GUC lists for gp_guc_list_show().  (List of struct config_generic) */
 List	   *gp_guc_list_for_explain;
 List	   *gp_guc_list_for_no_plan;
+List	   *gp_guc_list_for_plan_key;
 
 char	   *Debug_dtm_action_sql_command_tag;
 char	   *Debug_dtm_action_str;
@@ -489,6 +490,8 @@ bool		optimizer_print_plan;
 bool		optimizer_print_xform;
 bool		optimizer_metadata_caching;
 int		optimizer_mdcache_size;
+int		optimizer_mdcache_shared_size;
+int		optimizer_plan_cache_size;
 bool		optimizer_disable_xform_result_printing;
 bool		optimizer_print_memo_after_exploration;
 bool		optimizer_print_memo_after_implementation;
@@ -544,6 +547,7 @@ double		optimizer_damping_factor_filter;
 double		optimizer_damping_factor_join;
 double		optimizer_damping_factor_groupby;
 int			optimizer_segments;
+int			optimizer_time_budget;
 int			optimizer_join_arity_for_associativity_commutativity;
 int         optimizer_array_expansion_threshold;
 int         optimizer_join_order_threshold;
@@ -2128,6 +2132,14 @@ struct config_bool ConfigureNamesBool_gp[] =
 		&gp_statistics_use_fkeys,
 		true, NULL, NULL
 	},
+	{
+		{"gp_statistics_use_hll", PGC_USERSET, STATS_ANALYZE,
+			gettext_noop("Use HyperLogLog sketches built on the segments to estimate the number of distinct values in ANALYZE."),
+			gettext_noop("Each table is scanned in full, and the root partition statistics are merged from the leaf partitions instead of sampling them again.")
+		},
+		&gp_statistics_use_hll,
+		false, NULL, NULL
+	},
 
 	{
 		{"gp_eager_hashtable_release", PGC_USERSET, DEPRECATED_OPTIONS,
@@ -2528,6 +2540,26 @@ struct config_bool ConfigureNamesBool_gp[] =
 		false, NULL, NULL
 	},
 
+	{
+		{"gp_resqueue_memory_broker", PGC_USERSET, RESOURCES_MEM,
+			gettext_noop("Allows operators to hand unused memory quota to other operators of the same query at runtime."),
+			gettext_noop("An operator that would otherwise spill to disk borrows quota released by its siblings."),
+			GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE | GUC_GPDB_ADDOPT
+		},
+		&gp_resqueue_memory_broker,
+		false, NULL, NULL
+	},
+
+	{
+		{"gp_enable_per_tuple_arena", PGC_USERSET, DEVELOPER_OPTIONS,
+			gettext_noop("Use bump-pointer arena memory contexts for per-tuple expression evaluation."),
+			gettext_noop("Memory freed with pfree() in such a context is only reclaimed when the context is reset."),
+			GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE | GUC_GPDB_ADDOPT
+		},
+		&gp_enable_per_tuple_arena,
+		false, NULL, NULL
+	},
+
 	{
 		{"gp_dynamic_partition_pruning", PGC_USERSET, QUERY_TUNING_METHOD,
 			gettext_noop("This guc enables plans that can dynamically eliminate scanning of partitions."),
@@ -4020,6 +4052,16 @@ struct config_int ConfigureNamesInt_gp[] =
 		0, 0, INT_MAX, assign_gp_connections_per_thread, show_gp_connections_per_thread
 	},
 
+	{
+		{"gp_dispatch_send_threads", PGC_USERSET, GP_ARRAY_TUNING,
+			gettext_noop("Sets the number of threads the asynchronous dispatcher uses to send a query to the segments."),
+			gettext_noop("0 or 1 sends from the main backend thread."),
+			GUC_NOT_IN_SAMPLE
+		},
+		&gp_dispatch_send_threads,
+		0, 0, 64, NULL, NULL
+	},
+
 	{
 		{"gp_subtrans_warn_limit", PGC_POSTMASTER, RESOURCES,
 			gettext_noop("Sets the warning limit on number of subtransactions in a transaction."),
@@ -4040,6 +4082,17 @@ struct config_int ConfigureNamesInt_gp[] =
 		5, 0, INT_MAX, NULL, NULL
 	},
 
+	{
+		{"gp_warm_reader_gangs", PGC_USERSET, GP_ARRAY_TUNING,
+			gettext_noop("Sets the number of idle reader segment worker groups to create ahead of time."),
+			gettext_noop("They are created while the session waits for the client, up to "
+						 "gp_cached_segworkers_threshold. 0 creates them on demand only."),
+			GUC_NOT_IN_SAMPLE
+		},
+		&gp_warm_reader_gangs,
+		0, 0, INT_MAX, NULL, NULL
+	},
+
 
 	{
 #ifdef USE_ASSERT_CHECKING
@@ -4670,6 +4723,18 @@ struct config_int ConfigureNamesInt_gp[] =
 		0, 0, INT_MAX, NULL, NULL
 	},
 
+	{
+		{"optimizer_time_budget", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Sets the maximum time the optimizer may spend on a query."),
+			gettext_noop("The search stages are shortened to fit in the budget. If the optimizer "
+						 "still cannot produce a plan in time, the query is planned by the legacy "
+						 "planner instead. Zero disables the limit."),
+			GUC_UNIT_MS
+		},
+		&optimizer_time_budget,
+		0, 0, INT_MAX, NULL, NULL
+	},
+
 	{
 		{"optimizer_array_expansion_threshold", PGC_USERSET, QUERY_TUNING_METHOD,
 			gettext_noop("Item limit for expansion of arrays in WHERE clause to disjunctive form."),
@@ -4709,6 +4774,27 @@ struct config_int ConfigureNamesInt_gp[] =
 		0, 0, INT_MAX, NULL, NULL
 	},
 
+	{
+		{"optimizer_mdcache_shared_size", PGC_POSTMASTER, RESOURCES_MEM,
+			gettext_noop("Sets the size of the MDCache shared by all sessions on the master."),
+			gettext_noop("Zero disables the shared MDCache."),
+			GUC_UNIT_KB
+		},
+		&optimizer_mdcache_shared_size,
+		0, 0, MAX_KILOBYTES, NULL, NULL
+	},
+
+	{
+		{"optimizer_plan_cache_size", PGC_USERSET, RESOURCES_MEM,
+			gettext_noop("Sets the size of the cache of plans produced by the optimizer in each session."),
+			gettext_noop("Plans are only reused for queries with the same constants and parameter values. "
+						 "Zero disables the plan cache."),
+			GUC_UNIT_KB
+		},
+		&optimizer_plan_cache_size,
+		0, 0, MAX_KILOBYTES, NULL, NULL
+	},
+
 	{
 		{"memory_profiler_dataset_size", PGC_USERSET, DEVELOPER_OPTIONS,
 			gettext_noop("Set the size in GB"),
@@ -5658,6 +5744,11 @@ assign_debug_dtm_action_protocol(const char *newval,
 		if (doit)
 			Debug_dtm_action_protocol = DTX_PROTOCOL_COMMAND_SUBTRANSACTION_ROLLBACK_INTERNAL;
 	}
+	else if (pg_strcasecmp(newval, "commit_onephase") == 0)
+	{
+		if (doit)
+			Debug_dtm_action_protocol = DTX_PROTOCOL_COMMAND_COMMIT_ONEPHASE;
+	}
 	else
 		return NULL;			/* fail */
 	return newval;				/* OK */
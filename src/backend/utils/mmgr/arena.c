@@ -0,0 +1,676 @@
+/*-------------------------------------------------------------------------
+ *
+ * arena.c
+ *	  Arena (bump-pointer) implementation of MemoryContext.
+ *
+ * An arena hands out chunks from its active block by simply advancing a
+ * pointer.  Individual chunks are never recycled: pfree() is a no-op for
+ * ordinary chunks, and all the space is given back at once when the
+ * context is reset or deleted.  This suits contexts that see lots of tiny
+ * allocations and get reset often, e.g. per-tuple expression contexts,
+ * where AllocSet's freelist management and per-chunk memory accounting
+ * are pure overhead.
+ *
+ * Every chunk still carries a StandardChunkHeader, so that pfree(),
+ * repalloc() and GetMemoryChunkContext() work on arena chunks.  All chunks
+ * of an arena point to the same SharedChunkHeader embedded in the context.
+ *
+ * Requests larger than chunkLimit get a dedicated block, which pfree()
+ * does return to the host memory manager.  This keeps repeatedly
+ * repalloc()'d buffers from piling up dead copies.
+ *
+ * Memory accounting is done per block: each block is charged, as a whole,
+ * to the memory account that was active when the block was obtained.
+ *
+ * Copyright (c) 2016, Pivotal Inc.
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "postgres.h"
+
+#include "utils/memutils.h"
+#include "utils/memaccounting.h"
+#include "utils/gp_alloc.h"
+
+#include "utils/memaccounting_private.h"
+
+#ifdef CDB_PALLOC_CALLER_ID
+#define CDB_MCXT_WHERE(context) (context)->callerFile, (context)->callerLine
+#else
+#define CDB_MCXT_WHERE(context) __FILE__, __LINE__
+#endif
+
+/*
+ * ArenaBlock
+ *		The unit of memory that arena.c obtains from gp_malloc().  The usable
+ *		space begins at the next alignment boundary after the header.
+ */
+typedef struct ArenaBlockData
+{
+	ArenaBlock	next;			/* next block in the arena's blocks list */
+	ArenaBlock	prev;			/* previous block, NULL for the first one */
+	char	   *freeptr;		/* start of free space, unless block is active */
+	MemoryAccountIdType memoryAccountId;	/* account charged for the block */
+} ArenaBlockData;
+
+/* Arena chunks use the standard chunk header as is */
+typedef StandardChunkHeader *ArenaChunk;
+
+#define ARENA_BLOCKHDRSZ	MAXALIGN(sizeof(ArenaBlockData))
+#define ARENA_CHUNKHDRSZ	STANDARDCHUNKHEADERSIZE
+
+#define ArenaPointerGetChunk(ptr) \
+					((ArenaChunk)(((char *)(ptr)) - ARENA_CHUNKHDRSZ))
+#define ArenaChunkGetPointer(chk) \
+					((void *)(((char *)(chk)) + ARENA_CHUNKHDRSZ))
+#define ArenaChunkGetBlock(chk) \
+					((ArenaBlock)(((char *)(chk)) - ARENA_BLOCKHDRSZ))
+
+/*
+ * These functions implement the MemoryContext API for Arena contexts.
+ */
+static void *ArenaAlloc(MemoryContext context, Size size);
+static void ArenaFree(MemoryContext context, void *pointer);
+static void *ArenaRealloc(MemoryContext context, void *pointer, Size size);
+static void ArenaInit(MemoryContext context);
+static void ArenaReset(MemoryContext context);
+static void ArenaDelete(MemoryContext context);
+static Size ArenaGetChunkSpace(MemoryContext context, void *pointer);
+static bool ArenaIsEmpty(MemoryContext context);
+static void Arena_GetStats(MemoryContext context, uint64 *nBlocks, uint64 *nChunks,
+		uint64 *currentAvailable, uint64 *allAllocated, uint64 *allFreed, uint64 *maxHeld);
+static void ArenaReleaseAccounting(MemoryContext context);
+
+#ifdef MEMORY_CONTEXT_CHECKING
+static void ArenaCheck(MemoryContext context);
+#endif
+
+/*
+ * This is the virtual function table for Arena contexts.
+ */
+static MemoryContextMethods ArenaMethods = {
+	ArenaAlloc,
+	ArenaFree,
+	ArenaRealloc,
+	ArenaInit,
+	ArenaReset,
+	ArenaDelete,
+	ArenaGetChunkSpace,
+	ArenaIsEmpty,
+	Arena_GetStats,
+	ArenaReleaseAccounting
+#ifdef MEMORY_CONTEXT_CHECKING
+	,ArenaCheck
+#endif
+};
+
+/*
+ * ArenaChargeBlock
+ *		Charges a newly obtained (or reused) block to the active memory account.
+ */
+static inline void
+ArenaChargeBlock(ArenaBlock block)
+{
+	block->memoryAccountId = ActiveMemoryAccountId;
+
+	/*
+	 * Blocks obtained before memory accounting is set up are not tallied,
+	 * same as AllocSet chunks.
+	 */
+	if (ActiveMemoryAccountId != MEMORY_OWNER_TYPE_Undefined)
+		MemoryAccounting_Allocate(ActiveMemoryAccountId, UserPtr_GetUserPtrSize(block));
+}
+
+/*
+ * ArenaReleaseBlockAccounting
+ *		Releases the accounting of a block. Safe to call more than once.
+ */
+static inline void
+ArenaReleaseBlockAccounting(ArenaBlock block)
+{
+	if (block->memoryAccountId != MEMORY_OWNER_TYPE_Undefined)
+	{
+		MemoryAccounting_Free(block->memoryAccountId, UserPtr_GetUserPtrSize(block));
+		block->memoryAccountId = MEMORY_OWNER_TYPE_Undefined;
+	}
+}
+
+/*
+ * ArenaFreeBlock
+ *		Returns a block to the host memory manager.
+ */
+static void
+ArenaFreeBlock(Arena arena, ArenaBlock block)
+{
+	size_t		freesz = UserPtr_GetUserPtrSize(block);
+
+	ArenaReleaseBlockAccounting(block);
+	MemoryContextNoteFree(&arena->header, freesz);
+
+#ifdef CLOBBER_FREED_MEMORY
+	/* Wipe freed memory for debugging purposes */
+	memset(block, 0x7F, freesz);
+#endif
+	gp_free(block);
+}
+
+/*
+ * ArenaNewBlock
+ *		Obtains a block of blksize bytes and charges it to the active
+ *		memory account.  The caller links it into the blocks list.
+ */
+static ArenaBlock
+ArenaNewBlock(Arena arena, Size blksize, Size size)
+{
+	ArenaBlock	block = (ArenaBlock) gp_malloc(blksize);
+
+	if (block == NULL)
+		MemoryContextError(ERRCODE_OUT_OF_MEMORY,
+						   &arena->header, CDB_MCXT_WHERE(&arena->header),
+						   "Out of memory.  Failed on request of size %lu bytes.",
+						   (unsigned long) size);
+
+	block->freeptr = ((char *) block) + ARENA_BLOCKHDRSZ;
+	MemoryContextNoteAlloc(&arena->header, UserPtr_GetUserPtrSize(block));
+	ArenaChargeBlock(block);
+
+	return block;
+}
+
+
+/*
+ * Public routines
+ */
+
+
+/*
+ * ArenaContextCreate
+ *		Create a new Arena context.
+ *
+ * parent: parent context, or NULL if top-level context
+ * name: name of context (for debugging --- string will be copied)
+ * blockSize: size of the blocks that chunks are carved from
+ */
+MemoryContext
+ArenaContextCreate(MemoryContext parent,
+				   const char *name,
+				   Size blockSize)
+{
+	Arena		arena;
+
+	/* Do the type-independent part of context creation */
+	arena = (Arena) MemoryContextCreate(T_ArenaContext,
+										sizeof(ArenaContext),
+										&ArenaMethods,
+										parent,
+										name);
+
+	/* We somewhat arbitrarily enforce a minimum 1K block size, like aset.c */
+	blockSize = MAXALIGN(blockSize);
+	if (blockSize < 1024)
+		blockSize = 1024;
+	arena->blockSize = blockSize;
+
+	/*
+	 * Chunks taking more than a quarter of a block get a block of their own,
+	 * so that at most a quarter of a regular block is ever wasted at its end.
+	 * Keep the limit aligned, so that the size of a chunk alone tells which
+	 * kind it is.
+	 */
+	arena->chunkLimit = MAXALIGN_DOWN((blockSize - ARENA_BLOCKHDRSZ) / 4);
+
+	arena->sharedHeader.context = (MemoryContext) arena;
+	arena->sharedHeader.memoryAccountId = MEMORY_OWNER_TYPE_Undefined;
+	arena->sharedHeader.balance = 0;
+	arena->sharedHeader.prev = NULL;
+	arena->sharedHeader.next = NULL;
+
+	arena->isReset = true;
+
+	return (MemoryContext) arena;
+}
+
+/*
+ * ArenaInit
+ *		Context-type-specific initialization routine.
+ */
+static void
+ArenaInit(MemoryContext context)
+{
+	/*
+	 * Since MemoryContextCreate already zeroed the context node, we don't
+	 * have to do anything here: it's already OK.
+	 */
+}
+
+/*
+ * ArenaReleaseAccounting
+ *		Releases the accounting of all the blocks, without freeing them.
+ *
+ * Like its AllocSet counterpart, this can be called any number of times.
+ */
+static void
+ArenaReleaseAccounting(MemoryContext context)
+{
+	Arena		arena = (Arena) context;
+	ArenaBlock	block;
+
+	for (block = arena->blocks; block != NULL; block = block->next)
+		ArenaReleaseBlockAccounting(block);
+}
+
+/*
+ * ArenaReset
+ *		Frees all memory which is allocated in the given arena.
+ *
+ * The keeper block is retained, so that an arena that is reset after every
+ * tuple doesn't go back to gp_malloc() every time.
+ */
+static void
+ArenaReset(MemoryContext context)
+{
+	Arena		arena = (Arena) context;
+	ArenaBlock	block;
+
+	/* Nothing to do if no pallocs since startup or last reset */
+	if (arena->isReset)
+		return;
+
+#ifdef MEMORY_CONTEXT_CHECKING
+	/* Check for corruption before freeing */
+	ArenaCheck(context);
+#endif
+
+	block = arena->blocks;
+	arena->blocks = NULL;
+
+	while (block != NULL)
+	{
+		ArenaBlock	next = block->next;
+
+		if (block == arena->keeper)
+		{
+			/*
+			 * Keep the block, but release its accounting. It is charged
+			 * again when it is next put to use.
+			 */
+			ArenaReleaseBlockAccounting(block);
+
+			block->freeptr = ((char *) block) + ARENA_BLOCKHDRSZ;
+#ifdef CLOBBER_FREED_MEMORY
+			/* Wipe freed memory for debugging purposes */
+			memset(block->freeptr, 0x7F, (char *) UserPtr_GetEndPtr(block) - block->freeptr);
+#endif
+			block->next = NULL;
+			block->prev = NULL;
+			arena->blocks = block;
+		}
+		else
+			ArenaFreeBlock(arena, block);
+
+		block = next;
+	}
+
+	/* Nothing is active until the next allocation */
+	arena->freeptr = NULL;
+	arena->endptr = NULL;
+
+	arena->isReset = true;
+}
+
+/*
+ * ArenaDelete
+ *		Frees all memory which is allocated in the given arena,
+ *		in preparation for deletion of the arena.
+ */
+static void
+ArenaDelete(MemoryContext context)
+{
+	Arena		arena = (Arena) context;
+	ArenaBlock	block = arena->blocks;
+
+#ifdef MEMORY_CONTEXT_CHECKING
+	/* Check for corruption before freeing */
+	ArenaCheck(context);
+#endif
+
+	/* Make it look empty, just in case... */
+	arena->blocks = NULL;
+	arena->keeper = NULL;
+	arena->freeptr = NULL;
+	arena->endptr = NULL;
+
+	while (block != NULL)
+	{
+		ArenaBlock	next = block->next;
+
+		ArenaFreeBlock(arena, block);
+		block = next;
+	}
+}
+
+/*
+ * ArenaAllocLarge
+ *		Allocates a chunk too big for a regular block in a block of its own.
+ */
+static void *
+ArenaAllocLarge(Arena arena, Size size)
+{
+	Size		chunk_size = MAXALIGN(size);
+	ArenaBlock	block;
+	ArenaChunk	chunk;
+
+	block = ArenaNewBlock(arena, chunk_size + ARENA_BLOCKHDRSZ + ARENA_CHUNKHDRSZ, size);
+	block->freeptr = UserPtr_GetEndPtr(block);
+
+	/*
+	 * Stick the new block underneath the active block, so that we don't
+	 * lose the use of the space remaining therein.
+	 */
+	if (arena->blocks != NULL)
+	{
+		block->prev = arena->blocks;
+		block->next = arena->blocks->next;
+		if (block->next != NULL)
+			block->next->prev = block;
+		arena->blocks->next = block;
+	}
+	else
+	{
+		/* No active block; make sure the next small request starts one */
+		block->prev = NULL;
+		block->next = NULL;
+		arena->blocks = block;
+		arena->freeptr = NULL;
+		arena->endptr = NULL;
+	}
+
+	chunk = (ArenaChunk) (((char *) block) + ARENA_BLOCKHDRSZ);
+	chunk->sharedHeader = &arena->sharedHeader;
+	chunk->size = chunk_size;
+#ifdef MEMORY_CONTEXT_CHECKING
+	chunk->requested_size = size;
+	/* set mark to catch clobber of "unused" space */
+	if (size < chunk_size)
+		((char *) ArenaChunkGetPointer(chunk))[size] = 0x7E;
+#endif
+
+	arena->isReset = false;
+
+	return ArenaChunkGetPointer(chunk);
+}
+
+/*
+ * ArenaAlloc
+ *		Returns pointer to allocated memory of given size; memory is added
+ *		to the arena.
+ */
+static void *
+ArenaAlloc(MemoryContext context, Size size)
+{
+	Arena		arena = (Arena) context;
+	Size		chunk_size;
+	ArenaChunk	chunk;
+
+	if (size > arena->chunkLimit)
+		return ArenaAllocLarge(arena, size);
+
+	chunk_size = MAXALIGN(size);
+
+	/* Start a new block if the active one is full (or there is none) */
+	if ((Size) (arena->endptr - arena->freeptr) < chunk_size + ARENA_CHUNKHDRSZ)
+	{
+		ArenaBlock	block;
+
+		if (arena->freeptr == NULL && arena->keeper != NULL &&
+			arena->blocks == arena->keeper)
+		{
+			/* Put the keeper block retained by the last reset back to use */
+			block = arena->keeper;
+			ArenaChargeBlock(block);
+		}
+		else
+		{
+			block = ArenaNewBlock(arena, arena->blockSize, size);
+
+			/* Remember where the old active block stopped */
+			if (arena->freeptr != NULL)
+				arena->blocks->freeptr = arena->freeptr;
+
+			block->prev = NULL;
+			block->next = arena->blocks;
+			if (block->next != NULL)
+				block->next->prev = block;
+			arena->blocks = block;
+
+			/* The first regular block is kept across resets */
+			if (arena->keeper == NULL)
+				arena->keeper = block;
+		}
+
+		arena->freeptr = block->freeptr;
+		arena->endptr = UserPtr_GetEndPtr(block);
+	}
+
+	chunk = (ArenaChunk) arena->freeptr;
+	arena->freeptr += chunk_size + ARENA_CHUNKHDRSZ;
+	Assert(arena->freeptr <= arena->endptr);
+
+	chunk->sharedHeader = &arena->sharedHeader;
+	chunk->size = chunk_size;
+#ifdef MEMORY_CONTEXT_CHECKING
+	chunk->requested_size = size;
+	/* set mark to catch clobber of "unused" space */
+	if (size < chunk_size)
+		((char *) ArenaChunkGetPointer(chunk))[size] = 0x7E;
+#endif
+
+	arena->isReset = false;
+
+	return ArenaChunkGetPointer(chunk);
+}
+
+/*
+ * ArenaFree
+ *		Ordinary chunks are only released by reset or delete.  A chunk that
+ *		has a block of its own gives the block back right away.
+ */
+static void
+ArenaFree(MemoryContext context, void *pointer)
+{
+	Arena		arena = (Arena) context;
+	ArenaChunk	chunk = ArenaPointerGetChunk(pointer);
+	ArenaBlock	block;
+
+	if (chunk->size <= arena->chunkLimit)
+		return;
+
+	block = ArenaChunkGetBlock(chunk);
+	Assert(block != arena->blocks || arena->freeptr == NULL);
+
+	if (block->prev != NULL)
+		block->prev->next = block->next;
+	else
+		arena->blocks = block->next;
+	if (block->next != NULL)
+		block->next->prev = block->prev;
+
+	ArenaFreeBlock(arena, block);
+}
+
+/*
+ * ArenaRealloc
+ *		Returns new pointer to allocated memory of given size.
+ *
+ * A chunk that is the last one carved off the active block grows in place
+ * when there is room, which makes the common StringInfo-style growth cheap.
+ */
+static void *
+ArenaRealloc(MemoryContext context, void *pointer, Size size)
+{
+	Arena		arena = (Arena) context;
+	ArenaChunk	chunk = ArenaPointerGetChunk(pointer);
+	Size		oldsize = chunk->size;
+	void	   *newPointer;
+
+#ifdef MEMORY_CONTEXT_CHECKING
+	/* Test for someone scribbling on unused space in chunk */
+	if (chunk->requested_size < oldsize &&
+		((char *) pointer)[chunk->requested_size] != 0x7E)
+	{
+		Assert(!"Memory error");
+		elog(WARNING, "detected write past chunk end in %s %p (%s:%d)",
+			 arena->header.name, chunk, CDB_MCXT_WHERE(&arena->header));
+	}
+#endif
+
+	if (oldsize >= size)
+	{
+#ifdef MEMORY_CONTEXT_CHECKING
+		chunk->requested_size = size;
+		if (size < oldsize)
+			((char *) pointer)[size] = 0x7E;
+#endif
+		return pointer;
+	}
+
+	if (size <= arena->chunkLimit &&
+		(char *) pointer + oldsize == arena->freeptr &&
+		(Size) (arena->endptr - (char *) pointer) >= MAXALIGN(size))
+	{
+		chunk->size = MAXALIGN(size);
+		arena->freeptr = (char *) pointer + chunk->size;
+#ifdef MEMORY_CONTEXT_CHECKING
+		chunk->requested_size = size;
+		if (size < chunk->size)
+			((char *) pointer)[size] = 0x7E;
+#endif
+		return pointer;
+	}
+
+	newPointer = ArenaAlloc(context, size);
+	memcpy(newPointer, pointer, oldsize);
+	ArenaFree(context, pointer);
+
+	return newPointer;
+}
+
+/*
+ * ArenaGetChunkSpace
+ *		Given a currently-allocated chunk, determine the total space
+ *		it occupies (including all memory-allocation overhead).
+ */
+static Size
+ArenaGetChunkSpace(MemoryContext context, void *pointer)
+{
+	ArenaChunk	chunk = ArenaPointerGetChunk(pointer);
+
+	return chunk->size + ARENA_CHUNKHDRSZ;
+}
+
+/*
+ * ArenaIsEmpty
+ *		Is an arena empty of any allocated space?
+ */
+static bool
+ArenaIsEmpty(MemoryContext context)
+{
+	return ((Arena) context)->isReset;
+}
+
+/*
+ * Arena_GetStats
+ *		Returns stats about memory consumption of an arena.  See
+ *		AllocSet_GetStats for the meaning of the output parameters; the
+ *		free space at the end of the active block counts as the one
+ *		available chunk.
+ */
+static void
+Arena_GetStats(MemoryContext context, uint64 *nBlocks, uint64 *nChunks,
+		uint64 *currentAvailable, uint64 *allAllocated, uint64 *allFreed, uint64 *maxHeld)
+{
+	Arena		arena = (Arena) context;
+	ArenaBlock	block;
+
+	*nBlocks = 0;
+	*nChunks = 0;
+	*currentAvailable = 0;
+	*allAllocated = arena->header.allBytesAlloc;
+	*allFreed = arena->header.allBytesFreed;
+	*maxHeld = arena->header.maxBytesHeld;
+
+	for (block = arena->blocks; block != NULL; block = block->next)
+		*nBlocks = *nBlocks + 1;
+
+	if (arena->freeptr != NULL)
+	{
+		*nChunks = 1;
+		*currentAvailable = arena->endptr - arena->freeptr;
+	}
+}
+
+#ifdef MEMORY_CONTEXT_CHECKING
+
+/*
+ * ArenaCheck
+ *		Walk through chunks and check consistency of memory.
+ *
+ * NOTE: report errors as WARNING, *not* ERROR or FATAL, for the same reason
+ * as AllocSetCheck.
+ */
+static void
+ArenaCheck(MemoryContext context)
+{
+	Arena		arena = (Arena) context;
+	char	   *name = arena->header.name;
+	ArenaBlock	block;
+
+	for (block = arena->blocks; block != NULL; block = block->next)
+	{
+		char	   *bpoz = ((char *) block) + ARENA_BLOCKHDRSZ;
+		char	   *bend = (block == arena->blocks && arena->freeptr != NULL) ?
+			arena->freeptr : block->freeptr;
+
+		while (bpoz < bend)
+		{
+			ArenaChunk	chunk = (ArenaChunk) bpoz;
+			Size		chsize = chunk->size;
+			Size		dsize = chunk->requested_size;
+
+			if (chunk->sharedHeader != &arena->sharedHeader)
+			{
+				Assert(!"Memory context error");
+				elog(WARNING, "problem in arena %s: bogus context link in block %p, chunk %p (%s:%d)",
+					 name, block, chunk, CDB_MCXT_WHERE(&arena->header));
+				break;
+			}
+
+			if (dsize > chsize)
+			{
+				Assert(!"Memory context error");
+				elog(WARNING, "problem in arena %s: req size > alloc size for chunk %p in block %p (%s:%d)",
+					 name, chunk, block, CDB_MCXT_WHERE(&arena->header));
+			}
+
+			/* Check for overwrite of "unallocated" space in chunk */
+			if (dsize < chsize && ((char *) ArenaChunkGetPointer(chunk))[dsize] != 0x7E)
+			{
+				Assert(!"Memory context error");
+				elog(WARNING, "problem in arena %s: detected write past chunk end in block %p, chunk %p (%s:%d)",
+					 name, block, chunk, CDB_MCXT_WHERE(&arena->header));
+			}
+
+			bpoz += ARENA_CHUNKHDRSZ + chsize;
+		}
+
+		if (bpoz != bend)
+		{
+			Assert(!"Memory context error");
+			elog(WARNING, "problem in arena %s: found inconsistent memory block %p (%s:%d)",
+				 name, block, CDB_MCXT_WHERE(&arena->header));
+		}
+	}
+}
+
+#endif   /* MEMORY_CONTEXT_CHECKING */
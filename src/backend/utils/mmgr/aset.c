@@ -289,6 +289,17 @@ static void dump_mc_for(FILE *file, MemoryContext mc)
 	if (mc == NULL)
 		return;
 
+	if (!IsA(mc, AllocSetContext))
+	{
+		/* Only AllocSets have blocks and freelists we know how to dump */
+		fprintf(file, "%p|%p|%d|%s|"UINT64_FORMAT"|"UINT64_FORMAT"|%zu\n", mc, mc->parent, mc->type, mc->name,
+				mc->allBytesAlloc, mc->allBytesFreed, mc->maxBytesHeld);
+
+		dump_mc_for(file, mc->nextchild);
+		dump_mc_for(file, mc->firstchild);
+		return;
+	}
+
 	AllocSet set = (AllocSet) mc;
 	fprintf(file, "%p|%p|%d|%s|"UINT64_FORMAT"|"UINT64_FORMAT"|%zu|%zu|%zu|%zu|%d", mc, mc->parent, mc->type, mc->name,
 			mc->allBytesAlloc, mc->allBytesFreed, mc->maxBytesHeld,
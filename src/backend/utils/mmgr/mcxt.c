@@ -916,6 +916,12 @@ MemoryContextContainsGenericAllocation(MemoryContext context, void *pointer)
 	header = (StandardChunkHeader *)
 		((char *) pointer - STANDARDCHUNKHEADERSIZE);
 
+	/* All chunks of an arena share the header embedded in the context */
+	if (IsA(context, ArenaContext))
+	{
+		return header->sharedHeader == &((Arena) context)->sharedHeader;
+	}
+
 	AllocSet set = (AllocSet)context;
 
 	if (header->sharedHeader == set->sharedHeaderList ||
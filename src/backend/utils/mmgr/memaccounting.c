@@ -19,10 +19,13 @@
 #include "cdb/cdbvars.h"
 #include "access/xact.h"
 #include "miscadmin.h"
+#include "storage/backendid.h"
+#include "storage/shmem.h"
 #include "utils/vmem_tracker.h"
 #include "utils/memaccounting_private.h"
 
 #define MEMORY_REPORT_FILE_NAME_LENGTH 255
+#define SHMEM_MEMORY_ACCOUNTING_BACKEND_STATS "Memory Accounting Backend Stats"
 #define SHORT_LIVING_MEMORY_ACCOUNT_ARRAY_INIT_LEN 64
 
 /* Saves serializer context info during walking the memory account array */
@@ -126,12 +129,12 @@ MemoryAccountToLog(MemoryAccountTree *memoryAccountTreeNode, void *context,
 static void
 SaveMemoryBufToDisk(struct StringInfoData *memoryBuf, char *prefix);
 
-static const char*
-MemoryAccounting_GetOwnerName(MemoryOwnerType ownerType);
-
 static void
 MemoryAccounting_ResetPeakBalance(void);
 
+static void
+PublishBackendStats(void);
+
 static uint64
 MemoryAccounting_GetBalance(MemoryAccount* memoryAccount);
 
@@ -188,6 +191,10 @@ uint64 MemoryAccountingOutstandingBalance = 0;
  */
 uint64 MemoryAccountingPeakBalance = 0;
 
+/* Live per-backend balances in shared memory, and this backend's slot */
+MemoryAccountingBackendStats *MemoryAccountingAllBackendStats = NULL;
+MemoryAccountingBackendStats *MyMemoryAccountingStats = NULL;
+
 /******************************************/
 /********** Public interface **************/
 
@@ -221,6 +228,8 @@ MemoryAccounting_Reset()
 	}
 
 	InitMemoryAccounting();
+
+	PublishBackendStats();
 }
 
 /*
@@ -492,10 +501,114 @@ MemoryAccounting_SaveToLog()
 	return totalWalked;
 }
 
+/*
+ * MemoryAccounting_ShmemSize
+ *		Returns the size of the shared memory array of per-backend balances
+ */
+Size
+MemoryAccounting_ShmemSize()
+{
+	return mul_size(MaxBackends, sizeof(MemoryAccountingBackendStats));
+}
+
+/*
+ * MemoryAccounting_ShmemInit
+ *		Allocates the shared memory array of per-backend balances
+ */
+void
+MemoryAccounting_ShmemInit()
+{
+	bool found = false;
+	Size size = MemoryAccounting_ShmemSize();
+
+	MemoryAccountingAllBackendStats = (MemoryAccountingBackendStats *)
+			ShmemInitStruct(SHMEM_MEMORY_ACCOUNTING_BACKEND_STATS, size, &found);
+
+	if (!found)
+		MemSet(MemoryAccountingAllBackendStats, 0, size);
+}
+
+/*
+ * MemoryAccounting_BackendStatsInit
+ *		Claims this backend's slot of the shared balances, and starts
+ *		publishing to it. Must be called after MyBackendId is assigned.
+ */
+void
+MemoryAccounting_BackendStatsInit()
+{
+	if (NULL == MemoryAccountingAllBackendStats ||
+		MyBackendId == InvalidBackendId || MyBackendId > MaxBackends)
+	{
+		return;
+	}
+
+	MyMemoryAccountingStats = &MemoryAccountingAllBackendStats[MyBackendId - 1];
+	MyMemoryAccountingStats->pid = MyProcPid;
+
+	PublishBackendStats();
+}
+
+/*
+ * MemoryAccounting_BackendStatsShutdown
+ *		Stops publishing and releases this backend's slot
+ */
+void
+MemoryAccounting_BackendStatsShutdown()
+{
+	if (NULL == MyMemoryAccountingStats)
+		return;
+
+	MyMemoryAccountingStats->pid = 0;
+	MyMemoryAccountingStats = NULL;
+}
+
 /*****************************************************************************
  *	  PRIVATE ROUTINES FOR MEMORY ACCOUNTING								 *
  *****************************************************************************/
 
+/*
+ * PublishBackendStats
+ *		Recomputes this backend's shared balances from its live accounts.
+ *
+ * After this, MemoryAccounting_Allocate and MemoryAccounting_Free keep them
+ * up to date. This is only needed when accounts are created or rolled over
+ * wholesale, i.e., at reset.
+ */
+static void
+PublishBackendStats()
+{
+	MemoryAccountingBackendStats *stats = MyMemoryAccountingStats;
+
+	if (NULL == stats || !MemoryAccounting_IsInitialized())
+		return;
+
+	MemSet(stats->balance, 0, sizeof(stats->balance));
+
+	for (int longLivingIdx = MEMORY_OWNER_TYPE_LogicalRoot;
+			longLivingIdx <= MEMORY_OWNER_TYPE_END_LONG_LIVING;
+			longLivingIdx++)
+	{
+		MemoryAccount *account = longLivingMemoryAccountArray[longLivingIdx];
+
+		stats->balance[account->ownerType] += MemoryAccounting_GetBalance(account);
+	}
+
+	if (NULL != shortLivingMemoryAccountArray)
+	{
+		for (MemoryAccountIdType idx = 0; idx < shortLivingMemoryAccountArray->accountCount; idx++)
+		{
+			MemoryAccount *account = shortLivingMemoryAccountArray->allAccounts[idx];
+
+			stats->balance[account->ownerType] += MemoryAccounting_GetBalance(account);
+		}
+	}
+
+	/* Peaks start over at each reset, like MemoryAccountingPeakBalance */
+	memcpy(stats->peak, stats->balance, sizeof(stats->peak));
+
+	stats->sessionId = gp_session_id;
+}
+
 /* Initializes all the long living accounts */
 static void
 InitLongLivingAccounts() {
@@ -928,7 +1041,7 @@ MemoryAccountToString(MemoryAccountTree *memoryAccountTreeNode, void *context, u
  * MemoryAccounting_GetOwnerName
  *		Returns the human readable name of an owner
  */
-static const char*
+const char*
 MemoryAccounting_GetOwnerName(MemoryOwnerType ownerType)
 {
 	switch (ownerType)
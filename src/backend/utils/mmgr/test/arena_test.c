@@ -0,0 +1,247 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include "cmockery.h"
+
+#include "../arena.c"
+
+#define ARENA_BLOCK_SIZE 8192
+#define NEW_ALLOC_SIZE 64
+
+extern MemoryAccount* MemoryAccountMemoryAccount;
+extern MemoryAccount* RolloverMemoryAccount;
+extern MemoryAccount* AlienExecutorMemoryAccount;
+
+extern MemoryAccountIdType liveAccountStartId;
+extern MemoryAccountIdType nextAccountId;
+
+#define PG_RE_THROW() siglongjmp(*PG_exception_stack, 1)
+
+/*
+ * This method will emulate the real ExceptionalCondition
+ * function by re-throwing the exception, essentially falling
+ * back to the next available PG_CATCH();
+ */
+void
+_ExceptionalCondition()
+{
+     PG_RE_THROW();
+}
+
+/*
+ * This method sets up MemoryContext tree as well as
+ * the basic MemoryAccount data structures.
+ */
+void SetupMemoryDataStructures(void **state)
+{
+	MemoryContextInit();
+}
+
+/*
+ * This method cleans up MemoryContext tree and
+ * the MemoryAccount data structures.
+ */
+void
+TeardownMemoryDataStructures(void **state)
+{
+	MemoryAccounting_Reset();
+	MemoryAccounting_SwitchAccount(MEMORY_OWNER_TYPE_Rollover);
+
+	MemoryContextReset(TopMemoryContext); /* TopMemoryContext deletion is not supported */
+
+	/* These are needed to be NULL for calling MemoryContextInit() */
+	TopMemoryContext = NULL;
+	CurrentMemoryContext = NULL;
+
+	/*
+	 * Memory accounts related variables need to be NULL before we
+	 * try to setup memory account data structure again during the
+	 * execution of the next test.
+	 */
+	MemoryAccountMemoryAccount = NULL;
+	RolloverMemoryAccount = NULL;
+	SharedChunkHeadersMemoryAccount = NULL;
+	AlienExecutorMemoryAccount = NULL;
+	MemoryAccountMemoryContext = NULL;
+
+	ActiveMemoryAccountId = MEMORY_OWNER_TYPE_Undefined;
+
+	for (int longLivingIdx = MEMORY_OWNER_TYPE_LogicalRoot; longLivingIdx <= MEMORY_OWNER_TYPE_END_LONG_LIVING; longLivingIdx++)
+	{
+		longLivingMemoryAccountArray[longLivingIdx] = NULL;
+	}
+
+	shortLivingMemoryAccountArray = NULL;
+
+	liveAccountStartId = MEMORY_OWNER_TYPE_START_SHORT_LIVING;
+	nextAccountId = MEMORY_OWNER_TYPE_START_SHORT_LIVING;
+}
+
+/*
+ * Tests that a reset frees all the blocks but the keeper, and that the
+ * allocations after the reset are carved from the keeper again, without
+ * obtaining a new block
+ */
+void
+test__ArenaReset__ReusesKeeperBlock(void **state)
+{
+	MemoryContext context = ArenaContextCreate(TopMemoryContext, "test arena", ARENA_BLOCK_SIZE);
+	Arena arena = (Arena) context;
+
+	/* Fill a few blocks */
+	for (int i = 0; i < 3 * ARENA_BLOCK_SIZE / NEW_ALLOC_SIZE; i++)
+		MemoryContextAlloc(context, NEW_ALLOC_SIZE);
+
+	ArenaBlock keeper = arena->keeper;
+
+	assert_true(keeper != NULL && arena->blocks != keeper);
+
+	uint64 prevFreed = arena->header.allBytesFreed;
+
+	MemoryContextReset(context);
+
+	/* Only the keeper is left, and nothing is active */
+	assert_true(arena->blocks == keeper && keeper->next == NULL && keeper->prev == NULL);
+	assert_true(arena->freeptr == NULL && arena->endptr == NULL);
+	assert_true(arena->header.allBytesFreed > prevFreed);
+	assert_true(MemoryContextIsEmpty(context));
+
+	uint64 prevAllocated = arena->header.allBytesAlloc;
+
+	void *testAlloc = MemoryContextAlloc(context, NEW_ALLOC_SIZE);
+
+	/* The first chunk after the reset starts the keeper block again */
+	assert_true(ArenaPointerGetChunk(testAlloc) == (ArenaChunk) (((char *) keeper) + ARENA_BLOCKHDRSZ));
+	assert_true(arena->blocks == keeper);
+	assert_true(arena->header.allBytesAlloc == prevAllocated);
+
+	MemoryContextDelete(context);
+}
+
+/*
+ * Tests that pfree of an ordinary chunk does nothing, while pfree of a chunk
+ * above the chunk limit gives its dedicated block back
+ */
+void
+test__ArenaFree__LargeChunkReleasesBlock(void **state)
+{
+	MemoryContext context = ArenaContextCreate(TopMemoryContext, "test arena", ARENA_BLOCK_SIZE);
+	Arena arena = (Arena) context;
+
+	void *smallAlloc = MemoryContextAlloc(context, NEW_ALLOC_SIZE);
+	char *prevFreeptr = arena->freeptr;
+
+	pfree(smallAlloc);
+
+	/* Ordinary chunks stay until the reset */
+	assert_true(arena->freeptr == prevFreeptr);
+
+	void *largeAlloc = MemoryContextAlloc(context, arena->chunkLimit + 1);
+	ArenaBlock block = ArenaChunkGetBlock(ArenaPointerGetChunk(largeAlloc));
+
+	/*
+	 * The dedicated block goes underneath the active block, which stays
+	 * available for more chunks, and is entirely used by the chunk.
+	 */
+	assert_true(arena->blocks->next == block && block->prev == arena->blocks);
+	assert_true(block->freeptr == UserPtr_GetEndPtr(block));
+	assert_true(arena->freeptr == prevFreeptr);
+
+	uint64 prevFreed = arena->header.allBytesFreed;
+	size_t blockSize = UserPtr_GetUserPtrSize(block);
+
+	pfree(largeAlloc);
+
+	assert_true(arena->blocks->next == NULL);
+	assert_true(arena->header.allBytesFreed == prevFreed + blockSize);
+
+	MemoryContextDelete(context);
+}
+
+/*
+ * Tests that repalloc grows the last chunk of the active block in place,
+ * and copies any other chunk
+ */
+void
+test__ArenaRealloc__GrowsLastChunkInPlace(void **state)
+{
+	MemoryContext context = ArenaContextCreate(TopMemoryContext, "test arena", ARENA_BLOCK_SIZE);
+	Arena arena = (Arena) context;
+
+	char *testAlloc = MemoryContextAlloc(context, NEW_ALLOC_SIZE);
+
+	memset(testAlloc, 'a', NEW_ALLOC_SIZE);
+
+	char *newAlloc = repalloc(testAlloc, NEW_ALLOC_SIZE * 2);
+
+	assert_true(newAlloc == testAlloc);
+	assert_true(ArenaPointerGetChunk(newAlloc)->size == MAXALIGN(NEW_ALLOC_SIZE * 2));
+	assert_true(arena->freeptr == newAlloc + MAXALIGN(NEW_ALLOC_SIZE * 2));
+
+	/* Once another chunk follows it, the chunk has to move */
+	MemoryContextAlloc(context, NEW_ALLOC_SIZE);
+
+	newAlloc = repalloc(testAlloc, NEW_ALLOC_SIZE * 4);
+
+	assert_true(newAlloc != testAlloc);
+	for (int i = 0; i < NEW_ALLOC_SIZE; i++)
+		assert_true(newAlloc[i] == 'a');
+
+	MemoryContextDelete(context);
+}
+
+/*
+ * Tests that blocks are charged to the active memory account, that a reset
+ * releases the accounting of the kept block as well, and that the keeper is
+ * charged again when it is put back to use
+ */
+void
+test__ArenaReset__ReleasesAccounting(void **state)
+{
+	MemoryAccountIdType newActiveAccountId = MemoryAccounting_CreateAccount(0, MEMORY_OWNER_TYPE_Exec_Hash);
+
+	/* Make sure we have a new active account other than Rollover */
+	MemoryAccountIdType oldActiveAccount = MemoryAccounting_SwitchAccount(newActiveAccountId);
+
+	MemoryContext context = ArenaContextCreate(TopMemoryContext, "test arena", ARENA_BLOCK_SIZE);
+	Arena arena = (Arena) context;
+
+	uint64 prevBalance = MemoryAccounting_GetAccountCurrentBalance(newActiveAccountId);
+
+	MemoryContextAlloc(context, NEW_ALLOC_SIZE);
+
+	uint64 keeperSize = UserPtr_GetUserPtrSize(arena->keeper);
+
+	/* The whole block is charged, once */
+	assert_true(keeperSize >= ARENA_BLOCK_SIZE);
+	assert_true(MemoryAccounting_GetAccountCurrentBalance(newActiveAccountId) == prevBalance + keeperSize);
+
+	MemoryContextAlloc(context, NEW_ALLOC_SIZE);
+	assert_true(MemoryAccounting_GetAccountCurrentBalance(newActiveAccountId) == prevBalance + keeperSize);
+
+	MemoryContextReset(context);
+	assert_true(MemoryAccounting_GetAccountCurrentBalance(newActiveAccountId) == prevBalance);
+
+	MemoryContextAlloc(context, NEW_ALLOC_SIZE);
+	assert_true(MemoryAccounting_GetAccountCurrentBalance(newActiveAccountId) == prevBalance + keeperSize);
+
+	MemoryContextDelete(context);
+	assert_true(MemoryAccounting_GetAccountCurrentBalance(newActiveAccountId) <= prevBalance);
+
+	MemoryAccounting_SwitchAccount(oldActiveAccount);
+}
+
+int
+main(int argc, char* argv[])
+{
+	cmockery_parse_arguments(argc, argv);
+
+	const UnitTest tests[] = {
+		unit_test_setup_teardown(test__ArenaReset__ReusesKeeperBlock, SetupMemoryDataStructures, TeardownMemoryDataStructures),
+		unit_test_setup_teardown(test__ArenaFree__LargeChunkReleasesBlock, SetupMemoryDataStructures, TeardownMemoryDataStructures),
+		unit_test_setup_teardown(test__ArenaRealloc__GrowsLastChunkInPlace, SetupMemoryDataStructures, TeardownMemoryDataStructures),
+		unit_test_setup_teardown(test__ArenaReset__ReleasesAccounting, SetupMemoryDataStructures, TeardownMemoryDataStructures),
+	};
+
+	return run_tests(tests);
+}
@@ -107,6 +107,12 @@ void VmemTrackerTestSetup(void **state)
 	Gp_role = GP_ROLE_EXECUTE;
 	CritSectionCount = 0;
 	IsUnderPostmaster = true;
+
+	/*
+	 * Track the exact number of chunks, unless a test is checking the
+	 * reservation cache
+	 */
+	vmemReservationCacheChunks = 0;
 }
 
 /*
@@ -230,6 +236,142 @@ test__VmemTracker_ReserveVmem__CacheSanity(void **state)
 	assert_true(5 == trackedVmemChunks);
 }
 
+/*
+ * Checks that we reserve ahead and keep surplus chunks in the reservation
+ * cache, but not when the segment is about to run out of vmem.
+ */
+void
+test__VmemTracker_ReserveVmem__ReservationCache(void **state)
+{
+	/* GPDB Memory protection is enabled and initialized */
+	gp_mp_inited = true;
+	vmemReservationCacheChunks = 1;
+
+	int64 oneChunkBytes = 1 << chunkSizeInBits;
+
+	assert_true(0 == trackedVmemChunks);
+
+#ifdef USE_ASSERT_CHECKING
+	will_return_count(MemoryProtection_IsOwnerThread, true, 5);
+#endif
+
+	will_return_count(RedZoneHandler_IsVmemRedZone, false, 5);
+
+	will_be_called(RedZoneHandler_DetectRunawaySession);
+	/* We need one chunk, and reserve one more ahead */
+	VmemTracker_ReserveVmem(oneChunkBytes + 1);
+	assert_true(2 == trackedVmemChunks);
+	assert_true(2 == *segmentVmemChunks);
+	assert_true(2 == MySessionState->sessionVmem);
+
+	/* Satisfied from the read ahead chunk */
+	VmemTracker_ReserveVmem(oneChunkBytes);
+	assert_true(2 == trackedVmemChunks);
+
+	/* The freed chunk is kept in the cache */
+	VmemTracker_ReleaseVmem(oneChunkBytes);
+	assert_true(2 == trackedVmemChunks);
+
+	/* We keep only one surplus chunk */
+	VmemTracker_ReleaseVmem(oneChunkBytes + 1);
+	assert_true(0 == trackedBytes);
+	assert_true(1 == trackedVmemChunks);
+	assert_true(1 == *segmentVmemChunks);
+
+	/* Going idle returns the cache */
+	VmemTracker_ReleaseReservationCache();
+	assert_true(0 == trackedVmemChunks);
+	assert_true(0 == *segmentVmemChunks);
+	assert_true(0 == MySessionState->sessionVmem);
+
+	/* Other processes have consumed all but one chunk of the segment */
+	*segmentVmemChunks = vmemChunksQuota - 1;
+
+	will_be_called(RedZoneHandler_DetectRunawaySession);
+	/* No headroom to read ahead */
+	VmemTracker_ReserveVmem(oneChunkBytes);
+	assert_true(1 == trackedVmemChunks);
+	assert_true(vmemChunksQuota == *segmentVmemChunks);
+
+	/* No headroom to keep the surplus chunk either */
+	VmemTracker_ReleaseVmem(oneChunkBytes);
+	assert_true(0 == trackedVmemChunks);
+	assert_true(vmemChunksQuota - 1 == *segmentVmemChunks);
+
+	*segmentVmemChunks = 0;
+}
+
+/*
+ * Checks that we neither reserve ahead nor keep surplus chunks when the
+ * session is about to hit its limit or the segment is in the red zone, and
+ * that we give back the cache when a reservation fails.
+ */
+void
+test__VmemTracker_ReserveVmem__ReservationCacheNearLimits(void **state)
+{
+	/* GPDB Memory protection is enabled and initialized */
+	gp_mp_inited = true;
+	vmemReservationCacheChunks = 1;
+
+	int64 oneChunkBytes = 1 << chunkSizeInBits;
+
+	assert_true(0 == trackedVmemChunks);
+
+#ifdef USE_ASSERT_CHECKING
+	will_return_count(MemoryProtection_IsOwnerThread, true, 7);
+#endif
+
+	/* The session may only use two chunks */
+	maxChunksPerQuery = 2;
+
+	will_return_count(RedZoneHandler_IsVmemRedZone, false, 2);
+
+	will_be_called(RedZoneHandler_DetectRunawaySession);
+	/* No headroom in the session to read ahead */
+	VmemTracker_ReserveVmem(2 * oneChunkBytes);
+	assert_true(2 == trackedVmemChunks);
+	assert_true(2 == MySessionState->sessionVmem);
+
+	/* No headroom in the session to keep the surplus chunk either */
+	VmemTracker_ReleaseVmem(2 * oneChunkBytes);
+	assert_true(0 == trackedVmemChunks);
+	assert_true(0 == MySessionState->sessionVmem);
+
+	maxChunksPerQuery = 0;
+
+	/* The segment is in the red zone */
+	will_return_count(RedZoneHandler_IsVmemRedZone, true, 2);
+
+	will_be_called(RedZoneHandler_DetectRunawaySession);
+	VmemTracker_ReserveVmem(oneChunkBytes);
+	assert_true(1 == trackedVmemChunks);
+	assert_true(1 == *segmentVmemChunks);
+
+	VmemTracker_ReleaseVmem(oneChunkBytes);
+	assert_true(0 == trackedVmemChunks);
+	assert_true(0 == *segmentVmemChunks);
+
+	will_return_count(RedZoneHandler_IsVmemRedZone, false, 2);
+
+	will_be_called(RedZoneHandler_DetectRunawaySession);
+	/* We need one chunk, and reserve one more ahead */
+	VmemTracker_ReserveVmem(oneChunkBytes);
+	assert_true(2 == trackedVmemChunks);
+
+	/* Other processes have consumed the rest of the segment */
+	*segmentVmemChunks = vmemChunksQuota;
+
+	will_be_called(RedZoneHandler_DetectRunawaySession);
+	/* The reservation fails, and the read ahead chunk is given back */
+	assert_true(MemoryFailure_VmemExhausted == VmemTracker_ReserveVmem(2 * oneChunkBytes));
+	assert_true(oneChunkBytes == trackedBytes);
+	assert_true(1 == trackedVmemChunks);
+	assert_true(vmemChunksQuota - 1 == *segmentVmemChunks);
+	assert_true(1 == MySessionState->sessionVmem);
+
+	*segmentVmemChunks = trackedVmemChunks;
+}
+
 /*
  * Checks the sanity of the tracked bytes.
  *
@@ -675,6 +817,8 @@ main(int argc, char* argv[])
 		unit_test_setup_teardown(test__VmemTracker_ReserveVmem__IgnoreWhenUninitialized, VmemTrackerTestSetup, VmemTrackerTestTeardown),
 		unit_test_setup_teardown(test__VmemTracker_ReserveVmem__FailForInvalidSize, VmemTrackerTestSetup, VmemTrackerTestTeardown),
 		unit_test_setup_teardown(test__VmemTracker_ReserveVmem__CacheSanity, VmemTrackerTestSetup, VmemTrackerTestTeardown),
+		unit_test_setup_teardown(test__VmemTracker_ReserveVmem__ReservationCache, VmemTrackerTestSetup, VmemTrackerTestTeardown),
+		unit_test_setup_teardown(test__VmemTracker_ReserveVmem__ReservationCacheNearLimits, VmemTrackerTestSetup, VmemTrackerTestTeardown),
 		unit_test_setup_teardown(test__VmemTracker_ReserveVmem__TrackedBytesSanity, VmemTrackerTestSetup, VmemTrackerTestTeardown),
 		unit_test_setup_teardown(test__VmemTracker_ReserveVmem__TrackedBytesSanityForRedzoneDetection, VmemTrackerTestSetup, VmemTrackerTestTeardown),
 		unit_test_setup_teardown(test__VmemTracker_ReserveVmem__OOMLoggingBeforeReservation, VmemTrackerTestSetup, VmemTrackerTestTeardown),
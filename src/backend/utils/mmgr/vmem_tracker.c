@@ -38,6 +38,12 @@ extern void IdleTracker_Shutdown(void);
 #define BYTES_TO_CHUNKS(bytes) ((bytes) >> chunkSizeInBits)
 #define BYTES_TO_MB(bytes) ((bytes) >> BITS_IN_MB)
 
+/*
+ * Default number of surplus chunks a process may hold beyond what its
+ * trackedBytes require. See vmemReservationCacheChunks.
+ */
+#define VMEM_RESERVATION_CACHE_CHUNKS 1
+
 /* Number of Vmem chunks tracked by this process */
 static int32 trackedVmemChunks = 0;
 /* Maximum number of vmem chunks tracked by this process */
@@ -67,6 +73,19 @@ static int32 maxChunksPerQuery = 0;
  */
 static int32 waivedChunks = 0;
 
+/*
+ * Number of chunks that a process may keep reserved on top of what its
+ * trackedBytes require. When we have to go to the shared counters to reserve
+ * more chunks, we reserve up to this many extra chunks ahead, as long as the
+ * session and segment have the headroom; and when we free, we keep up to this
+ * many surplus chunks instead of returning them right away. This saves the
+ * atomic updates of the session and segment counters for a process whose
+ * usage oscillates around a chunk boundary, at the cost of over-reporting
+ * each process's reservation by at most this many chunks. The cache is given
+ * back when the process goes idle (see VmemTracker_ReleaseReservationCache).
+ */
+static int32 vmemReservationCacheChunks = VMEM_RESERVATION_CACHE_CHUNKS;
+
 /*
  * Consumed vmem on the segment.
  */
@@ -280,6 +299,60 @@ VmemTracker_ReleaseVmemChunks(int reduction)
 	trackedVmemChunks -= reduction;
 }
 
+/*
+ * Returns true if this process may hold "cacheChunks" more chunks than the
+ * session and segment counters show right now, i.e., if doing so doesn't eat
+ * into the session or segment quota that someone else may need. The check is
+ * done against an unlocked snapshot of the shared counters.
+ */
+static bool
+VmemTracker_HasRoomForCache(int32 cacheChunks)
+{
+	/* The segment needs every chunk it can get back to leave the red zone */
+	if (RedZoneHandler_IsVmemRedZone())
+	{
+		return false;
+	}
+
+	if (*segmentVmemChunks + cacheChunks > vmemChunksQuota)
+	{
+		return false;
+	}
+
+	if (maxChunksPerQuery != 0 &&
+			MySessionState->sessionVmem + cacheChunks > maxChunksPerQuery)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+/*
+ * Returns how many chunks to reserve ahead of a reservation of "needChunks",
+ * i.e., how many of the reservation cache chunks we can fill. If we lose a
+ * race for the headroom, VmemTracker_ReserveVmemChunks fails and the caller
+ * retries without the extra chunks.
+ */
+static int32
+VmemTracker_GetReadAheadChunks(int32 needChunks)
+{
+	int32 aheadChunks = vmemReservationCacheChunks;
+
+	/* Don't prefetch while a waiver is in place; we are handling an OOM */
+	if (aheadChunks <= 0 || waivedChunks > 0)
+	{
+		return 0;
+	}
+
+	if (!VmemTracker_HasRoomForCache(needChunks + aheadChunks))
+	{
+		return 0;
+	}
+
+	return aheadChunks;
+}
+
 /*
  * Releases all vmem reserved by this process.
  */
@@ -531,13 +604,29 @@ VmemTracker_ReserveVmem(int64 newlyRequestedBytes)
 		ReportOOMConsumption();
 
 		int32 needChunk = newszChunk - trackedVmemChunks;
-		status = VmemTracker_ReserveVmemChunks(needChunk);
+		int32 aheadChunk = VmemTracker_GetReadAheadChunks(needChunk);
+
+		status = VmemTracker_ReserveVmemChunks(needChunk + aheadChunk);
+
+		/*
+		 * If the read ahead lost a race with another process, settle for
+		 * exactly what we need, so that the limits are enforced as if we
+		 * never tried to read ahead.
+		 */
+		if (MemoryAllocation_Success != status && aheadChunk > 0)
+		{
+			status = VmemTracker_ReserveVmemChunks(needChunk);
+		}
 	}
 
-	/* Failed to reserve vmem chunks. Revert changes to trackedBytes */
+	/*
+	 * Failed to reserve vmem chunks. Revert changes to trackedBytes, and give
+	 * back any surplus chunks we hold, as we are out of vmem.
+	 */
 	if (MemoryAllocation_Success != status)
 	{
 		trackedBytes -= newlyRequestedBytes;
+		VmemTracker_ReleaseReservationCache();
 	}
 
 	return status;
@@ -547,7 +636,8 @@ VmemTracker_ReserveVmem(int64 newlyRequestedBytes)
  * Releases toBeFreedRequested bytes from the vmem system.
  *
  * For performance reason this method accumulates free requests until it has
- * enough bytes to free a whole chunk.
+ * enough bytes to free a whole chunk, and keeps up to vmemReservationCacheChunks
+ * surplus chunks reserved for the next VmemTracker_ReserveVmem.
  */
 void
 VmemTracker_ReleaseVmem(int64 toBeFreedRequested)
@@ -568,7 +658,7 @@ VmemTracker_ReleaseVmem(int64 toBeFreedRequested)
 	int64 toBeFreed = Min(trackedBytes, toBeFreedRequested);
 	if (0 == toBeFreed)
 	{
-		Assert(0 == trackedVmemChunks);
+		Assert(trackedVmemChunks <= Max(vmemReservationCacheChunks, 0));
 		return;
 	}
 
@@ -576,6 +666,16 @@ VmemTracker_ReleaseVmem(int64 toBeFreedRequested)
 
 	int newszChunk = trackedBytes >> chunkSizeInBits;
 
+	/*
+	 * Keep the surplus chunks for the next reservation, unless the session or
+	 * the segment is so close to its quota that someone else may need them.
+	 */
+	if (vmemReservationCacheChunks > 0 &&
+			VmemTracker_HasRoomForCache(vmemReservationCacheChunks))
+	{
+		newszChunk += vmemReservationCacheChunks;
+	}
+
 	if (newszChunk < trackedVmemChunks)
 	{
 		int reduction = trackedVmemChunks - newszChunk;
@@ -584,6 +684,28 @@ VmemTracker_ReleaseVmem(int64 toBeFreedRequested)
 	}
 }
 
+/*
+ * Returns the surplus chunks held in the reservation cache of this process
+ * to the session and segment. Called when the process goes idle, so that an
+ * idle session doesn't hold on to vmem it isn't using.
+ */
+void
+VmemTracker_ReleaseReservationCache()
+{
+	if (!vmemTrackerInited)
+	{
+		Assert(0 == trackedVmemChunks);
+		return;
+	}
+
+	int newszChunk = trackedBytes >> chunkSizeInBits;
+
+	if (newszChunk < trackedVmemChunks)
+	{
+		VmemTracker_ReleaseVmemChunks(trackedVmemChunks - newszChunk);
+	}
+}
+
 /*
  * Request additional VMEM bytes beyond per-session or system vmem limit for
  * OOM error handling.
@@ -106,6 +106,13 @@ bool						gp_log_resqueue_memory = false;
 int							gp_resqueue_memory_policy_auto_fixed_mem;
 const int					gp_resqueue_memory_log_level=NOTICE;
 bool						gp_resqueue_print_operator_memory_limits = false;
+bool						gp_resqueue_memory_broker = false;
+
+/**
+ * Operator memory quota that has been released at runtime by operators of
+ * the current statement and not yet handed out again. See MemoryBroker_Release.
+ */
+static uint64 MemoryBrokerPoolBytes = 0;
 
 /**
  * Minimum of two doubles 
@@ -1205,3 +1212,85 @@ uint64 ResourceQueueGetSuperuserQueryMemoryLimit(void)
 }
 
 
+
+/**
+ * Runtime memory broker.
+ *
+ * Operator quotas are fixed at plan time, so an operator that turns out to
+ * need less than its quota cannot help a sibling that is about to spill.
+ * The broker keeps a per-process pool of quota that operators of the running
+ * statement have given back. An operator that is about to spill may borrow
+ * from that pool instead. Since the pool only ever holds released quota, the
+ * operators together never exceed what the statement was assigned.
+ */
+
+/**
+ * Empty the pool. Called before each command is processed.
+ */
+void MemoryBroker_Reset(void)
+{
+	MemoryBrokerPoolBytes = 0;
+}
+
+/**
+ * Give quota that an operator does not need back to the pool.
+ */
+void MemoryBroker_Release(uint64 bytes)
+{
+	if (!gp_resqueue_memory_broker)
+		return;
+
+	MemoryBrokerPoolBytes += bytes;
+
+	if (gp_log_resqueue_memory)
+	{
+		elog(gp_resqueue_memory_log_level, "memory broker: released " UINT64_FORMAT " bytes, pool " UINT64_FORMAT " bytes",
+			 bytes, MemoryBrokerPoolBytes);
+	}
+}
+
+/**
+ * Borrow quota from the pool. Grants nothing if fewer than minBytes are
+ * available, otherwise up to wantBytes. Returns the number of bytes granted,
+ * which the caller must hand back with MemoryBroker_Release once it no longer
+ * needs them.
+ */
+uint64 MemoryBroker_Request(uint64 minBytes, uint64 wantBytes)
+{
+	uint64 granted;
+
+	Assert(minBytes <= wantBytes);
+
+	if (!gp_resqueue_memory_broker || MemoryBrokerPoolBytes < minBytes)
+		return 0;
+
+	granted = Min(wantBytes, MemoryBrokerPoolBytes);
+	MemoryBrokerPoolBytes -= granted;
+
+	if (gp_log_resqueue_memory)
+	{
+		elog(gp_resqueue_memory_log_level, "memory broker: granted " UINT64_FORMAT " bytes, pool " UINT64_FORMAT " bytes",
+			 granted, MemoryBrokerPoolBytes);
+	}
+
+	return granted;
+}
+
+/**
+ * Take back quota an operator released earlier, as far as it has not been
+ * borrowed in the meantime. Used when the releasing operator shuts down or
+ * rebuilds its state. Returns the number of bytes taken back; the operator
+ * must not count on the rest until a later reclaim gets it.
+ */
+uint64 MemoryBroker_Reclaim(uint64 bytes)
+{
+	uint64 reclaimed;
+
+	if (!gp_resqueue_memory_broker)
+		return bytes;
+
+	reclaimed = Min(bytes, MemoryBrokerPoolBytes);
+	MemoryBrokerPoolBytes -= reclaimed;
+
+	return reclaimed;
+}
@@ -81,6 +81,83 @@ test__ComputeMemLimitForChildGroups_rounding(void **state)
 
 }
 
+/* ==================== MemoryBroker ==================== */
+
+/*
+ * Tests that the broker does nothing when gp_resqueue_memory_broker is off
+ */
+void
+test__MemoryBroker_disabled(void **state)
+{
+	gp_resqueue_memory_broker = false;
+	MemoryBroker_Reset();
+
+	MemoryBroker_Release(1000);
+	assert_int_equal(MemoryBrokerPoolBytes, 0);
+
+	assert_int_equal(MemoryBroker_Request(100, 1000), 0);
+
+	/* Nothing was lent, so everything counts as reclaimed */
+	assert_int_equal(MemoryBroker_Reclaim(1000), 1000);
+}
+
+/*
+ * Tests that requests are granted from the pool, between minBytes and
+ * wantBytes, and never more than the pool holds
+ */
+void
+test__MemoryBroker_Request(void **state)
+{
+	gp_resqueue_memory_broker = true;
+	MemoryBroker_Reset();
+
+	MemoryBroker_Release(1000);
+	assert_int_equal(MemoryBrokerPoolBytes, 1000);
+
+	/* Not enough in the pool */
+	assert_int_equal(MemoryBroker_Request(2000, 3000), 0);
+	assert_int_equal(MemoryBrokerPoolBytes, 1000);
+
+	assert_int_equal(MemoryBroker_Request(100, 600), 600);
+	assert_int_equal(MemoryBrokerPoolBytes, 400);
+
+	/* Only what is left */
+	assert_int_equal(MemoryBroker_Request(100, 1000), 400);
+	assert_int_equal(MemoryBrokerPoolBytes, 0);
+
+	MemoryBroker_Release(1000);
+	MemoryBroker_Reset();
+	assert_int_equal(MemoryBrokerPoolBytes, 0);
+
+	gp_resqueue_memory_broker = false;
+}
+
+/*
+ * Tests that a lender only reclaims the quota that is back in the pool,
+ * and gets the rest once the borrower has returned it
+ */
+void
+test__MemoryBroker_Reclaim(void **state)
+{
+	uint64 granted;
+
+	gp_resqueue_memory_broker = true;
+	MemoryBroker_Reset();
+
+	MemoryBroker_Release(1000);
+	granted = MemoryBroker_Request(100, 600);
+	assert_int_equal(granted, 600);
+
+	assert_int_equal(MemoryBroker_Reclaim(1000), 400);
+	assert_int_equal(MemoryBrokerPoolBytes, 0);
+
+	MemoryBroker_Release(granted);
+	assert_int_equal(MemoryBroker_Reclaim(600), 600);
+	assert_int_equal(MemoryBrokerPoolBytes, 0);
+
+	gp_resqueue_memory_broker = false;
+}
+
 /* ==================== main ==================== */
 int
 main(int argc, char* argv[])
@@ -88,7 +165,10 @@ main(int argc, char* argv[])
 	cmockery_parse_arguments(argc, argv);
 
 	const UnitTest tests[] = {
-		unit_test(test__ComputeMemLimitForChildGroups_rounding)
+		unit_test(test__ComputeMemLimitForChildGroups_rounding),
+		unit_test(test__MemoryBroker_disabled),
+		unit_test(test__MemoryBroker_Request),
+		unit_test(test__MemoryBroker_Reclaim)
 	};
 
 	MemoryContextInit();
@@ -16,6 +16,7 @@
 #include "funcapi.h"
 #include "cdb/cdbvars.h"
 #include "utils/builtins.h"
+#include "utils/memaccounting.h"
 #include "utils/session_state.h"
 #include "utils/vmem_tracker.h"
 #include "miscadmin.h"
@@ -23,10 +24,22 @@
 /* The number of columns as defined in gp_session_state_memory_stats view */
 #define NUM_SESSION_STATE_MEMORY_ELEM 9
 
+/* The number of columns as defined in memory_account_live view */
+#define NUM_MEMORY_ACCOUNT_LIVE_ELEM 6
+
 Datum gp_session_state_memory_entries(PG_FUNCTION_ARGS);
+Datum gp_memory_account_live_entries(PG_FUNCTION_ARGS);
 
 PG_MODULE_MAGIC;
 PG_FUNCTION_INFO_V1(gp_session_state_memory_entries);
+PG_FUNCTION_INFO_V1(gp_memory_account_live_entries);
+
+/* Position of gp_memory_account_live_entries in the shared balances */
+typedef struct MemoryAccountLiveCursor
+{
+	int backendIndex;
+	int ownerType;
+} MemoryAccountLiveCursor;
 
 /*
  * Function returning memory entries for each session
@@ -124,3 +137,105 @@ gp_session_state_memory_entries(PG_FUNCTION_ARGS)
 		}
 	}
 }
+
+/*
+ * Function returning the live memory balance of each owner type of each
+ * backend on this segment
+ */
+Datum
+gp_memory_account_live_entries(PG_FUNCTION_ARGS)
+{
+	FuncCallContext *funcctx;
+	MemoryAccountLiveCursor *cursor;
+
+	if (SRF_IS_FIRSTCALL())
+	{
+		/* create a function context for cross-call persistence */
+		funcctx = SRF_FIRSTCALL_INIT();
+
+		/* Switch to memory context appropriate for multiple function calls */
+		MemoryContext oldcontext = MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+
+		/* Build a tuple descriptor for our result type. */
+		TupleDesc tupdesc = CreateTemplateTupleDesc(NUM_MEMORY_ACCOUNT_LIVE_ELEM, false /* hasoid */);
+
+		TupleDescInitEntry(tupdesc, (AttrNumber) 1, "segid",
+				INT4OID, -1 /* typmod */, 0 /* attdim */);
+
+		TupleDescInitEntry(tupdesc, (AttrNumber) 2, "pid",
+				INT4OID, -1 /* typmod */, 0 /* attdim */);
+
+		TupleDescInitEntry(tupdesc, (AttrNumber) 3, "sessionid",
+				INT4OID, -1 /* typmod */, 0 /* attdim */);
+
+		TupleDescInitEntry(tupdesc, (AttrNumber) 4, "owner_type",
+				TEXTOID, -1 /* typmod */, 0 /* attdim */);
+
+		TupleDescInitEntry(tupdesc, (AttrNumber) 5, "balance",
+				INT8OID, -1 /* typmod */, 0 /* attdim */);
+
+		TupleDescInitEntry(tupdesc, (AttrNumber) 6, "peak",
+				INT8OID, -1 /* typmod */, 0 /* attdim */);
+
+		Assert(NUM_MEMORY_ACCOUNT_LIVE_ELEM == 6);
+
+		funcctx->tuple_desc = BlessTupleDesc(tupdesc);
+
+		cursor = (MemoryAccountLiveCursor *) palloc0(sizeof(*cursor));
+		cursor->ownerType = MEMORY_OWNER_TYPE_START_LONG_LIVING;
+
+		funcctx->user_fctx = cursor;
+
+		MemoryContextSwitchTo(oldcontext);
+	}
+
+	funcctx = SRF_PERCALL_SETUP();
+	cursor = (MemoryAccountLiveCursor *) funcctx->user_fctx;
+
+	/*
+	 * The balances are read without locking. Each backend only ever writes
+	 * its own slot, so a row may just be slightly out of date.
+	 */
+	while (cursor->backendIndex < MaxBackends)
+	{
+		MemoryAccountingBackendStats *stats =
+				&MemoryAccountingAllBackendStats[cursor->backendIndex];
+		int ownerType = cursor->ownerType;
+		int pid = stats->pid;
+		uint64 balance;
+		uint64 peak;
+
+		if (0 == pid || ownerType >= MEMORY_OWNER_TYPE_COUNT)
+		{
+			/* Move on to the next backend */
+			cursor->backendIndex++;
+			cursor->ownerType = MEMORY_OWNER_TYPE_START_LONG_LIVING;
+			continue;
+		}
+
+		cursor->ownerType++;
+
+		balance = stats->balance[ownerType];
+		peak = stats->peak[ownerType];
+
+		if (0 == balance && 0 == peak)
+			continue;
+
+		Datum		values[NUM_MEMORY_ACCOUNT_LIVE_ELEM];
+		bool		nulls[NUM_MEMORY_ACCOUNT_LIVE_ELEM];
+		MemSet(nulls, 0, sizeof(nulls));
+
+		values[0] = Int32GetDatum(Gp_segment);
+		values[1] = Int32GetDatum(pid);
+		values[2] = Int32GetDatum(stats->sessionId);
+		values[3] = CStringGetTextDatum(MemoryAccounting_GetOwnerName((MemoryOwnerType) ownerType));
+		values[4] = Int64GetDatum((int64) balance);
+		values[5] = Int64GetDatum((int64) peak);
+
+		HeapTuple tuple = heap_form_tuple(funcctx->tuple_desc, values, nulls);
+		Datum result = HeapTupleGetDatum(tuple);
+		SRF_RETURN_NEXT(funcctx, result);
+	}
+
+	SRF_RETURN_DONE(funcctx);
+}
@@ -3,6 +3,8 @@ SET search_path = session_state;
 
 BEGIN;
 
+DROP VIEW memory_account_live;
+DROP FUNCTION memory_account_live_entries_f();
 DROP VIEW session_state_memory_entries; 
 DROP FUNCTION session_state_memory_entries_f();
 DROP SCHEMA session_state;
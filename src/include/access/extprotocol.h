@@ -30,6 +30,14 @@ typedef struct ExtProtocolData
 	int				prot_maxbytes;
 	void*			prot_user_ctx;
 	bool			prot_last_call;
+
+	/*
+	 * read only: columns the scan uses (NULL if all), and its "Var op Const"
+	 * quals, so that data that can't match may be skipped at the source.
+	 * Both are unset when single row error handling is on.
+	 */
+	bool		   *prot_needed_cols;
+	List		   *prot_quals;
 		
 } ExtProtocolData;
 
@@ -44,6 +52,8 @@ typedef ExtProtocolData *ExtProtocol;
 #define EXTPROTOCOL_GET_DATALEN(fcinfo)    (((ExtProtocolData*) fcinfo->context)->prot_maxbytes)
 #define EXTPROTOCOL_GET_USER_CTX(fcinfo)   (((ExtProtocolData*) fcinfo->context)->prot_user_ctx)
 #define EXTPROTOCOL_IS_LAST_CALL(fcinfo)   (((ExtProtocolData*) fcinfo->context)->prot_last_call)
+#define EXTPROTOCOL_GET_NEEDED_COLS(fcinfo) (((ExtProtocolData*) fcinfo->context)->prot_needed_cols)
+#define EXTPROTOCOL_GET_QUALS(fcinfo)      (((ExtProtocolData*) fcinfo->context)->prot_quals)
 
 #define EXTPROTOCOL_SET_LAST_CALL(fcinfo)  (((ExtProtocolData*) fcinfo->context)->prot_last_call = true)
 #define EXTPROTOCOL_SET_USER_CTX(fcinfo, p) \
@@ -60,7 +60,8 @@ extern FileScanDesc external_beginscan(Relation relation, Index scanrelid,
 								   uint32 scancounter, List *uriList,
 								   List *fmtOpts, char fmtType, bool isMasterOnly,
 								   int rejLimit, bool rejLimitInRows,
-								   Oid fmterrtbl, int encoding);
+								   Oid fmterrtbl, int encoding,
+								   bool *neededCols, List *quals);
 extern void external_rescan(FileScanDesc scan);
 extern void external_endscan(FileScanDesc scan);
 extern void external_stopscan(FileScanDesc scan);
@@ -71,6 +72,10 @@ extern void external_insert_finish(ExternalInsertDesc extInsertDesc);
 extern void external_set_env_vars(extvar_t *extvar, char* uri, bool csv, char* escape, char* quote, bool header, uint32 scancounter);
 extern void AtEOXact_ExtTables(bool isCommit);
 extern void AtEOXact_ResetDataSourceCtx(void);
+
+/* built-in formatters, in columnar.c */
+extern Datum columnar_in(PG_FUNCTION_ARGS);
+extern Datum columnar_out(PG_FUNCTION_ARGS);
 char*	linenumber_atoi(char buffer[20],int64 linenumber);
 
 
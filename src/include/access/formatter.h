@@ -58,6 +58,18 @@ typedef struct FormatterData
 	bool			fmt_needs_transcoding;
 	FmgrInfo*		fmt_conversion_proc;
 	int				fmt_external_encoding;
+
+	/* export: call once more with a NULL record at the end of the data */
+	bool			fmt_needs_final_call;
+
+	/*
+	 * import: columns the scan uses (NULL if all), and its "Var op Const"
+	 * quals. Other columns may be returned as NULL, and rows that can't pass
+	 * the quals may be skipped. The quals are checked again by the scan.
+	 * Both are unset when single row error handling is on.
+	 */
+	bool		   *fmt_needed_cols;
+	List		   *fmt_quals;
 		
 } FormatterData;
 
@@ -74,6 +86,8 @@ typedef struct FormatterData
 #define FORMATTER_GET_PER_ROW_MEM_CTX(fcinfo) (((FormatterData*) fcinfo->context)->fmt_perrow_ctx)
 #define FORMATTER_GET_CONVERSION_FUNCS(fcinfo) (((FormatterData*) fcinfo->context)->fmt_conv_funcs)
 #define FORMATTER_GET_TYPIOPARAMS(fcinfo)     (((FormatterData*) fcinfo->context)->fmt_typioparams)
+#define FORMATTER_GET_NEEDED_COLS(fcinfo)     (((FormatterData*) fcinfo->context)->fmt_needed_cols)
+#define FORMATTER_GET_QUALS(fcinfo)           (((FormatterData*) fcinfo->context)->fmt_quals)
 #define FORMATTER_GET_ARG_LIST(fcinfo)	      (((FormatterData*) fcinfo->context)->fmt_args)
 #define FORMATTER_GET_NUM_ARGS(fcinfo)	      (list_length(FORMATTER_GET_ARG_LIST(fcinfo)))
 #define FORMATTER_GET_NTH_ARG_KEY(fcinfo, n)  (((DefElem *)(list_nth(FORMATTER_GET_ARG_LIST(fcinfo),(n - 1))))->defname)
@@ -94,6 +108,9 @@ typedef struct FormatterData
 #define FORMATTER_SET_DATACURSOR(fcinfo, n) \
 	((((FormatterData*) fcinfo->context)->fmt_databuf.cursor) = n)
 
+#define FORMATTER_SET_NEEDS_FINAL_CALL(fcinfo) \
+	(((FormatterData*) fcinfo->context)->fmt_needs_final_call = true)
+
 #define FORMATTER_SET_TUPLE(fcinfo, t) \
 	(((FormatterData*) fcinfo->context)->fmt_tuple = t)
 
@@ -266,6 +266,7 @@ extern Datum hashtext(PG_FUNCTION_ARGS);
 extern Datum hashvarlena(PG_FUNCTION_ARGS);
 extern Datum hash_any(register const unsigned char *k, register int keylen);
 extern Datum hash_uint32(uint32 k);
+extern uint64 hash_any64(const unsigned char *k, int keylen);
 
 /* private routines */
 
@@ -129,6 +129,10 @@ typedef struct FileScanDescData
 	/* custom data formatter */
 	FormatterData *fs_formatter;
 
+	/* pushed down from the scan node, see ExecInitExternalScan */
+	bool	   *fs_neededCols;	/* columns to convert, NULL for all */
+	List	   *fs_quals;		/* "Var op Const" quals */
+
 	/* external partition */
 	bool		fs_hasConstraints;
 	List		**fs_constraintExprs;	
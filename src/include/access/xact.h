@@ -88,6 +88,7 @@ typedef void (*SubXactCallback) (SubXactEvent event, SubTransactionId mySubid,
 #define XLOG_XACT_ABORT_PREPARED	0x40
 #define XLOG_XACT_DISTRIBUTED_COMMIT 0x50
 #define XLOG_XACT_DISTRIBUTED_FORGET 0x60
+#define XLOG_XACT_ONE_PHASE_COMMIT	0x70
 
 typedef struct xl_xact_commit
 {
@@ -150,6 +151,18 @@ typedef struct xl_xact_abort_prepared
 
 #define MinSizeOfXactAbortPrepared offsetof(xl_xact_abort_prepared, arec.data)
 
+/*
+ * A ONE_PHASE_COMMIT record is a COMMIT record written by a QE that commits
+ * its part of a distributed transaction without PREPARE, because it is the
+ * only segment of that transaction. The distributed transaction follows the
+ * subtransaction XIDs, so that redo can mark it in the DistributedLog.
+ */
+typedef struct xl_xact_one_phase_commit
+{
+	DistributedTransactionTimeStamp distribTimeStamp;
+	DistributedTransactionId distribXid;
+} xl_xact_one_phase_commit;
+
 /* 
  * xl_xact_distributed_forget - moved to cdb/cdbtm.h 
  */
@@ -288,6 +288,9 @@ DATA(insert ( 3538	string_agg_delim_transfn - - - string_agg_finalfn 0 2281 _nul
 
 DATA(insert ( 6112	pg_partition_oid_transfn      - - - pg_partition_oid_finalfn 0 2281 _null_ f));
 
+/* hyperloglog */
+DATA(insert ( 5084	gp_hll_accum	- gp_hll_merge	- -	0 17 "" f));
+
 
 
 /*
@@ -1594,6 +1594,19 @@
 -- Analyze related
  CREATE FUNCTION gp_statistics_estimate_reltuples_relpages_oid(oid) RETURNS _float4 LANGUAGE internal VOLATILE STRICT AS 'gp_statistics_estimate_reltuples_relpages_oid' WITH (OID=5032, DESCRIPTION="Return reltuples/relpages information for relation.");
 
+ CREATE FUNCTION gp_hll_accum(bytea, anyelement) RETURNS bytea LANGUAGE internal IMMUTABLE STRICT AS 'gp_hll_accum' WITH (OID=5082, DESCRIPTION="aggregate transition function");
+
+ CREATE FUNCTION gp_hll_merge(bytea, bytea) RETURNS bytea LANGUAGE internal IMMUTABLE STRICT AS 'gp_hll_merge' WITH (OID=5083, DESCRIPTION="aggregate preliminary function");
+
+ CREATE FUNCTION gp_hll_sketch(anyelement) RETURNS bytea LANGUAGE internal IMMUTABLE AS 'aggregate_dummy' WITH (OID=5084, DESCRIPTION="HyperLogLog sketch of the distinct input values", proisagg="t");
+
+ CREATE FUNCTION gp_hll_estimate(bytea) RETURNS float8 LANGUAGE internal IMMUTABLE STRICT AS 'gp_hll_estimate' WITH (OID=5085, DESCRIPTION="Estimate the number of distinct values in a HyperLogLog sketch.");
+
+-- External table formatters
+ CREATE FUNCTION columnar_in() RETURNS record LANGUAGE internal STABLE AS 'columnar_in' WITH (OID=5086, DESCRIPTION="columnar binary external table formatter, for reading");
+
+ CREATE FUNCTION columnar_out(record) RETURNS bytea LANGUAGE internal STABLE AS 'columnar_out' WITH (OID=5087, DESCRIPTION="columnar binary external table formatter, for writing");
+
 -- Backoff related
  CREATE FUNCTION gp_adjust_priority(int4, int4, int4) RETURNS int4 LANGUAGE internal VOLATILE STRICT AS 'gp_adjust_priority_int' WITH (OID=5040, DESCRIPTION="change weight of all the backends for a given session id");
 
@@ -22,7 +22,7 @@
 
    WARNING: DO NOT MODIFY THE FOLLOWING SECTION: 
    Generated by catullus.pl version 8
-   on Tue Nov 15 14:46:37 2016
+   on Mon Oct 19 04:03:39 2026
 
    Please make your changes in pg_proc.sql
 */
@@ -2591,6 +2591,32 @@ DESCR("Greenplum fault testing only");
 DATA(insert OID = 5032 ( gp_statistics_estimate_reltuples_relpages_oid  PGNSP PGUID 12 1 0 0 f f t f v 1 0 1021 f "26" _null_ _null_ _null_ _null_ gp_statistics_estimate_reltuples_relpages_oid _null_ _null_ _null_ n ));
 DESCR("Return reltuples/relpages information for relation.");
 
+/* gp_hll_accum(bytea, anyelement) => bytea */ 
+DATA(insert OID = 5082 ( gp_hll_accum  PGNSP PGUID 12 1 0 0 f f t f i 2 0 17 f "17 2283" _null_ _null_ _null_ _null_ gp_hll_accum _null_ _null_ _null_ n ));
+DESCR("aggregate transition function");
+
+/* gp_hll_merge(bytea, bytea) => bytea */ 
+DATA(insert OID = 5083 ( gp_hll_merge  PGNSP PGUID 12 1 0 0 f f t f i 2 0 17 f "17 17" _null_ _null_ _null_ _null_ gp_hll_merge _null_ _null_ _null_ n ));
+DESCR("aggregate preliminary function");
+
+/* gp_hll_sketch(anyelement) => bytea */ 
+DATA(insert OID = 5084 ( gp_hll_sketch  PGNSP PGUID 12 1 0 0 t f f f i 1 0 17 f "2283" _null_ _null_ _null_ _null_ aggregate_dummy _null_ _null_ _null_ n ));
+DESCR("HyperLogLog sketch of the distinct input values");
+
+/* gp_hll_estimate(bytea) => float8 */ 
+DATA(insert OID = 5085 ( gp_hll_estimate  PGNSP PGUID 12 1 0 0 f f t f i 1 0 701 f "17" _null_ _null_ _null_ _null_ gp_hll_estimate _null_ _null_ _null_ n ));
+DESCR("Estimate the number of distinct values in a HyperLogLog sketch.");
+
+
+/* External table formatters */
+/* columnar_in() => record */ 
+DATA(insert OID = 5086 ( columnar_in  PGNSP PGUID 12 1 0 0 f f f f s 0 0 2249 f "" _null_ _null_ _null_ _null_ columnar_in _null_ _null_ _null_ n ));
+DESCR("columnar binary external table formatter, for reading");
+
+/* columnar_out(record) => bytea */ 
+DATA(insert OID = 5087 ( columnar_out  PGNSP PGUID 12 1 0 0 f f f f s 1 0 17 f "2249" _null_ _null_ _null_ _null_ columnar_out _null_ _null_ _null_ n ));
+DESCR("columnar binary external table formatter, for writing");
+
 
 /* Backoff related */
 /* gp_adjust_priority(int4, int4, int4) => int4 */ 
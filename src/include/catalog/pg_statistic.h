@@ -238,6 +238,17 @@ typedef FormData_pg_statistic *Form_pg_statistic;
  */
 #define STATISTIC_KIND_CORRELATION	3
 
+/*
+ * A "HyperLogLog" slot holds a sketch of the distinct non-null values of the
+ * column, built over the whole table rather than the sample (see
+ * gp_statistics_use_hll). staop is not used. stavalues contains a single
+ * bytea, the sketch (see lib/hyperloglog.h), and stanumbers is not used.
+ * The sketches of the leaf partitions of a table are merged to estimate the
+ * number of distinct values of the partitioned table. This is a Greenplum
+ * addition.
+ */
+#define STATISTIC_KIND_HLL	98
+
 /* quoting pg_authid and gp_configuration: */
 
 /*
@@ -18,6 +18,14 @@
 
 #define COPYOUT_CHUNK_SIZE 16 * 1024
 
+/*
+ * COPY FROM data is batched per segment, and handed to libpq in chunks of at
+ * least this size. Up to COPYIN_BACKLOG_SIZE bytes may be queued for a segment
+ * that can't keep up, before we wait for it.
+ */
+#define COPYIN_CHUNK_SIZE (64 * 1024)
+#define COPYIN_BACKLOG_SIZE (4 * COPYIN_CHUNK_SIZE)
+
 typedef enum SegDbState
 {
 	/*
@@ -46,6 +54,7 @@ typedef struct CdbCopy
 	StringInfoData	err_msg;		/* error message for cdbcopy operations */
 	StringInfoData  err_context; /* error context from QE error */
 	StringInfoData	copy_out_buf;/* holds a chunk of data from the database */
+	StringInfoData *copy_in_bufs;/* per segment, data rows not yet sent */
 		
 	List			*outseglist;    /* segs that currently take part in copy out. 
 									 * Once a segment gave away all it's data rows
@@ -62,6 +62,28 @@ typedef struct DistributedSnapshotHeader
 										 */
 } DistributedSnapshotHeader;
 
+typedef enum
+{
+	DISTRIBUTEDSNAPSHOT_COMMITTED_NONE = 0,		
+	DISTRIBUTEDSNAPSHOT_COMMITTED_INPROGRESS,
+	DISTRIBUTEDSNAPSHOT_COMMITTED_VISIBLE,
+	DISTRIBUTEDSNAPSHOT_COMMITTED_IGNORE
+	
+} DistributedSnapshotCommitted;
+
+/*
+ * Number of entries in the cache of committed test results kept with a
+ * distributed snapshot.  Must be a power of 2.
+ */
+#define DISTRIBUTEDSNAPSHOT_XID_CACHE_SIZE 128
+
+typedef struct DistributedSnapshotXidCacheEntry
+{
+	TransactionId					localXid;
+	DistributedSnapshotCommitted	committed;
+
+} DistributedSnapshotXidCacheEntry;
+
 #define DistributedSnapshotWithLocalMapping_StaticInit {DistributedSnapshotHeader_StaticInit,NULL}
 
 /*
@@ -79,7 +101,16 @@ typedef struct DistributedSnapshotWithLocalMapping
 										/* 
 										 * Array of distributed transactions
 										 * in progress, optionally with the
-										 * associated local xid.
+										 * associated local xid.  Sorted by
+										 * distributed xid.
+										 */
+
+	DistributedSnapshotXidCacheEntry	xidCache[DISTRIBUTEDSNAPSHOT_XID_CACHE_SIZE];
+										/*
+										 * Results of recent committed tests,
+										 * direct-mapped on the local xid.
+										 * Must be reset whenever the header
+										 * or the array above change.
 										 */
 
 } DistributedSnapshotWithLocalMapping;
@@ -98,20 +129,14 @@ typedef struct DistributedSnapshot
 
 } DistributedSnapshot;
 
-typedef enum
-{
-	DISTRIBUTEDSNAPSHOT_COMMITTED_NONE = 0,		
-	DISTRIBUTEDSNAPSHOT_COMMITTED_INPROGRESS,
-	DISTRIBUTEDSNAPSHOT_COMMITTED_VISIBLE,
-	DISTRIBUTEDSNAPSHOT_COMMITTED_IGNORE
-	
-} DistributedSnapshotCommitted;
-
 extern DistributedSnapshotCommitted DistributedSnapshotWithLocalMapping_CommittedTest(
 	DistributedSnapshotWithLocalMapping		*dslm,
 	TransactionId 							localXid,
 	bool									isXmax);
 
+extern void DistributedSnapshotWithLocalMapping_ResetXidCache(
+	DistributedSnapshotWithLocalMapping		*dslm);
+
 extern void DistributedSnapshot_Reset(
 	DistributedSnapshot *distributedSnapshot);
 
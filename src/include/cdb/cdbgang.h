@@ -50,6 +50,12 @@ typedef struct Gang
 
 	/* memory context */
 	MemoryContext perGangContext;
+
+	/*
+	 * Connection state of a gang that is still being connected in the
+	 * background (see startGang_async), NULL once the gang is usable.
+	 */
+	struct PendingGangConnect *pendingConnect;
 } Gang;
 
 extern int qe_gang_id;
@@ -73,6 +79,8 @@ extern void DisconnectAndDestroyAllGangs(bool resetSession);
 
 extern void CheckForResetSession(void);
 
+extern void replenishWarmReaderGangs(void);
+
 extern List *getAllIdleReaderGangs(void);
 
 extern List *getAllAllocatedReaderGangs(void);
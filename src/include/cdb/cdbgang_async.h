@@ -14,4 +14,7 @@
 
 extern CreateGangFunc pCreateGangFuncAsync;
 
+extern Gang *startGang_async(GangType type, int gang_id, int size, int content);
+extern bool advancePendingGangs_async(List **pending, List **ready, bool wait, int wakeFd);
+
 #endif
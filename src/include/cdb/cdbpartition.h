@@ -35,8 +35,10 @@ typedef struct PartitionRangeState
 	FmgrInfo *lefuncs_direct; /* comparator expr <= partRule */
 	FmgrInfo *ltfuncs_inverse; /* comparator partRule < expr */
 	FmgrInfo *lefuncs_inverse; /* comparator partRule <= expr */
+	PartitionNode *last_node; /* node of last_rule, or NULL */
 	int last_rule; /* cache offset to the last rule and test if it matches */
-	PartitionRule **rules;
+	PartitionRule **rules;	/* rules of the top level node, as an array */
+	HTAB *rules_hash;	/* rule arrays of lower level nodes, by node */
 } PartitionRangeState;
 
 /* likewise, for list */
@@ -77,7 +77,13 @@ typedef enum
 	DTX_STATE_NOTIFYING_ABORT_PREPARED,
 	DTX_STATE_RETRY_COMMIT_PREPARED,
 	DTX_STATE_RETRY_ABORT_PREPARED,
-	DTX_STATE_CRASH_COMMITTED
+	DTX_STATE_CRASH_COMMITTED,
+
+	/**
+	 * Only one segment took part in the transaction, and the QD is telling
+	 *   it to commit without a first phase.
+	 */
+	DTX_STATE_ONE_PHASE_COMMIT
 }	DtxState;
 
 /**
@@ -108,7 +114,12 @@ typedef enum
 	DTX_PROTOCOL_COMMAND_SUBTRANSACTION_ROLLBACK_INTERNAL,
 	DTX_PROTOCOL_COMMAND_SUBTRANSACTION_RELEASE_INTERNAL,
 
-	DTX_PROTOCOL_COMMAND_LAST = DTX_PROTOCOL_COMMAND_SUBTRANSACTION_RELEASE_INTERNAL
+	/**
+	 * Instruct the only QE of the transaction to commit it, without PREPARE.
+	 */
+	DTX_PROTOCOL_COMMAND_COMMIT_ONEPHASE,
+
+	DTX_PROTOCOL_COMMAND_LAST = DTX_PROTOCOL_COMMAND_COMMIT_ONEPHASE
 } DtxProtocolCommand;
 
 /* DTX Context above xact.c */
@@ -158,6 +158,13 @@ extern int qdPostmasterPort;
 /*How many gangs to keep around from stmt to stmt.*/
 extern int			gp_cached_gang_threshold;
 
+/*
+ * How many idle reader gangs the QD creates ahead of time, while the session
+ * waits for the client, so that the next statement does not pay for their
+ * creation. Bounded by gp_cached_gang_threshold.
+ */
+extern int			gp_warm_reader_gangs;
+
 /*
  * gp_reject_percent_threshold
  *
@@ -365,6 +372,17 @@ extern int	gp_connections_per_thread; /* GUC var - server operating mode.  */
 extern bool assign_gp_connections_per_thread(int newval, bool doit, GucSource source);
 extern const char *show_gp_connections_per_thread(void);
 
+/*
+ * Parameter gp_dispatch_send_threads
+ *
+ * Only used by the asynchronous dispatcher (gp_connections_per_thread = 0).
+ * When greater than 1, the query text is first staged on every connection
+ * of every gang, and then pushed to the QEs by up to this many helper
+ * threads in parallel, instead of being sent one connection at a time by
+ * the main thread.
+ */
+extern int	gp_dispatch_send_threads; /* GUC var */
+
 /*
  * If number of subtransactions within a transaction exceed this limit,
  * then a warning is given to the user.
@@ -901,6 +919,9 @@ extern int gp_hashagg_default_nbatches;
 /* Hashjoin use bloom filter */
 extern int gp_hashjoin_bloomfilter;
 
+/* Use arena memory contexts for per-tuple expression evaluation */
+extern bool gp_enable_per_tuple_arena;
+
 /* Get statistics for partitioned parent from a child */
 extern bool 	gp_statistics_pullup_from_child_partition;
 
@@ -911,6 +932,7 @@ extern bool		gp_statistics_use_fkeys;
 extern int 		gp_statistics_blocks_target;
 extern double	gp_statistics_ndistinct_scaling_ratio_threshold;
 extern double	gp_statistics_sampling_threshold;
+extern bool		gp_statistics_use_hll;
 
 /* Analyze tools */
 extern int gp_motion_slice_noop;
@@ -24,6 +24,7 @@ extern bool						gp_log_resqueue_memory;
 extern int						gp_resqueue_memory_policy_auto_fixed_mem;
 extern const int				gp_resqueue_memory_log_level;
 extern bool						gp_resqueue_print_operator_memory_limits;
+extern bool						gp_resqueue_memory_broker;
 
 extern void PolicyAutoAssignOperatorMemoryKB(PlannedStmt *stmt, uint64 memoryAvailable);
 extern void PolicyEagerFreeAssignOperatorMemoryKB(PlannedStmt *stmt, uint64 memoryAvailable);
@@ -58,4 +59,12 @@ extern uint64 PolicyAutoStatementMemForNoSpillKB(PlannedStmt *stmt, uint64 minOp
  */
 extern bool IsResultMemoryIntesive(Result *res);
 
+/**
+ * Runtime redistribution of operator memory quota within a statement.
+ */
+extern void MemoryBroker_Reset(void);
+extern void MemoryBroker_Release(uint64 bytes);
+extern uint64 MemoryBroker_Request(uint64 minBytes, uint64 wantBytes);
+extern uint64 MemoryBroker_Reclaim(uint64 bytes);
+
 #endif /* MEMQUOTA_H_ */
@@ -204,6 +204,7 @@ typedef struct HashAggTable
 	double mem_for_metadata; /* Current memory usage for metadata */
 	double mem_wanted; /* The desirable work_mem */
 	double mem_used; /* The maxinum amount of used memory. */
+	double mem_borrowed; /* Memory quota obtained from the memory broker */
 	
 	uint32 num_reloads; /* number of times reloading a batch file */
 	uint32 num_batches; /* number of batch files */
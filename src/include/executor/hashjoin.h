@@ -181,6 +181,8 @@ typedef struct HashJoinTableData
 	bool	   *hashStrict;		/* is each hash join operator strict? */
 
 	Size		spaceAllowed;	/* upper limit for space used */
+	Size		spaceReleased;	/* quota given back to the memory broker */
+	Size		spaceBorrowed;	/* quota obtained from the memory broker */
 
 	MemoryContext hashCxt;		/* context for whole-hash-join storage */
 	MemoryContext batchCxt;		/* context for this-batch-only storage */
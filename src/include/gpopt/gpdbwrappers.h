@@ -55,6 +55,24 @@ struct Var;
 struct Const;
 struct ArrayExpr;
 
+// kinds of metadata cache entries affected by a catalog change
+typedef enum MDCacheInvalKind
+{
+	MDCacheInvalObject,		// type, function or constraint with the given oid
+	MDCacheInvalRelation,	// relation with its indexes, triggers, constraints and stats
+	MDCacheInvalRelStats	// relation and column statistics only
+} MDCacheInvalKind;
+
+// metadata cache entries to evict, as returned by FMDCacheNeedsReset
+typedef struct MDCacheInval
+{
+	MDCacheInvalKind kind;
+	Oid oid;
+
+	// upper bound on the number of user columns of a relation
+	int natts;
+} MDCacheInval;
+
 namespace gpdb {
 
 	// convert datum to bool
@@ -610,8 +628,23 @@ namespace gpdb {
 	gpos::ULONG UlLeafPartitions(Oid oidRelation);
 
 	// Does the metadata cache need to be reset (because of a catalog
-	// table has been changed?)
-	bool FMDCacheNeedsReset(void);
+	// table has been changed?) If only individual objects need to be
+	// evicted, returns false and a list of MDCacheInval in pplMDInval
+	bool FMDCacheNeedsReset(List **pplMDInval);
+
+	// version of a metadata object with the given oid in the shared MDCache
+	uint64 UllMDSharedCacheObjectVersion(Oid oid);
+
+	// version of the statistics of a relation, or one of its columns, in
+	// the shared MDCache
+	uint64 UllMDSharedCacheStatsVersion(Oid oidRelation, int iAttno);
+
+	// look up the DXL of a metadata object in the shared MDCache; returns
+	// a palloc'd copy, or NULL if there is no entry with the given version
+	char *SzMDSharedCacheLookup(const char *szKey, uint64 ullVersion);
+
+	// store the DXL of a metadata object in the shared MDCache
+	void MDSharedCacheInsert(const char *szKey, uint64 ullVersion, const char *szDXL);
 
 } //namespace gpdb
 
@@ -24,6 +24,7 @@
 #include "naucrates/md/CSystemId.h"
 #include "naucrates/md/IMDId.h"
 #include "naucrates/md/IMDProvider.h"
+#include "naucrates/md/IMDCacheObject.h"
 
 // fwd decl
 namespace gpopt
@@ -52,6 +53,14 @@ namespace gpmd
 			// private copy ctor
 			CMDProviderRelcache(const CMDProviderRelcache&);
 
+			// version of the object in the shared MDCache, if it can be shared
+			static
+			BOOL FSharedVersion(CMDAccessor *pmda, IMDId *pmdid, ULLONG *pullVersion);
+
+			// can the serialized object be stored in the shared MDCache
+			static
+			BOOL FShareable(const IMDCacheObject *pimdobj, const CWStringBase *pstr);
+
 		public:
 			// ctor/dtor
 			explicit
@@ -246,7 +246,7 @@ namespace gpdxl
 			DrgPdxlbucket *PdrgpdxlbucketTransformStats
 								(
 								IMemoryPool *pmp,
-								OID oidAttType,
+								const IMDType *pmdtype,
 								CDouble dDistinct,
 								CDouble dNullFreq,
 								const Datum *pdrgdatumMCVValues,
@@ -221,6 +221,10 @@ class COptTasks
 		static
 		DrgPss *PdrgPssLoad(IMemoryPool *pmp, char *szPath);
 
+		// limit the time spent in the given search strategy
+		static
+		DrgPss *PdrgpssTimeLimited(IMemoryPool *pmp, DrgPss *pdrgpss, ULONG ulTimeThreshold);
+
 		// allocate memory for string
 		static
 		CHAR *SzAllocate(IMemoryPool *pmp, ULONG ulSize);
@@ -253,6 +257,19 @@ class COptTasks
 		static
 		void PrintMissingStatsWarning(IMemoryPool *pmp, CMDAccessor *pmda, DrgPmdid *pdrgmdidCol, HMMDIdMDId *phmmdidRel);
 
+		// mark the metadata cache entry with the given mdid for deletion
+		static
+		void EvictMDCacheEntry(IMDId *pmdid);
+
+		// evict the metadata cache entries affected by catalog changes
+		static
+		void EvictMDCacheEntries(IMemoryPool *pmp, List *plMDInval);
+
+		// initialize the metadata cache, or reset it or evict entries affected by catalog changes;
+		// returns true if the cache was initialized by this call
+		static
+		BOOL FUpdateMDCache(IMemoryPool *pmp);
+
 	public:
 
 		// convert Query->DXL->LExpr->Optimize->PExpr->DXL
@@ -48,6 +48,7 @@ extern "C" {
 #include "cdb/cdbutil.h"
 #include "cdb/cdbmutate.h"
 #include "commands/defrem.h"
+#include "commands/tablecmds.h"
 #include "utils/typcache.h"
 #include "utils/numeric.h"
 #include "optimizer/tlist.h"
@@ -60,11 +61,15 @@ extern "C" {
 #include "access/relscan.h"
 #include "access/heapam.h"
 #include "catalog/pg_proc.h"
+#include "catalog/pg_partition.h"
+#include "catalog/pg_partition_rule.h"
+#include "catalog/pg_statistic.h"
 #include "tcop/dest.h"
 #include "commands/trigger.h"
 #include "parser/parse_coerce.h"
 #include "utils/selfuncs.h"
 #include "utils/faultinjector.h"
+#include "utils/mdsharedcache.h"
 
 extern
 Query *preprocess_query_optimizer(Query *pquery, ParamListInfo boundParams);
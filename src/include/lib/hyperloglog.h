@@ -0,0 +1,43 @@
+/*-------------------------------------------------------------------------
+ *
+ * hyperloglog.h
+ *	  HyperLogLog sketches, for estimating the number of distinct values
+ *
+ * A sketch is stored as a bytea, so that it can be used as the transition
+ * value of an aggregate, sent between segments, and kept in pg_statistic.
+ * Two sketches of the same precision can be merged, giving the sketch of the
+ * union of their inputs.
+ *
+ * Copyright (c) 2016, Pivotal Software, Inc.
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef HYPERLOGLOG_H
+#define HYPERLOGLOG_H
+
+/*
+ * Number of index bits of the hash. 2^14 registers give a standard error of
+ * about 0.81%, in a 16kB sketch per column.
+ */
+#define HLL_PRECISION		14
+#define HLL_NREGISTERS		(1 << HLL_PRECISION)
+
+typedef struct HyperLogLog
+{
+	int32		vl_len_;		/* varlena header (do not touch directly!) */
+	uint8		precision;		/* always HLL_PRECISION, for now */
+	uint8		registers[HLL_NREGISTERS];
+} HyperLogLog;
+
+#define HLL_SIZE			sizeof(HyperLogLog)
+
+/* Is this bytea a sketch we know how to read? */
+#define HllIsValid(hll) \
+	(VARSIZE(hll) == HLL_SIZE && (hll)->precision == HLL_PRECISION)
+
+extern HyperLogLog *hll_create(void);
+extern void hll_add_hash(HyperLogLog *hll, uint64 hash);
+extern void hll_merge(HyperLogLog *dst, const HyperLogLog *src);
+extern double hll_estimate(const HyperLogLog *hll);
+
+#endif   /* HYPERLOGLOG_H */
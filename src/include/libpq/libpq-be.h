@@ -188,4 +188,10 @@ extern int	pq_setkeepalivesidle(int idle, Port *port);
 extern int	pq_setkeepalivesinterval(int interval, Port *port);
 extern int	pq_setkeepalivescount(int count, Port *port);
 
+/*
+ * GPDB: declared here rather than in libpq.h, so that code that talks to the
+ * QEs through gp-libpq-fe.h, which conflicts with libpq.h, can use it.
+ */
+extern bool pq_input_pending(void);
+
 #endif   /* LIBPQ_BE_H */
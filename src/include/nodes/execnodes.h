@@ -403,6 +403,8 @@ typedef struct PartitionState
 	AttrNumber	max_partition_attr;
 	int			result_partition_array_size; /* max elements of result relation array */
 	HTAB	   *result_partition_hash;
+	Oid			last_result_partition;	/* partition of the last routed row */
+	int			last_result_partition_offset;	/* ... and its ResultRelInfo */
 	PartitionAccessMethods *accessMethods;
 } PartitionState;
 
@@ -2471,6 +2473,8 @@ typedef struct HashState
 	bool		hs_keepnull;	/* Keep nulls */
 	bool		hs_quit_if_hashkeys_null;	/* quit building hash table if hashkeys are all null */
 	bool		hs_hashkeys_null;	/* found an instance wherein hashkeys are all null */
+	Size		hs_spaceLent;	/* quota lent to the memory broker by an
+								 * earlier hash table, and not back yet */
 	/* hashkeys is same as parent's hj_InnerHashKeys */
 } HashState;
 
@@ -85,7 +85,8 @@ typedef struct MemoryContextData
 	((context) != NULL && \
 	 ( IsA((context), AllocSetContext) || \
        IsA((context), AsetDirectContext) || \
-       IsA((context), MPoolContext) ))
+       IsA((context), MPoolContext) || \
+       IsA((context), ArenaContext) ))
 
 
 #endif   /* MEMNODES_H */
@@ -318,6 +318,7 @@ typedef enum NodeTag
 	T_SerializedMemoryAccount,
 
     T_AsetDirectContext = 610,                                      /*CDB*/
+	T_ArenaContext,
 
 	/*
 	 * TAGS FOR VALUE NODES (value.h)
@@ -153,6 +153,15 @@ typedef struct PlannedStmt
 
 	/* What is the memory reserved for this query's execution? */
 	uint64		query_mem;
+
+	/* GPDB: Used only on QD, for EXPLAIN. Don't serialize.  Time spent in
+	 *       each phase of the new optimizer, in milliseconds: translating
+	 *       the query, searching for a plan, and translating the plan.
+	 *       All zero for plans from the planner or the plan cache.
+	 */
+	double		optimizerQueryToDXLTime;
+	double		optimizerSearchTime;
+	double		optimizerDXLToPlStmtTime;
 } PlannedStmt;
 
 /*
@@ -130,6 +130,8 @@ typedef struct StreamNode
 	BlockNumber		nextblock;	/* block number we're up to */
 	void		   *opaque;     /* for IndexStream only */
 	List		   *input;		/* input streams; for OpStream only */
+	PagetableEntry *inputEntries;	/* one page per input; for OpStream only */
+	int				nInputEntries;	/* allocated length of inputEntries */
 	void          (*free)(struct StreamNode *self);
 	void          (*set_instrument)(struct StreamNode *self, struct Instrumentation *instr);
 	void          (*upd_instrument)(struct StreamNode *self);
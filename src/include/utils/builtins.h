@@ -428,6 +428,9 @@ extern Datum pg_total_relation_size_oid(PG_FUNCTION_ARGS);
 extern Datum pg_total_relation_size_name(PG_FUNCTION_ARGS);
 extern Datum pg_size_pretty(PG_FUNCTION_ARGS);
 extern Datum gp_statistics_estimate_reltuples_relpages_oid(PG_FUNCTION_ARGS);
+extern Datum gp_hll_accum(PG_FUNCTION_ARGS);
+extern Datum gp_hll_merge(PG_FUNCTION_ARGS);
+extern Datum gp_hll_estimate(PG_FUNCTION_ARGS);
 
 /* genfile.c */
 extern bytea *read_binary_file(const char *filename,
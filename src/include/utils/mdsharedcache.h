@@ -0,0 +1,30 @@
+/*-------------------------------------------------------------------------
+ *
+ * mdsharedcache.h
+ *	  Interface for the optimizer metadata cache shared by all backends.
+ *
+ * Copyright (c) 2016, Pivotal Software, Inc.
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef MDSHAREDCACHE_H
+#define MDSHAREDCACHE_H
+
+#include "access/attnum.h"
+#include "storage/sinval.h"
+
+/* maximum length of the key of a cached object, including terminator */
+#define MDSHAREDCACHE_KEYSIZE		64
+
+extern Size MDSharedCacheShmemSize(void);
+extern void MDSharedCacheShmemInit(void);
+
+extern void MDSharedCacheInvalidate(const SharedInvalidationMessage *msgs, int n);
+
+extern uint64 MDSharedCacheObjectVersion(Oid objid);
+extern uint64 MDSharedCacheStatsVersion(Oid relid, AttrNumber attno);
+
+extern char *MDSharedCacheLookup(const char *key, uint64 version);
+extern void MDSharedCacheInsert(const char *key, uint64 version, const char *data);
+
+#endif   /* MDSHAREDCACHE_H */
@@ -191,6 +191,36 @@ extern MemoryAccountIdType ActiveMemoryAccountId;
 		curMemoryAccountId == ((PlanState *)execState)->plan->memoryAccountId);\
 		((PlanState *)execState)->plan->memoryAccountId = curMemoryAccountId;
 
+/*
+ * Live memory usage of one backend, by owner type. Each backend publishes
+ * its balances in its own slot of a shared memory array as it allocates and
+ * frees, so that other backends can see what a running query is using
+ * without walking its account tree. Operators of the same type in one
+ * backend add up to the same entry.
+ */
+#define MEMORY_OWNER_TYPE_COUNT (MEMORY_OWNER_TYPE_END_SHORT_LIVING + 1)
+
+typedef struct MemoryAccountingBackendStats
+{
+	int			pid;			/* 0 if the slot is unused */
+	int			sessionId;		/* gp_session_id of the backend */
+
+	/* outstanding and peak bytes of each owner type, since the last reset */
+	uint64		balance[MEMORY_OWNER_TYPE_COUNT];
+	uint64		peak[MEMORY_OWNER_TYPE_COUNT];
+} MemoryAccountingBackendStats;
+
+/* Array of MaxBackends entries in shared memory, indexed by BackendId - 1 */
+extern MemoryAccountingBackendStats *MemoryAccountingAllBackendStats;
+
+extern Size MemoryAccounting_ShmemSize(void);
+extern void MemoryAccounting_ShmemInit(void);
+extern void MemoryAccounting_BackendStatsInit(void);
+extern void MemoryAccounting_BackendStatsShutdown(void);
+
+extern const char *
+MemoryAccounting_GetOwnerName(MemoryOwnerType ownerType);
+
 extern MemoryAccountIdType
 MemoryAccounting_CreateAccount(long maxLimit, enum MemoryOwnerType ownerType);
 
@@ -51,6 +51,9 @@ extern MemoryAccount *SharedChunkHeadersMemoryAccount;
 extern uint64 MemoryAccountingOutstandingBalance;
 extern uint64 MemoryAccountingPeakBalance;
 
+/* This backend's slot of MemoryAccountingAllBackendStats, if it has one */
+extern MemoryAccountingBackendStats *MyMemoryAccountingStats;
+
 /*
  * MemoryAccounting_IsLiveAccount
  *    Checks if an account is live.
@@ -139,6 +142,16 @@ MemoryAccounting_Allocate(MemoryAccountIdType memoryAccountId, Size allocatedSiz
 	MemoryAccountingOutstandingBalance += allocatedSize;
 	MemoryAccountingPeakBalance = Max(MemoryAccountingPeakBalance, MemoryAccountingOutstandingBalance);
 
+	if (NULL != MyMemoryAccountingStats)
+	{
+		MemoryOwnerType ownerType = memoryAccount->ownerType;
+		uint64 ownerBalance = MyMemoryAccountingStats->balance[ownerType] + allocatedSize;
+
+		MyMemoryAccountingStats->balance[ownerType] = ownerBalance;
+		if (ownerBalance > MyMemoryAccountingStats->peak[ownerType])
+			MyMemoryAccountingStats->peak[ownerType] = ownerBalance;
+	}
+
 	return true;
 }
 
@@ -174,6 +187,9 @@ MemoryAccounting_Free(MemoryAccountIdType memoryAccountId, Size allocatedSize)
 
 	Assert(MemoryAccountingOutstandingBalance >= 0);
 
+	if (NULL != MyMemoryAccountingStats)
+		MyMemoryAccountingStats->balance[memoryAccount->ownerType] -= allocatedSize;
+
 	return true;
 }
 
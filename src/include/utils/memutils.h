@@ -166,6 +166,33 @@ typedef struct AllocSetContext
 
 typedef AllocSetContext *AllocSet;
 
+typedef struct ArenaBlockData *ArenaBlock;	/* forward reference */
+
+/*
+ * ArenaContext is a bump-pointer implementation of MemoryContext, meant for
+ * short-lived allocations such as per-tuple expression evaluation.  Chunks
+ * are carved off the active block one after another and are only given back
+ * when the whole context is reset or deleted: pfree() does nothing, except
+ * for oversize chunks which live in a block of their own.  Memory accounting
+ * is done per block rather than per chunk.
+ */
+typedef struct ArenaContext
+{
+	MemoryContextData header;	/* Standard memory-context fields */
+	ArenaBlock	blocks;			/* head of list of blocks, the active one first */
+	ArenaBlock	keeper;			/* if not NULL, keep this block over resets */
+	char	   *freeptr;		/* start of free space in the active block */
+	char	   *endptr;			/* end of the active block */
+	Size		blockSize;		/* size of regular blocks */
+	Size		chunkLimit;		/* larger chunks get a block of their own */
+	bool		isReset;		/* T = no space alloced since last reset */
+
+	/* Shared by all the chunks of the arena; its memory account is unused */
+	SharedChunkHeader sharedHeader;
+} ArenaContext;
+
+typedef ArenaContext *Arena;
+
 /*
  * Standard top-level memory contexts.
  *
@@ -252,6 +279,11 @@ extern MemoryContext AllocSetContextCreate(MemoryContext parent,
 					  Size initBlockSize,
 					  Size maxBlockSize);
 
+/* arena.c */
+extern MemoryContext ArenaContextCreate(MemoryContext parent,
+				   const char *name,
+				   Size blockSize);
+
 /* mpool.c */
 typedef struct MPool MPool;
 extern MPool *mpool_create(MemoryContext parent,
@@ -270,6 +302,11 @@ extern uint64 mpool_bytes_used(MPool *mpool);
 #define ALLOCSET_DEFAULT_INITSIZE  (8 * 1024)
 #define ALLOCSET_DEFAULT_MAXSIZE   (8 * 1024 * 1024)
 
+/*
+ * Recommended block size for arena contexts.
+ */
+#define ARENA_DEFAULT_BLOCKSIZE	(8 * 1024)
+
 /*
  * Recommended alloc parameters for "small" contexts that are not expected
  * to contain much data (for example, a context to contain a query plan).
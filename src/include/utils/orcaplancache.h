@@ -0,0 +1,20 @@
+/*-------------------------------------------------------------------------
+ *
+ * orcaplancache.h
+ *	  Per-session cache of plans produced by the ORCA optimizer.
+ *
+ * Copyright (c) 2016, Pivotal Software, Inc.
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef ORCAPLANCACHE_H
+#define ORCAPLANCACHE_H
+
+#include "nodes/parsenodes.h"
+#include "nodes/plannodes.h"
+
+extern PlannedStmt *OrcaPlanCacheLookup(Query *query, char **key);
+extern void OrcaPlanCacheInsert(const char *key, PlannedStmt *plan);
+extern void ResetOrcaPlanCache(void);
+
+#endif   /* ORCAPLANCACHE_H */
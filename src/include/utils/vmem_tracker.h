@@ -50,6 +50,7 @@ extern void VmemTracker_Shutdown(void);
 extern void VmemTracker_ResetMaxVmemReserved(void);
 extern MemoryAllocationStatus VmemTracker_ReserveVmem(int64 newly_requested);
 extern void VmemTracker_ReleaseVmem(int64 to_be_freed_requested);
+extern void VmemTracker_ReleaseReservationCache(void);
 extern void VmemTracker_RequestWaiver(int64 waiver_bytes);
 extern int64 VmemTracker_Fault(int32 reason, int64 arg);
 
@@ -0,0 +1,108 @@
+--
+-- Test the one-phase commit of distributed transactions whose statements
+-- were all directly dispatched to the same segment. This uses the
+-- debug_dtm_action GUCs to make the segment fail, or PANIC, while it
+-- processes the COMMIT_ONEPHASE protocol command.
+--
+
+CREATE TABLE onephase_tab(a int4, b int4) DISTRIBUTED BY (a);
+INSERT INTO onephase_tab VALUES (1, 0);
+
+-- The debug_dtm_action GUCs only act on one segment. Point them at the
+-- segment that holds the rows with a = 1, so that the test doesn't depend
+-- on the number of segments. The GUCs are SET before BEGIN, because a SET
+-- inside the transaction would be dispatched to all segments, and the
+-- transaction would not be committed in one phase. They are SET again
+-- after each failure, because the master drops the gang then.
+CREATE FUNCTION onephase_set_action(action text) RETURNS void AS $$
+DECLARE
+  seg int4;
+BEGIN
+  SELECT gp_segment_id INTO seg FROM onephase_tab WHERE a = 1;
+  EXECUTE 'SET debug_dtm_action_segment = ' || seg;
+  EXECUTE 'SET debug_dtm_action_target = protocol';
+  EXECUTE 'SET debug_dtm_action_protocol = commit_onephase';
+  EXECUTE 'SET debug_dtm_action = ' || action;
+END;
+$$ LANGUAGE plpgsql;
+
+-- Wait until the segment has restarted after a PANIC.
+CREATE FUNCTION onephase_wait_for_segment() RETURNS void AS $$
+BEGIN
+  FOR i IN 1..120 LOOP
+    BEGIN
+      PERFORM count(*) FROM onephase_tab WHERE a = 1;
+      RETURN;
+    EXCEPTION WHEN OTHERS THEN
+      PERFORM pg_sleep(1);
+    END;
+  END LOOP;
+  RAISE EXCEPTION 'segment did not come back up';
+END;
+$$ LANGUAGE plpgsql;
+
+-- A transaction that touches only one segment commits there directly,
+-- and its effects are visible to the statements that follow.
+SELECT onephase_set_action('none');
+BEGIN;
+UPDATE onephase_tab SET b = b + 1 WHERE a = 1;
+INSERT INTO onephase_tab VALUES (1, 10);
+COMMIT;
+
+SELECT * FROM onephase_tab ORDER BY b;
+
+-- Fail before the segment commits. The segment reports the error, so
+-- the master knows that the transaction was rolled back.
+SELECT onephase_set_action('fail_begin_command');
+BEGIN;
+UPDATE onephase_tab SET b = b + 1 WHERE a = 1;
+INSERT INTO onephase_tab VALUES (1, 20);
+COMMIT;
+RESET debug_dtm_action;
+
+SELECT * FROM onephase_tab ORDER BY b;
+
+-- Fail after the segment has committed. The segment drops the connection
+-- instead of reporting an error, so the master can't tell whether the
+-- segment committed, and reports the outcome as in doubt rather than as
+-- rolled back. The transaction's effects are visible.
+SELECT onephase_set_action('fail_end_command');
+BEGIN;
+UPDATE onephase_tab SET b = b + 1 WHERE a = 1;
+INSERT INTO onephase_tab VALUES (1, 30);
+COMMIT;
+RESET debug_dtm_action;
+
+SELECT * FROM onephase_tab ORDER BY b;
+
+--
+-- Crash recovery. Commit one transaction in one phase, and then PANIC the
+-- segment while it processes the COMMIT_ONEPHASE of a second one. When
+-- the segment comes back up, the replay of the first commit must leave its
+-- rows visible, and the second transaction must have been rolled back.
+--
+CHECKPOINT;
+
+SELECT onephase_set_action('none');
+BEGIN;
+UPDATE onephase_tab SET b = b + 1 WHERE a = 1;
+INSERT INTO onephase_tab VALUES (1, 40);
+COMMIT;
+
+SET debug_dtm_action = "panic_begin_command";
+BEGIN;
+UPDATE onephase_tab SET b = b + 1 WHERE a = 1;
+INSERT INTO onephase_tab VALUES (1, 50);
+COMMIT;
+RESET debug_dtm_action;
+RESET debug_dtm_action_target;
+RESET debug_dtm_action_protocol;
+RESET debug_dtm_action_segment;
+
+SELECT onephase_wait_for_segment();
+
+SELECT * FROM onephase_tab ORDER BY b;
+
+DROP TABLE onephase_tab;
+DROP FUNCTION onephase_set_action(text);
+DROP FUNCTION onephase_wait_for_segment();
@@ -0,0 +1,33 @@
+# Test that catalog changes made in a transaction don't leak to other sessions
+# through the optimizer MDCache shared by all sessions, neither while the
+# transaction is in progress nor after it has been rolled back, and that the
+# transaction doesn't pick up stale objects from the shared MDCache either.
+#
+# The shared MDCache is only used when optimizer_mdcache_shared_size is set,
+# otherwise this merely checks that ORCA sees the changes.
+
+setup
+{
+    CREATE TABLE mdcache_ddl (a int, b int) DISTRIBUTED BY (a);
+    INSERT INTO mdcache_ddl VALUES (1, 2);
+}
+
+teardown
+{
+    DROP TABLE mdcache_ddl;
+}
+
+session "s1"
+setup			{ SET optimizer = on; }
+step "s1begin"		{ BEGIN; }
+step "s1alter"		{ ALTER TABLE mdcache_ddl ADD COLUMN c int DEFAULT 3; }
+step "s1select"		{ SELECT * FROM mdcache_ddl; }
+step "s1rollback"	{ ROLLBACK; }
+step "s1commit"		{ COMMIT; }
+
+session "s2"
+setup			{ SET optimizer = on; }
+step "s2select"		{ SELECT * FROM mdcache_ddl; }
+
+permutation "s2select" "s1begin" "s1alter" "s1select" "s1rollback" "s2select" "s1select"
+permutation "s2select" "s1begin" "s1alter" "s1select" "s1commit" "s2select"
@@ -0,0 +1,36 @@
+# Test that a distributed snapshot judges the visibility of a transaction
+# that was committed in one phase on a single segment correctly.
+#
+# s2 takes its distributed snapshot while s1 is still in progress, but
+# doesn't touch the segment until after s1 has committed there. The
+# segment's own snapshot then sees s1 as committed, and only the
+# distributed log tells that s1 was in progress for s2's distributed
+# snapshot, so s2 must not see s1's changes. A snapshot taken after s1
+# committed must see them.
+
+setup
+{
+    create table onephase (a int, b int) distributed by (a);
+    insert into onephase values (1, 0);
+}
+
+teardown
+{
+    drop table if exists onephase;
+}
+
+session "s1"
+step "s1begin"	{ BEGIN; }
+step "s1update"	{ update onephase set b = b + 1 where a = 1; }
+step "s1insert"	{ insert into onephase values (1, 10); }
+step "s1commit"	{ COMMIT; }
+
+session "s2"
+step "s2begin"	{ BEGIN ISOLATION LEVEL SERIALIZABLE; }
+step "s2snapshot"	{ select 1; }
+step "s2select"	{ select * from onephase where a = 1 order by b; }
+step "s2commit"	{ COMMIT; }
+teardown	{ abort; }
+
+permutation "s1begin" "s1update" "s1insert" "s2begin" "s2snapshot" "s1commit" "s2select" "s2commit" "s2select"
+permutation "s1begin" "s1update" "s1insert" "s2begin" "s1commit" "s2snapshot" "s2select" "s2commit"
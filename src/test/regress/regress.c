@@ -11,6 +11,7 @@
 #include <unistd.h>
 
 #include "pgstat.h"
+#include "access/extprotocol.h"
 #include "access/transam.h"
 #include "access/xact.h"
 #include "catalog/pg_language.h"
@@ -86,6 +87,9 @@ extern Datum hasGangsExist(PG_FUNCTION_ARGS);
 /* get number of backends on segments except myself */
 extern Datum numBackendsOnSegment(PG_FUNCTION_ARGS);
 
+/* get number of idle reader N-gangs of the QD */
+extern Datum numIdleReaderGangs(PG_FUNCTION_ARGS);
+
 /*
  * test_atomic_ops was backported from 9.5. This prototype doesn't appear
  * in the upstream version, because the PG_FUNCTION_INFO_V1() macro includes
@@ -96,6 +100,9 @@ extern Datum test_atomic_ops(PG_FUNCTION_ARGS);
 extern Datum udf_setenv(PG_FUNCTION_ARGS);
 extern Datum udf_unsetenv(PG_FUNCTION_ARGS);
 
+/* external protocol that returns the columns and quals pushed down to it */
+extern Datum extprotocol_pushdown_import(PG_FUNCTION_ARGS);
+
 #ifdef PG_MODULE_MAGIC
 PG_MODULE_MAGIC;
 #endif
@@ -2487,6 +2494,27 @@ numBackendsOnSegment(PG_FUNCTION_ARGS)
 	PG_RETURN_INT32(result);
 }
 
+PG_FUNCTION_INFO_V1(numIdleReaderGangs);
+Datum
+numIdleReaderGangs(PG_FUNCTION_ARGS)
+{
+	List	   *gangs = getAllIdleReaderGangs();
+	ListCell   *lc;
+	int32		result = 0;
+
+	foreach(lc, gangs)
+	{
+		Gang	   *gp = (Gang *) lfirst(lc);
+
+		if (gp->type == GANGTYPE_PRIMARY_READER)
+			result++;
+	}
+
+	list_free(gangs);
+
+	PG_RETURN_INT32(result);
+}
+
 #ifndef PG_HAVE_ATOMIC_FLAG_SIMULATION
 static void
 test_atomic_flag(void)
@@ -2745,3 +2773,69 @@ udf_unsetenv(PG_FUNCTION_ARGS)
 	int ret = unsetenv(name);
 	PG_RETURN_BOOL(ret == 0);
 }
+
+
+/*
+ * A read function for an external protocol that returns a single row,
+ * describing the columns and quals that the scan pushed down to it:
+ *
+ *	needed columns|quals
+ *
+ * followed by "|1|2" for the remaining two int columns of the table.
+ */
+PG_FUNCTION_INFO_V1(extprotocol_pushdown_import);
+Datum
+extprotocol_pushdown_import(PG_FUNCTION_ARGS)
+{
+	Relation	rel;
+	bool	   *needed;
+	StringInfoData line;
+	ListCell   *lc;
+	int			i;
+
+	if (!CALLED_AS_EXTPROTOCOL(fcinfo))
+		elog(ERROR, "extprotocol_pushdown_import: not called by external protocol manager");
+
+	/* the row has been returned already */
+	if (EXTPROTOCOL_IS_LAST_CALL(fcinfo) || EXTPROTOCOL_GET_USER_CTX(fcinfo) != NULL)
+		PG_RETURN_INT32(0);
+
+	rel = EXTPROTOCOL_GET_RELATION(fcinfo);
+	needed = EXTPROTOCOL_GET_NEEDED_COLS(fcinfo);
+
+	initStringInfo(&line);
+	if (needed == NULL)
+		appendStringInfoString(&line, "all");
+	for (i = 0; needed && i < RelationGetNumberOfAttributes(rel); i++)
+	{
+		if (needed[i])
+			appendStringInfo(&line, "%s%s", line.len > 0 ? "," : "",
+							 NameStr(rel->rd_att->attrs[i]->attname));
+	}
+	appendStringInfoChar(&line, '|');
+
+	foreach(lc, EXTPROTOCOL_GET_QUALS(fcinfo))
+	{
+		OpExpr	   *op = (OpExpr *) lfirst(lc);
+		Var		   *var = (Var *) linitial(op->args);
+		Const	   *con = (Const *) lsecond(op->args);
+		Oid			typoutput;
+		bool		typisvarlena;
+
+		getTypeOutputInfo(con->consttype, &typoutput, &typisvarlena);
+		appendStringInfo(&line, "%s%s %s %s",
+						 lc == list_head(EXTPROTOCOL_GET_QUALS(fcinfo)) ? "" : " and ",
+						 NameStr(rel->rd_att->attrs[var->varattno - 1]->attname),
+						 get_opname(op->opno),
+						 OidOutputFunctionCall(typoutput, con->constvalue));
+	}
+	appendStringInfoString(&line, "|1|2\n");
+
+	if (line.len > EXTPROTOCOL_GET_DATALEN(fcinfo))
+		elog(ERROR, "extprotocol_pushdown_import: row too long");
+	memcpy(EXTPROTOCOL_GET_DATABUF(fcinfo), line.data, line.len);
+
+	EXTPROTOCOL_SET_USER_CTX(fcinfo, line.data);
+
+	PG_RETURN_INT32(line.len);
+}
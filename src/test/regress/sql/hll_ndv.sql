@@ -0,0 +1,62 @@
+--
+-- Tests for the number of distinct values estimated with HyperLogLog
+-- sketches (gp_hll_sketch() and ANALYZE with gp_statistics_use_hll).
+--
+-- The sketches have a standard error of about 0.8%, so allow 5% either way.
+--
+
+-- Sketches on their own
+select abs(gp_hll_estimate(gp_hll_sketch(i)) - 100000) < 5000 as ok
+from generate_series(1, 100000) i;
+select abs(gp_hll_estimate(gp_hll_sketch(i % 1000)) - 1000) < 50 as ok
+from generate_series(1, 100000) i;
+select abs(gp_hll_estimate(gp_hll_sketch('value ' || i)) - 50000) < 2500 as ok
+from generate_series(1, 50000) i;
+select round(gp_hll_estimate(gp_hll_sketch(i))) as estimate
+from generate_series(1, 10) i;
+
+-- Merging two sketches gives the union, not the sum
+select abs(gp_hll_estimate(gp_hll_merge(a.s, b.s)) - 30000) < 1500 as ok
+from (select gp_hll_sketch(i) as s from generate_series(1, 20000) i) a,
+     (select gp_hll_sketch(i) as s from generate_series(10001, 30000) i) b;
+
+-- ANALYZE
+create table hll_ndv (a int, b int, c text, d int) distributed by (a);
+insert into hll_ndv
+  select i, i % 2000, 'text ' || (i % 30000), 1
+  from generate_series(1, 200000) i;
+
+set gp_statistics_use_hll = on;
+analyze hll_ndv;
+
+-- a is unique, stored as a fraction of the row count
+select abs(n_distinct + 1) < 0.05 as ok from pg_stats
+where tablename = 'hll_ndv' and attname = 'a';
+select abs(n_distinct - 2000) < 100 as ok from pg_stats
+where tablename = 'hll_ndv' and attname = 'b';
+select abs(-n_distinct * 200000 - 30000) < 1500 as ok from pg_stats
+where tablename = 'hll_ndv' and attname = 'c';
+select n_distinct from pg_stats
+where tablename = 'hll_ndv' and attname = 'd';
+
+-- Partitioned table. Every leaf has all the values of b, so the root must
+-- count the union of the leaf sketches rather than their sum.
+create table hll_ndv_part (a int, p int, b int)
+distributed by (a)
+partition by range (p) (start (0) end (4) every (1));
+insert into hll_ndv_part
+  select i, i % 4, i % 2001
+  from generate_series(1, 100000) i;
+analyze hll_ndv_part;
+
+select tablename, abs(n_distinct - 2001) < 100 as ok from pg_stats
+where tablename like 'hll_ndv_part%' and attname = 'b'
+order by tablename;
+select tablename, n_distinct from pg_stats
+where tablename like 'hll_ndv_part%' and attname = 'p'
+order by tablename;
+
+reset gp_statistics_use_hll;
+
+drop table hll_ndv;
+drop table hll_ndv_part;
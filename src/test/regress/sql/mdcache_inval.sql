@@ -0,0 +1,76 @@
+--
+-- Test that ORCA's metadata cache notices catalog changes. Only the entries
+-- affected by a change are evicted; the whole cache is reset when we cannot
+-- tell what changed.
+--
+set optimizer = on;
+
+create table mdc_t1 (a int, b int) distributed by (a);
+create table mdc_t2 (a int, b int) distributed by (a);
+insert into mdc_t1 select i, i % 3 from generate_series(1, 10) i;
+insert into mdc_t2 select i, i % 5 from generate_series(1, 10) i;
+
+select * from mdc_t1 where a < 4 order by a;
+
+-- DDL on another table leaves mdc_t1 alone, but is seen for mdc_t2
+alter table mdc_t2 add column c int default 7;
+select * from mdc_t1 where a < 4 order by a;
+select * from mdc_t2 where a < 4 order by a;
+
+-- Changes to the columns of a relation
+alter table mdc_t1 drop column b;
+alter table mdc_t1 add column c text default 'x';
+select * from mdc_t1 where a < 4 order by a;
+alter table mdc_t1 rename column c to d;
+select a, d from mdc_t1 where a < 4 order by a;
+
+-- Dropped indexes must not be used anymore
+create index mdc_t1_a on mdc_t1 (a);
+select a, d from mdc_t1 where a = 2;
+drop index mdc_t1_a;
+select a, d from mdc_t1 where a = 2;
+
+-- A dropped check constraint must not be used to prune the scan
+alter table mdc_t1 add constraint mdc_t1_check check (a > 0);
+select count(*) from mdc_t1 where a < 0;
+alter table mdc_t1 drop constraint mdc_t1_check;
+insert into mdc_t1 values (-1, 'y');
+select count(*) from mdc_t1 where a < 0;
+
+-- Statistics
+analyze mdc_t1;
+select count(*) from mdc_t1;
+insert into mdc_t1 select i, 'z' from generate_series(11, 100) i;
+analyze mdc_t1;
+select count(*) from mdc_t1;
+
+-- Changes rolled back are undone in the cache as well
+begin;
+alter table mdc_t1 add column e int default 1;
+select a, d, e from mdc_t1 where a = 2;
+rollback;
+select * from mdc_t1 where a = 2;
+
+-- Operator changes reset the whole cache
+create function mdc_eq(int, int) returns bool as 'select $1 = $2' language sql immutable;
+create operator === (leftarg = int, rightarg = int, procedure = mdc_eq);
+select a from mdc_t1 where a === 2;
+
+-- So do too many changes between two queries
+alter table mdc_t1 add constraint mdc_t1_check2 check (a < 1000);
+select count(*) from mdc_t1 where a >= 1000;
+alter table mdc_t1 drop constraint mdc_t1_check2;
+set client_min_messages = warning;
+create table mdc_part (a int, b int) distributed by (a)
+partition by range (b) (start (1) end (301) every (1));
+reset client_min_messages;
+insert into mdc_t1 values (2000, 'w');
+select count(*) from mdc_t1 where a >= 1000;
+
+drop table mdc_part;
+drop operator === (int, int);
+drop function mdc_eq(int, int);
+drop table mdc_t1;
+drop table mdc_t2;
+
+reset optimizer;
@@ -0,0 +1,101 @@
+--
+-- Test the runtime memory broker (gp_resqueue_memory_broker), which lets a
+-- hash join lend the unused part of its quota to other operators of the
+-- query. The results must be the same with and without it, also when the
+-- hash table is rebuilt for every rescan.
+--
+create table mb_outer (a int, b int) distributed by (a);
+insert into mb_outer select i, i from generate_series(1, 10) i;
+create table mb_inner (a int, b int) distributed by (a);
+insert into mb_inner select i, i % 100 from generate_series(1, 1000) i;
+analyze mb_outer;
+analyze mb_inner;
+
+set enable_nestloop = off;
+set enable_mergejoin = off;
+set statement_mem = '2MB';
+
+-- The hash tables depend on the outer row, so they are rebuilt on each
+-- rescan of the subplan.
+set gp_resqueue_memory_broker = off;
+select o.a,
+       (select count(*) from mb_inner i1 join mb_inner i2 on i1.b = i2.b
+        where i1.a <= o.a * 100 and i2.a <= o.a * 100) as cnt
+from mb_outer o order by o.a;
+
+set gp_resqueue_memory_broker = on;
+select o.a,
+       (select count(*) from mb_inner i1 join mb_inner i2 on i1.b = i2.b
+        where i1.a <= o.a * 100 and i2.a <= o.a * 100) as cnt
+from mb_outer o order by o.a;
+
+-- A hash join that fits in memory next to a hash aggregate that may borrow
+-- its quota.
+select count(*), sum(c) from
+  (select i1.b, count(*) as c from mb_inner i1 join mb_inner i2 on i1.a = i2.a
+   group by i1.b) s;
+
+-- A hash aggregate with far more groups than fit in its quota, next to a
+-- small hash join in a subquery that gives most of its quota back. With the
+-- broker, the aggregate borrows that quota, and fills more memory before it
+-- spills. The subquery is rebuilt every 1000 rows, while the aggregate holds
+-- the borrowed quota, so the hash join has to make do with what it didn't
+-- lend. It all runs on the master, so the memory use doesn't depend on the
+-- number of segments.
+create view mb_agg as
+  select g, count(*) as c, sum(x) as x from
+    (select i % 100000 as g,
+            case when i % 1000 = 0 then
+              (select count(*) from generate_series(1, 10) s1
+               join generate_series(1, 10) s2 on s1 = s2
+               where s1 <= i % 7 and s2 <= i % 7)
+            end as x
+     from generate_series(1, 200000) i) t
+  group by g;
+
+create function mb_agg_workmem(query text) returns int as $$
+declare
+	line text;
+	in_agg bool := false;
+begin
+	for line in execute 'explain analyze ' || query loop
+		if line like '%HashAggregate%' then
+			in_agg := true;
+		elsif in_agg and line like '%Work_mem used:%' then
+			return substring(line from 'Work_mem used: *([0-9]+)K')::int;
+		end if;
+	end loop;
+	return null;
+end;
+$$ language plpgsql;
+
+-- Does the aggregate use more memory with the broker than without?
+create function mb_agg_borrows(query text) returns bool as $$
+declare
+	without_broker int;
+	with_broker int;
+begin
+	execute 'set gp_resqueue_memory_broker = off';
+	without_broker := mb_agg_workmem(query);
+	execute 'set gp_resqueue_memory_broker = on';
+	with_broker := mb_agg_workmem(query);
+	return with_broker > without_broker;
+end;
+$$ language plpgsql;
+
+set enable_groupagg = off;
+set gp_resqueue_memory_broker = on;
+select count(*), sum(c), sum(x) from mb_agg;
+select mb_agg_borrows('select count(*), sum(c), sum(x) from mb_agg') as borrowed;
+
+reset gp_resqueue_memory_broker;
+reset enable_groupagg;
+reset statement_mem;
+reset enable_mergejoin;
+reset enable_nestloop;
+
+drop table mb_outer;
+drop table mb_inner;
+drop view mb_agg;
+drop function mb_agg_borrows(text);
+drop function mb_agg_workmem(text);
@@ -0,0 +1,38 @@
+--
+-- Test optimizer_time_budget. Queries the optimizer cannot produce a plan for
+-- within the budget are planned by the legacy planner.
+--
+create function otb_planned_by_orca(query text) returns bool as $$
+declare
+	line text;
+begin
+	for line in execute 'explain ' || query loop
+		if line like '%Optimizer status: PQO%' then
+			return true;
+		end if;
+	end loop;
+	return false;
+end;
+$$ language plpgsql;
+
+set optimizer = on;
+
+create table otb_t (a int, b int) distributed by (a);
+insert into otb_t select i, i from generate_series(1, 100) i;
+analyze otb_t;
+
+-- Far too little time to search the join orders of an 8-way join
+set optimizer_time_budget = 1;
+select otb_planned_by_orca('select count(*) from otb_t t1, otb_t t2, otb_t t3, otb_t t4, otb_t t5, otb_t t6, otb_t t7, otb_t t8 where t1.a = t2.b and t2.a = t3.b and t3.a = t4.b and t4.a = t5.b and t5.a = t6.b and t6.a = t7.b and t7.a = t8.b');
+select count(*) from otb_t t1, otb_t t2, otb_t t3, otb_t t4, otb_t t5, otb_t t6, otb_t t7, otb_t t8
+where t1.a = t2.b and t2.a = t3.b and t3.a = t4.b and t4.a = t5.b and t5.a = t6.b and t6.a = t7.b and t7.a = t8.b;
+
+-- Enough time
+set optimizer_time_budget = '10min';
+select count(*) from otb_t t1, otb_t t2, otb_t t3, otb_t t4, otb_t t5, otb_t t6, otb_t t7, otb_t t8
+where t1.a = t2.b and t2.a = t3.b and t3.a = t4.b and t4.a = t5.b and t5.a = t6.b and t6.a = t7.b and t7.a = t8.b;
+
+reset optimizer_time_budget;
+drop table otb_t;
+drop function otb_planned_by_orca(text);
+reset optimizer;
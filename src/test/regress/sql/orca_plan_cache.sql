@@ -0,0 +1,45 @@
+--
+-- Test the per-session cache of plans produced by ORCA. Plans are only
+-- reused for queries that are the same after constant folding, so constants
+-- and the values of bound parameters are part of the key.
+--
+set optimizer = on;
+set optimizer_plan_cache_size = 1024;
+
+create table opc_t (a int, b int) distributed by (a);
+insert into opc_t select i, i * 10 from generate_series(1, 10) i;
+
+select b from opc_t where a = 3;
+select b from opc_t where a = 3;
+select b from opc_t where a = 4;
+
+prepare opc_p (int) as select b from opc_t where a = $1;
+execute opc_p(5);
+execute opc_p(6);
+execute opc_p(5);
+deallocate opc_p;
+
+-- DDL on the relation drops its plans
+alter table opc_t add column c int default 0;
+select * from opc_t where a = 3;
+alter table opc_t drop column c;
+select * from opc_t where a = 3;
+
+-- So does ANALYZE
+insert into opc_t select i, i * 10 from generate_series(11, 20) i;
+analyze opc_t;
+select count(*) from opc_t where a > 5;
+
+-- A dropped and recreated relation is not confused with the old one
+drop table opc_t;
+create table opc_t (a int, b text) distributed by (a);
+insert into opc_t values (3, 'three');
+select * from opc_t where a = 3;
+
+-- Disabling the cache empties it
+set optimizer_plan_cache_size = 0;
+select * from opc_t where a = 3;
+
+drop table opc_t;
+reset optimizer_plan_cache_size;
+reset optimizer;